@@ -0,0 +1,257 @@
+#include "aggregationkernels.h"
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#if !defined(NOOMYPLAN_SCALAR_KERNELS) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NOOMYPLAN_SSE2_KERNELS 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * @class aggregationkernels.cpp
+ * @brief Implements the AggregationKernels summation loops with SSE2 and scalar code paths.
+ */
+
+namespace {
+
+constexpr size_t kBinSets = 4;              // Interleaved bin sets used by grouped sums
+constexpr size_t kMaxInterleavedBins = 4096; // Above this the bin sets no longer fit in L1
+
+/**
+ * @brief Adds two values as unsigned, recording a signed overflow in the sign bit of overflow.
+ *
+ * Signed addition overflows exactly when both operands have the same sign and the
+ * result has the other one. The test has no branches, so the loops stay branch-free.
+ */
+inline uint64_t addTracked(uint64_t sum, uint64_t value, uint64_t& overflow) {
+    const uint64_t result = sum + value;
+    overflow |= ~(sum ^ value) & (sum ^ result);
+    return result;
+}
+
+/**
+ * @brief Returns true if addTracked() recorded an overflow.
+ */
+inline bool overflowed(uint64_t overflow) {
+    return (overflow >> 63) != 0;
+}
+
+/**
+ * @brief Adds value to sum; returns false, leaving sum unchanged, if the result does not fit.
+ */
+inline bool addChecked(int64_t& sum, int64_t value) {
+    if (value > 0 ? sum > INT64_MAX - value : sum < INT64_MIN - value) {
+        return false;
+    }
+    sum += value;
+    return true;
+}
+
+/**
+ * @brief Adds values to bins, spreading consecutive values over kBinSets copies of the bins.
+ * @param binOf Returns the bin of value i.
+ *
+ * Consecutive rows often share a group, and adding them to the same bin makes every
+ * add wait for the previous one. Rotating through separate bin sets lets four adds
+ * be in flight; the sets are folded together at the end.
+ */
+template <typename BinOf>
+bool interleavedSum(const int64_t* values, size_t count, size_t binCount, int64_t* sums, BinOf binOf) {
+    if (binCount == 0 || count == 0) {
+        return true;
+    }
+
+    // Bins add as unsigned so a wrap is well defined; addTracked() notes it and the sum is refused
+    uint64_t overflow = 0;
+    std::vector<uint64_t> bins((binCount > kMaxInterleavedBins ? 1 : kBinSets) * binCount, 0);
+    uint64_t* const set0 = bins.data();
+    if (binCount > kMaxInterleavedBins) {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t& bin = set0[binOf(i)];
+            bin = addTracked(bin, static_cast<uint64_t>(values[i]), overflow);
+        }
+        for (size_t bin = 0; bin < binCount; ++bin) {
+            if (!addChecked(sums[bin], static_cast<int64_t>(set0[bin]))) {
+                return false;
+            }
+        }
+        return !overflowed(overflow);
+    }
+
+    uint64_t* const set1 = set0 + binCount;
+    uint64_t* const set2 = set1 + binCount;
+    uint64_t* const set3 = set2 + binCount;
+
+    size_t i = 0;
+    for (; i + kBinSets <= count; i += kBinSets) {
+        uint64_t& bin0 = set0[binOf(i)];
+        uint64_t& bin1 = set1[binOf(i + 1)];
+        uint64_t& bin2 = set2[binOf(i + 2)];
+        uint64_t& bin3 = set3[binOf(i + 3)];
+        bin0 = addTracked(bin0, static_cast<uint64_t>(values[i]), overflow);
+        bin1 = addTracked(bin1, static_cast<uint64_t>(values[i + 1]), overflow);
+        bin2 = addTracked(bin2, static_cast<uint64_t>(values[i + 2]), overflow);
+        bin3 = addTracked(bin3, static_cast<uint64_t>(values[i + 3]), overflow);
+    }
+    for (; i < count; ++i) {
+        uint64_t& bin = set0[binOf(i)];
+        bin = addTracked(bin, static_cast<uint64_t>(values[i]), overflow);
+    }
+    if (overflowed(overflow)) {
+        return false;
+    }
+
+    for (size_t bin = 0; bin < binCount; ++bin) {
+        for (const uint64_t* set : { set0, set1, set2, set3 }) {
+            if (!addChecked(sums[bin], static_cast<int64_t>(set[bin]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#ifdef NOOMYPLAN_SSE2_KERNELS
+
+/**
+ * @brief Loads two amounts, zeroing those whose 64-bit mask lane is clear.
+ */
+inline __m128i maskedPair(const int64_t* values, __m128i mask) {
+    return _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values)), mask);
+}
+
+/**
+ * @brief Adds two pairs of amounts lane by lane, recording signed overflows as addTracked() does.
+ */
+inline __m128i addTrackedPairs(__m128i sum, __m128i value, __m128i& overflow) {
+    const __m128i result = _mm_add_epi64(sum, value);
+    overflow = _mm_or_si128(overflow, _mm_andnot_si128(_mm_xor_si128(sum, value), _mm_xor_si128(sum, result)));
+    return result;
+}
+
+/**
+ * @brief SSE2 masked sum: compares 16 keys at once and widens the byte masks to 64-bit lanes.
+ */
+bool maskedSumSse2(const int64_t* values, const uint8_t* keys, size_t count, uint8_t key, int64_t& sum) {
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(key));
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    __m128i sum2 = _mm_setzero_si128();
+    __m128i sum3 = _mm_setzero_si128();
+    __m128i overflow = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i match8 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), wanted);
+        if (_mm_movemask_epi8(match8) == 0) {
+            continue; // No key matched in this block
+        }
+
+        // Each unpack with itself doubles the width of every mask lane: 8 -> 16 -> 32 -> 64 bits
+        const __m128i match16Low = _mm_unpacklo_epi8(match8, match8);
+        const __m128i match16High = _mm_unpackhi_epi8(match8, match8);
+        const __m128i match32[4] = {
+            _mm_unpacklo_epi16(match16Low, match16Low), _mm_unpackhi_epi16(match16Low, match16Low),
+            _mm_unpacklo_epi16(match16High, match16High), _mm_unpackhi_epi16(match16High, match16High)
+        };
+        for (int quarter = 0; quarter < 4; ++quarter) {
+            const int64_t* block = values + i + quarter * 4;
+            sum0 = addTrackedPairs(sum0, maskedPair(block, _mm_unpacklo_epi32(match32[quarter], match32[quarter])), overflow);
+            sum1 = addTrackedPairs(sum1, maskedPair(block + 2, _mm_unpackhi_epi32(match32[quarter], match32[quarter])), overflow);
+        }
+        std::swap(sum0, sum2); // Alternate accumulators between blocks to shorten dependency chains
+        std::swap(sum1, sum3);
+    }
+
+    if (_mm_movemask_pd(_mm_castsi128_pd(overflow)) != 0) {
+        return false; // The sign bit of a lane is set where an add overflowed
+    }
+
+    // Fold the eight lanes and the scalar tail with checked adds
+    int64_t lanes[8];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 2), sum1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 4), sum2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 6), sum3);
+    int64_t total = 0;
+    if (!AggregationKernels::scalar::maskedSum(values + i, keys + i, count - i, key, total)) {
+        return false;
+    }
+    for (int64_t lane : lanes) {
+        if (!addChecked(total, lane)) {
+            return false;
+        }
+    }
+    sum = total;
+    return true;
+}
+
+#endif // NOOMYPLAN_SSE2_KERNELS
+
+} // namespace
+
+namespace AggregationKernels {
+
+const char* implementationName() {
+#ifdef NOOMYPLAN_SSE2_KERNELS
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * @brief Sums the values whose key equals the given key.
+ */
+bool maskedSum(const int64_t* values, const uint8_t* keys, size_t count, uint8_t key, int64_t& sum) {
+#ifdef NOOMYPLAN_SSE2_KERNELS
+    return maskedSumSse2(values, keys, count, key, sum);
+#else
+    return scalar::maskedSum(values, keys, count, key, sum);
+#endif
+}
+
+bool groupedSum(const int64_t* values, const uint32_t* groups, size_t count, size_t groupCount, int64_t* sums) {
+    return interleavedSum(values, count, groupCount, sums, [groups](size_t i) {
+        return groups[i];
+        });
+}
+
+bool groupedSumByKey(const int64_t* values, const uint32_t* groups, const uint8_t* keys, size_t count,
+    size_t groupCount, size_t keyCount, int64_t* sums) {
+    return interleavedSum(values, count, groupCount * keyCount, sums, [groups, keys, keyCount](size_t i) {
+        return groups[i] * keyCount + keys[i];
+        });
+}
+
+namespace scalar {
+
+/**
+ * @brief Scalar masked sum; branch-free so mixed keys do not cost mispredictions.
+ */
+bool maskedSum(const int64_t* values, const uint8_t* keys, size_t count, uint8_t key, int64_t& sum) {
+    uint64_t sum0 = 0;
+    uint64_t sum1 = 0;
+    uint64_t overflow = 0;
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        sum0 = addTracked(sum0, keys[i] == key ? static_cast<uint64_t>(values[i]) : 0, overflow);
+        sum1 = addTracked(sum1, keys[i + 1] == key ? static_cast<uint64_t>(values[i + 1]) : 0, overflow);
+    }
+    if (i < count && keys[i] == key) {
+        sum0 = addTracked(sum0, static_cast<uint64_t>(values[i]), overflow);
+    }
+
+    int64_t total = static_cast<int64_t>(sum0);
+    if (overflowed(overflow) || !addChecked(total, static_cast<int64_t>(sum1))) {
+        return false;
+    }
+    sum = total;
+    return true;
+}
+
+} // namespace scalar
+
+} // namespace AggregationKernels
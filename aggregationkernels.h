@@ -0,0 +1,82 @@
+#ifndef AGGREGATIONKERNELS_H
+#define AGGREGATIONKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace AggregationKernels
+ * @brief Summation loops over column-wise transaction data.
+ *
+ * Reports reduce an amount column by a small key column (transaction kind) and by
+ * dense group codes (type, category, month). These kernels do that on raw arrays of
+ * amounts in cents (Money::cents()). Masked sums use SSE2 integer adds where the
+ * target has it (every x86-64 build) and a scalar loop elsewhere; defining
+ * NOOMYPLAN_SCALAR_KERNELS forces the scalar loops. Grouped sums scatter into bins,
+ * which SSE2 cannot vectorize, so they use several interleaved bin sets instead to
+ * keep runs of equal codes from serializing the adds.
+ *
+ * Integer sums are exact, so the SIMD and scalar paths give identical results. Like
+ * Money's arithmetic, sums are checked: every add records whether it overflowed,
+ * with the same sign-bit test in both paths, and the partial sums are combined with
+ * checked adds. A kernel that overflows returns false instead of a wrapped total.
+ */
+namespace AggregationKernels {
+
+/**
+ * @brief Returns the name of the masked-sum implementation in use, e.g. "sse2" or "scalar".
+ */
+const char* implementationName();
+
+/**
+ * @brief Sums the values whose key equals the given key.
+ * @param values Values to sum.
+ * @param keys One key per value.
+ * @param count Number of values.
+ * @param key Key of the values to include.
+ * @param sum Receives the sum, 0 if no key matched; unspecified on overflow.
+ * @return False if the sum, or a partial sum, does not fit in int64_t.
+ */
+bool maskedSum(const int64_t* values, const uint8_t* keys, size_t count, uint8_t key, int64_t& sum);
+
+/**
+ * @brief Adds each value to the bin of its group.
+ * @param values Values to sum.
+ * @param groups One group code per value; each must be below groupCount.
+ * @param count Number of values.
+ * @param groupCount Number of bins.
+ * @param sums Bins, indexed by group code; added to, not cleared. Unspecified on overflow.
+ * @return False if a bin, or a partial sum of one, does not fit in int64_t.
+ */
+bool groupedSum(const int64_t* values, const uint32_t* groups, size_t count, size_t groupCount, int64_t* sums);
+
+/**
+ * @brief Adds each value to the bin of its group and key.
+ * @param values Values to sum.
+ * @param groups One group code per value; each must be below groupCount.
+ * @param keys One key per value; each must be below keyCount.
+ * @param count Number of values.
+ * @param groupCount Number of distinct groups.
+ * @param keyCount Number of distinct keys.
+ * @param sums groupCount * keyCount bins, indexed by group * keyCount + key; added to, not cleared.
+ *             Unspecified on overflow.
+ * @return False if a bin, or a partial sum of one, does not fit in int64_t.
+ *
+ * One pass gives, e.g., income and expenses per category at once.
+ */
+bool groupedSumByKey(const int64_t* values, const uint32_t* groups, const uint8_t* keys, size_t count,
+    size_t groupCount, size_t keyCount, int64_t* sums);
+
+/**
+ * @namespace AggregationKernels::scalar
+ * @brief Plain loops that define the expected results; used as the fallback.
+ */
+namespace scalar {
+
+bool maskedSum(const int64_t* values, const uint8_t* keys, size_t count, uint8_t key, int64_t& sum);
+
+} // namespace scalar
+
+} // namespace AggregationKernels
+
+#endif // AGGREGATIONKERNELS_H
@@ -10,7 +10,7 @@
 * @author Simran Kullar
 */
 #include "authenticatesystem.h"
-#include <iostream>
+#include "logging.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -48,19 +48,19 @@ AuthenticateSystem::AuthenticateSystem() {}
  */
 bool AuthenticateSystem::authenticateUser(const QString& userID) {
     // Display current login attempt information including the number of previous failures
-    std::cout << "Checking login for " << userID.toStdString()
-        << ". Failed attempts: " << failedAttempts[userID] << "/5" << std::endl;
+    NOOMYPLAN_LOG_DEBUG(lcAuth) << "Checking login for" << userID << ". Failed attempts:"
+        << (failedAttempts.count(userID) ? failedAttempts.at(userID) : 0) << "/5";
 
     // Check if the account is locked due to previous failed attempts
     if (isAccountLocked(userID)) {
         // If account is locked, notify user and prevent further login attempts
-        std::cout << "⚠ Account " << userID.toStdString() << " is LOCKED! Try again later." << std::endl;
+        NOOMYPLAN_LOG_INFO(lcAuth) << "Account" << userID << "is locked, login refused";
         return false; // Authentication fails for locked accounts
     }
 
     // Verify if the user exists in the system
     if (!userExists(userID)) {
-        std::cout << "Invalid ID: No user found with ID " << userID.toStdString() << std::endl;   // Log the failed attempt with detailed error message
+        NOOMYPLAN_LOG_INFO(lcAuth) << "Invalid ID: No user found with ID" << userID;   // Log the failed attempt with detailed error message
         failedAttempts[userID]++;   // Increment failed attempt counter even for non-existent accounts
 
         // Lock the account if too many failed attempts occur
@@ -74,7 +74,7 @@ bool AuthenticateSystem::authenticateUser(const QString& userID) {
     // Attempt user login
     if (users[userID]->login()) {
         // Authentication successful - log the event
-        std::cout << "Successful login for " << userID.toStdString() << std::endl;
+        NOOMYPLAN_LOG_INFO(lcAuth) << "Successful login for" << userID;
         // Reset the failed attempt counter upon successful authentication
         failedAttempts[userID] = 0;
         return true; // Authentication succeeded
@@ -83,8 +83,7 @@ bool AuthenticateSystem::authenticateUser(const QString& userID) {
     failedAttempts[userID]++;
 
     // Log the failed attempt with the updated counter
-    std::cout << "Failed login attempt " << failedAttempts[userID] << "/5 for "
-        << userID.toStdString() << std::endl;
+    NOOMYPLAN_LOG_INFO(lcAuth) << "Failed login attempt" << failedAttempts[userID] << "/5 for" << userID;
 
     // Lock the account if too many failed attempts occur
     if (failedAttempts[userID] >= 5) {
@@ -109,7 +108,7 @@ void AuthenticateSystem::lockAccount(const QString& userID) {
     lockedAccounts[userID] = true;
 
     // Notify through console that the account has been locked
-    std::cout << "Account " << userID.toStdString() << " is now LOCKED for 1 minute :(" << std::endl;
+    NOOMYPLAN_LOG_WARNING(lcAuth) << "Account" << userID << "is now locked for 1 minute";
 
     QTimer::singleShot(60000, [this, userID]() {
         // After timeout, set the account status back to unlocked
@@ -117,7 +116,7 @@ void AuthenticateSystem::lockAccount(const QString& userID) {
         // Reset the failed attempts counter to give the user a fresh start
         failedAttempts[userID] = 0;
         // Notify through console that the automatic unlock has occurred
-        std::cout << "✔️ Account " << userID.toStdString() << " is now UNLOCKED!" << std::endl;
+        NOOMYPLAN_LOG_INFO(lcAuth) << "Account" << userID << "is now unlocked";
         });
 }
 
@@ -164,13 +163,13 @@ void AuthenticateSystem::addUser(const QString& userID, const QString& role) {
     // Check if a user with this ID already exists in the system
     if (users.find(userID) != users.end()) {
         // User already exists - notify and abort the registration process
-        std::cout << "User " << userID.toStdString() << " is already signed up. Please log in :)" << std::endl;
+        NOOMYPLAN_LOG_INFO(lcAuth) << "User" << userID << "is already signed up";
         return; // return to prevent creating duplicate users
     }
     // Create a new User object with the provided ID and role
     users[userID] = new User(userID, role);
     // Notify through console that the user creation was successful
-    std::cout << "New account created for " << userID.toStdString() << ". You can now log in!" << std::endl;
+    NOOMYPLAN_LOG_INFO(lcAuth) << "New account created for" << userID;
 
     // Save updated user list to file
     saveUsersToFile();
@@ -209,7 +208,7 @@ bool AuthenticateSystem::saveUsersToFile() {
     if (!dir.exists(dataPath)) {
         bool created = dir.mkpath(dataPath);
         if (!created) {
-            std::cerr << "Failed to create data directory at: " << dataPath.toStdString() << std::endl;
+            NOOMYPLAN_LOG_WARNING(lcAuth) << "Failed to create data directory at:" << dataPath;
             return false;
         }
     }
@@ -218,7 +217,7 @@ bool AuthenticateSystem::saveUsersToFile() {
     QFile file(filePath);
 
     if (!file.open(QIODevice::WriteOnly)) {
-        std::cerr << "Failed to open file for writing: " << filePath.toStdString() << std::endl;
+        NOOMYPLAN_LOG_WARNING(lcAuth) << "Failed to open file for writing:" << filePath;
         return false;
     }
 
@@ -241,7 +240,7 @@ bool AuthenticateSystem::saveUsersToFile() {
     file.write(doc.toJson());
     file.close();
 
-    std::cout << "Successfully saved " << users.size() << " users to: " << filePath.toStdString() << std::endl;
+    NOOMYPLAN_LOG_DEBUG(lcAuth) << "Successfully saved" << users.size() << "users to:" << filePath;
     return true;
 }
 
@@ -262,12 +261,12 @@ bool AuthenticateSystem::loadUsersFromFile() {
     QFile file(filePath);
 
     if (!file.exists()) {
-        std::cout << "Users file does not exist yet at: " << filePath.toStdString() << std::endl;
+        NOOMYPLAN_LOG_INFO(lcAuth) << "Users file does not exist yet at:" << filePath;
         return false;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        std::cerr << "Failed to open file for reading: " << filePath.toStdString() << std::endl;
+        NOOMYPLAN_LOG_WARNING(lcAuth) << "Failed to open file for reading:" << filePath;
         return false;
     }
 
@@ -278,7 +277,7 @@ bool AuthenticateSystem::loadUsersFromFile() {
     QJsonDocument doc = QJsonDocument::fromJson(fileData, &parseError);
 
     if (parseError.error != QJsonParseError::NoError) {
-        std::cerr << "JSON parse error: " << parseError.errorString().toStdString() << std::endl;
+        NOOMYPLAN_LOG_WARNING(lcAuth) << "JSON parse error:" << parseError.errorString();
         return false;
     }
 
@@ -300,6 +299,6 @@ bool AuthenticateSystem::loadUsersFromFile() {
         users[id] = new User(id, role);
     }
 
-    std::cout << "Successfully loaded " << users.size() << " users from: " << filePath.toStdString() << std::endl;
+    NOOMYPLAN_LOG_DEBUG(lcAuth) << "Successfully loaded" << users.size() << "users from:" << filePath;
     return true;
 }
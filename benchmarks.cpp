@@ -0,0 +1,504 @@
+#include <benchmark/benchmark.h>
+#include <QApplication>
+#include <QBuffer>
+#include <QByteArray>
+#include <QDate>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "budgetpage.h"
+#include "cashflowtracking.h"
+#include "financialreport.h"
+#include "invoice.h"
+#include "jsonstream.h"
+#include "money.h"
+
+/**
+ * @class benchmarks.cpp
+ * @brief Implements the NoomyPlanBenchmarks suite for the ledger, CSV report and JSON hot paths.
+ *
+ * Built when NOOMYPLAN_BUILD_BENCHMARKS is on. Every benchmark runs on synthetic data
+ * made by the generators below from a fixed seed, so runs are comparable; the row
+ * count is the benchmark argument. Results go to stdout as JSON unless another
+ * --benchmark_format is given; the run_benchmarks target also writes them to
+ * benchmark_results.json. Files are written to a temporary directory that is removed
+ * on exit.
+ */
+
+namespace {
+
+constexpr uint32_t kSeed = 20240601;
+
+const std::vector<std::string> kTypes = {
+    "Sale", "Misc. Income", "Refund", "Expense", "Bank Fee", "Inventory Purchase", "Loan Payment", "Tax Payment"
+};
+const std::vector<std::string> kCategories = {
+    "Revenue", "Other Income", "Refunds & Returns", "Operating Expense", "Banking Expense", "Inventory",
+    "Debt Repayment", "Tax"
+};
+const std::vector<std::string> kPaymentMethods = { "Bank Deposit", "Bank Transfer", "Cash", "Credit Card", "PayPal" };
+
+/**
+ * @brief Returns the directory all benchmark files go to.
+ */
+const QTemporaryDir& scratchDir() {
+    static const QTemporaryDir dir;
+    return dir;
+}
+
+std::string scratchPath(const std::string& name) {
+    return scratchDir().filePath(QString::fromStdString(name)).toStdString();
+}
+
+/**
+ * @brief Deletes a ledger snapshot together with its journal and the journal rotated out by a background save.
+ */
+void removeLedgerFiles(const std::string& path) {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    std::filesystem::remove(path + ".journal", error);
+    std::filesystem::remove(path + ".journal.old", error);
+}
+
+/**
+ * @brief Copies a ledger snapshot to a path that a benchmark may change.
+ */
+void copyLedger(const std::string& from, const std::string& to) {
+    removeLedgerFiles(to);
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+}
+
+/**
+ * @brief Strings for synthetic ledger rows, drawn from small pools so millions of rows need no allocations.
+ */
+class LedgerRowSource {
+public:
+    LedgerRowSource() {
+        for (int month = 1; month <= 12; ++month) {
+            for (int day = 1; day <= 28; ++day) {
+                char text[24];
+                std::snprintf(text, sizeof(text), "2024-%02d-%02d, %02d:%02d", month, day, (month * day) % 24,
+                    (month + day) % 60);
+                dateTimes.emplace_back(text);
+            }
+        }
+        for (int i = 0; i < 1000; ++i) {
+            parties.push_back("Party " + std::to_string(i));
+            merchandise.push_back("Item " + std::to_string(i));
+        }
+    }
+
+    /**
+     * @brief Adds row number i to a ledger.
+     */
+    int add(CashflowTracking& ledger, uint64_t i) {
+        const uint64_t mix = i * 2654435761u;
+        return ledger.addData(dateTimes[mix % dateTimes.size()], parties[mix % parties.size()],
+            parties[(mix >> 8) % parties.size()], merchandise[(mix >> 4) % merchandise.size()],
+            Money::fromCents(static_cast<int64_t>(mix % 500000)), "USD", kCategories[i % kCategories.size()]);
+    }
+
+private:
+    std::vector<std::string> dateTimes;
+    std::vector<std::string> parties;
+    std::vector<std::string> merchandise;
+};
+
+/**
+ * @brief A saved ledger with a known number of rows; IDs run from firstID upward.
+ */
+struct LedgerFixture {
+    std::string path;
+    int firstID = 0;
+};
+
+/**
+ * @brief Returns a ledger snapshot with the given number of rows, writing it on first use.
+ */
+const LedgerFixture& ledgerFixture(int64_t rows) {
+    static std::map<int64_t, LedgerFixture> fixtures;
+    auto found = fixtures.find(rows);
+    if (found != fixtures.end()) {
+        return found->second;
+    }
+
+    LedgerFixture fixture;
+    fixture.path = scratchPath("ledger_" + std::to_string(rows) + ".dat");
+    removeLedgerFiles(fixture.path);
+    {
+        CashflowTracking ledger(fixture.path);
+        LedgerRowSource source;
+        fixture.firstID = source.add(ledger, 0);
+        for (int64_t i = 1; i < rows; ++i) {
+            source.add(ledger, static_cast<uint64_t>(i));
+        }
+        ledger.saveDataToFile(); // Folds the journal into the snapshot and deletes it
+    }
+    return fixtures.emplace(rows, fixture).first->second;
+}
+
+/**
+ * @brief Returns a transactions CSV in the business_financials.csv layout, writing it on first use.
+ */
+const QString& reportCsvFixture(int64_t rows) {
+    static std::map<int64_t, QString> fixtures;
+    auto found = fixtures.find(rows);
+    if (found != fixtures.end()) {
+        return found->second;
+    }
+
+    const QString path = scratchDir().filePath(QString("transactions_%1.csv").arg(rows));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qFatal("Could not write %s", qPrintable(path));
+    }
+
+    std::mt19937 random(kSeed);
+    std::string line;
+    char amount[Money::kMaxFormattedSize];
+    file.write("Date,Transaction ID,Type,Description,Amount ($),Payment Method,Category\n");
+    for (int64_t i = 0; i < rows; ++i) {
+        const size_t kind = random() % kTypes.size();
+        char date[16];
+        std::snprintf(date, sizeof(date), "2024-%02u-%02u", unsigned(1 + random() % 12),
+            unsigned(1 + random() % 28));
+        line.assign(date);
+        line += ",TXN" + std::to_string(i + 1) + "," + kTypes[kind] + "," + kTypes[kind] + " Transaction " +
+            std::to_string(i + 1) + ",";
+        line.append(amount, Money::fromCents(1 + random() % 1000000).format(amount));
+        line += "," + kPaymentMethods[random() % kPaymentMethods.size()] + "," + kCategories[kind] + "\n";
+        file.write(line.data(), static_cast<qint64>(line.size()));
+    }
+    return fixtures.emplace(rows, path).first->second;
+}
+
+/**
+ * @brief Returns n invoices with varied customers, amounts, due dates and statuses.
+ */
+std::vector<Invoice> makeInvoices(int64_t count) {
+    static const QString statuses[] = { "Pending", "Paid", "Overdue" };
+    std::mt19937 random(kSeed);
+    std::vector<Invoice> invoices;
+    invoices.reserve(static_cast<size_t>(count));
+    const QDate start(2024, 1, 1);
+    for (int64_t i = 0; i < count; ++i) {
+        invoices.emplace_back(QString("Customer %1").arg(random() % 10000), QString("%1 Main Street").arg(i),
+            Money::fromCents(random() % 10000000), start.addDays(random() % 365));
+        invoices.back().setInvoiceID(static_cast<int>(i + 1));
+        invoices.back().setStatus(statuses[random() % 3]);
+    }
+    return invoices;
+}
+
+/**
+ * @brief Returns a budget page document holding the given number of expenses, spread over all budget periods.
+ *
+ * Follows the layout BudgetPage::getJSONBudget() reads: 18 budgets, each with an
+ * "Expenses" array.
+ */
+QJsonObject makeBudgetJson(int64_t expenseCount) {
+    constexpr int kBudgetPeriods = 18;
+    std::mt19937 random(kSeed);
+    QJsonArray budgets;
+    for (int period = 0; period < kBudgetPeriods; ++period) {
+        QJsonArray expenses;
+        for (int64_t i = period; i < expenseCount; i += kBudgetPeriods) {
+            QJsonObject expense;
+            expense.insert("name", QString("Expense %1").arg(i));
+            expense.insert("description", QString("Synthetic expense %1").arg(i));
+            expense.insert("price", Money::fromCents(random() % 100000).toDouble());
+            expense.insert("quantity", int(1 + random() % 20));
+            expense.insert("Category Index", 0);
+            expenses.append(expense);
+        }
+        QJsonObject budget;
+        budget.insert("Budget", 50000.0);
+        budget.insert("Total Expenses", 0.0);
+        budget.insert("Remaining Budget", 50000.0);
+        budget.insert("Expenses", expenses);
+        budget.insert("Index", period);
+        budget.insert("Goal", 1000.0);
+        budgets.append(budget);
+    }
+    QJsonObject page;
+    page.insert("Budgets", budgets);
+    page.insert("Categories", QJsonArray{ "Default Category" });
+    return page;
+}
+
+// --- Ledger ------------------------------------------------------------------
+
+void BM_LedgerAddData(benchmark::State& state) {
+    const int64_t rows = state.range(0);
+    const std::string path = scratchPath("ledger_add.dat");
+    LedgerRowSource source;
+    for (auto _ : state) {
+        state.PauseTiming();
+        removeLedgerFiles(path);
+        auto ledger = std::make_unique<CashflowTracking>(path);
+        state.ResumeTiming();
+        for (int64_t i = 0; i < rows; ++i) {
+            source.add(*ledger, static_cast<uint64_t>(i));
+        }
+        ledger.reset(); // Includes waiting for a background snapshot started by the adds
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+}
+
+void BM_LedgerSearch(benchmark::State& state) {
+    const LedgerFixture& fixture = ledgerFixture(state.range(0));
+    CashflowTracking ledger(fixture.path);
+
+    std::mt19937 random(kSeed);
+    std::vector<int> ids(4096);
+    for (int& id : ids) {
+        id = fixture.firstID + static_cast<int>(random() % static_cast<uint32_t>(state.range(0)));
+    }
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ledger.searchDataEntries(ids[next]));
+        next = (next + 1) % ids.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Deletes a fixed number of random entries, so the result shows how a delete scales with ledger size.
+ */
+void BM_LedgerDelete(benchmark::State& state) {
+    constexpr int64_t kDeletes = 10000;
+    const LedgerFixture& fixture = ledgerFixture(state.range(0));
+    const std::string path = scratchPath("ledger_delete.dat");
+
+    std::vector<int> ids(static_cast<size_t>(std::min(kDeletes, state.range(0))));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = fixture.firstID + static_cast<int>(i * static_cast<size_t>(state.range(0)) / ids.size());
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(kSeed));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        copyLedger(fixture.path, path);
+        auto ledger = std::make_unique<CashflowTracking>(path);
+        state.ResumeTiming();
+        for (int id : ids) {
+            ledger->deleteData(id);
+        }
+        ledger.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ids.size()));
+}
+
+void BM_LedgerSave(benchmark::State& state) {
+    const LedgerFixture& fixture = ledgerFixture(state.range(0));
+    const std::string path = scratchPath("ledger_save.dat");
+    copyLedger(fixture.path, path);
+    CashflowTracking ledger(path);
+    for (auto _ : state) {
+        if (!ledger.saveDataToFile()) {
+            state.SkipWithError("saveDataToFile failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+}
+
+void BM_LedgerLoad(benchmark::State& state) {
+    const LedgerFixture& fixture = ledgerFixture(state.range(0));
+    CashflowTracking ledger(scratchPath("ledger_load_empty.dat"));
+    for (auto _ : state) {
+        if (!ledger.open(fixture.path)) {
+            state.SkipWithError("open failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(fixture.path)));
+}
+
+// --- Financial reports -------------------------------------------------------
+
+void BM_ReportLoadCsv(benchmark::State& state) {
+    const QString& path = reportCsvFixture(state.range(0));
+    for (auto _ : state) {
+        FinancialReportGenerator generator;
+        if (!generator.loadCSV(path)) {
+            state.SkipWithError("loadCSV failed");
+            break;
+        }
+        benchmark::DoNotOptimize(generator.transactionCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * QFileInfo(path).size());
+}
+
+void BM_ReportGenerate(benchmark::State& state, bool (FinancialReportGenerator::* generate)(const QString&)) {
+    FinancialReportGenerator generator;
+    if (!generator.loadCSV(reportCsvFixture(state.range(0)))) {
+        state.SkipWithError("loadCSV failed");
+        return;
+    }
+    const QString output = scratchDir().filePath("report.csv");
+    for (auto _ : state) {
+        if (!(generator.*generate)(output)) {
+            state.SkipWithError("report not written");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// --- Invoices ----------------------------------------------------------------
+
+/**
+ * @brief Serializes invoices to a JSON document and reads them back, as saving and loading the invoice list does.
+ */
+void BM_InvoiceJsonRoundTrip(benchmark::State& state) {
+    const std::vector<Invoice> invoices = makeInvoices(state.range(0));
+    std::vector<Invoice> loaded;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        QJsonArray array;
+        for (const Invoice& invoice : invoices) {
+            array.append(invoice.toJson());
+        }
+        const QByteArray json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+        bytes += json.size();
+
+        loaded.clear();
+        loaded.reserve(invoices.size());
+        for (const QJsonValue& value : QJsonDocument::fromJson(json).array()) {
+            loaded.push_back(Invoice::fromJson(value.toObject()));
+        }
+        benchmark::DoNotOptimize(loaded.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(bytes);
+}
+
+/**
+ * @brief Same round trip through JsonStreamWriter and JsonStreamReader, which never build the whole document.
+ */
+void BM_InvoiceJsonStreamRoundTrip(benchmark::State& state) {
+    const std::vector<Invoice> invoices = makeInvoices(state.range(0));
+    std::vector<Invoice> loaded;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        {
+            JsonStreamWriter writer(&buffer);
+            writer.beginArray();
+            for (const Invoice& invoice : invoices) {
+                writer.value(invoice.toJson());
+            }
+            writer.endArray();
+        }
+        buffer.close();
+        bytes += buffer.size();
+
+        loaded.clear();
+        loaded.reserve(invoices.size());
+        buffer.open(QIODevice::ReadOnly);
+        JsonStreamReader::readObjectArray(&buffer, QString(), [&loaded](const QJsonObject& record) {
+            loaded.push_back(Invoice::fromJson(record));
+            });
+        benchmark::DoNotOptimize(loaded.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(bytes);
+}
+
+// --- Budget page -------------------------------------------------------------
+
+void BM_BudgetToJson(benchmark::State& state) {
+    BudgetPage page;
+    page.getJSONBudget(makeBudgetJson(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(QJsonDocument(page.to_JSON()).toJson(QJsonDocument::Compact));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BudgetGetJsonBudget(benchmark::State& state) {
+    const QJsonObject json = makeBudgetJson(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto page = std::make_unique<BudgetPage>(); // Every load needs a fresh page, see getJSONBudget()
+        state.ResumeTiming();
+        page->getJSONBudget(json);
+        state.PauseTiming();
+        page.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_LedgerAddData)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LedgerSearch)->RangeMultiplier(10)->Range(10000, 10000000);
+BENCHMARK(BM_LedgerDelete)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LedgerSave)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_LedgerLoad)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK(BM_ReportLoadCsv)->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_ReportGenerate, profit_loss, &FinancialReportGenerator::generateProfitLossStatement)
+    ->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ReportGenerate, expense_breakdown, &FinancialReportGenerator::generateExpenseBreakdownReport)
+    ->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ReportGenerate, balance_sheet, &FinancialReportGenerator::generateBalanceSheetReport)
+    ->RangeMultiplier(10)->Range(10000, 10000000)->Unit(benchmark::kMillisecond);
+
+// QJsonDocument cannot hold much more than a million invoices
+BENCHMARK(BM_InvoiceJsonRoundTrip)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InvoiceJsonStreamRoundTrip)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Every expense owns a set of widgets, so the budget page stays at realistic sizes
+BENCHMARK(BM_BudgetToJson)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BudgetGetJsonBudget)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Runs the benchmarks; prints JSON unless --benchmark_format says otherwise.
+ *
+ * The budget page benchmarks create widgets, so a QApplication is needed; it uses the
+ * offscreen platform unless QT_QPA_PLATFORM is set.
+ */
+int main(int argc, char* argv[]) {
+    std::vector<char*> arguments(argv, argv + argc);
+    char jsonFormat[] = "--benchmark_format=json";
+    const bool formatGiven = std::any_of(arguments.begin(), arguments.end(), [](const char* argument) {
+        return std::strncmp(argument, "--benchmark_format", 18) == 0;
+        });
+    if (!formatGiven) {
+        arguments.push_back(jsonFormat);
+    }
+    int count = static_cast<int>(arguments.size());
+    arguments.push_back(nullptr);
+
+    benchmark::Initialize(&count, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(count, arguments.data())) {
+        return 1;
+    }
+
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(count, arguments.data());
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,4 +1,58 @@
 #include "budgetpage.h"
+#include "tracing.h"
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace {
+
+constexpr int kAutosaveDelayMs = 750;        // Quiet period that ends a burst of edits
+constexpr qint64 kAutosaveMaxDelayMs = 3000; // Edits that keep coming are still saved this often
+
+/**
+ * @brief Returns the budget file of a user, creating the data directory if needed
+ * @return the file path, or an empty string if the directory could not be created
+ */
+QString budgetFilePath(const QString& userId) {
+    // Use a consistent location across computers - AppDataLocation is platform-specific
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/BusinessManagementSystem/data";
+    QDir dir;
+    if (!dir.exists(dataPath) && !dir.mkpath(dataPath)) {
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Failed to create data directory at:" << dataPath;
+        return QString();
+    }
+    return dataPath + "/" + userId + "_budget.json";
+}
+
+/**
+ * @brief Serializes budget data and replaces the budget file with it
+ * \n touches no widgets, so it runs on a worker thread for autosaves
+ * @return bool True if the file was replaced
+ */
+bool writeBudgetFile(const QString& filePath, const QJsonObject& budgetData) {
+    NOOMYPLAN_TRACE_SCOPE("budget.write");
+    const QByteArray jsonData = QJsonDocument(budgetData).toJson();
+
+    // QSaveFile keeps the previous file intact if the write is cut short
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Failed to open file for writing:" << filePath << file.errorString();
+        return false;
+    }
+    const qint64 bytesWritten = file.write(jsonData);
+    if (bytesWritten != jsonData.size()) {
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Failed to write all data. Written:" << bytesWritten << "Expected:" << jsonData.size();
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Failed to replace" << filePath << file.errorString();
+        return false;
+    }
+    NOOMYPLAN_LOG_INFO(lcBudget) << "Successfully saved budget data to:" << filePath;
+    return true;
+}
+
+} // namespace
 
 
 /**
@@ -13,6 +67,20 @@ BudgetPage::BudgetPage(QWidget* parent)
     this->budgetPeriodIndex = 1;
     this->setWindowTitle("Budget plan");
 
+    //autosave; created first because building the UI can already emit change signals
+    autosaveTimer = new QTimer(this);
+    autosaveTimer->setSingleShot(true);
+    autosaveTimer->setInterval(kAutosaveDelayMs);
+    connect(autosaveTimer, &QTimer::timeout, this, &BudgetPage::startAutosaveWrite);
+    autosaveWatcher = new QFutureWatcher<bool>(this);
+    connect(autosaveWatcher, &QFutureWatcher<bool>::finished, this, [this]() {
+        collectAutosaveWrite();
+        // Edits made while the file was being written, or a write that failed, get a write of their own
+        if (autosaveDirty && !autosaveTimer->isActive()) {
+            autosaveTimer->start();
+        }
+    });
+
     //creates budget objects for every possible budget period
     budgetsObject = new QObject();
     for (int i = 0; i <= 17; i++) {
@@ -127,17 +195,10 @@ void BudgetPage::getJSONBudget(const QJsonObject& budget) {
  * @author - Katherine R
  */
 void BudgetPage::onBudgetChangeSlot(double budget) {
-    this->budgets[budgetPeriodIndex]->setBudget(budget);
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "Changed Budget - " << budget;
-    }
+    this->budgets[budgetPeriodIndex]->setBudget(Money::fromDouble(budget)); //spinbox is bounded, so this always fits
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget - " << budget;
     calculateRemainingBudget();
-    
-    // Force immediate save whenever a budget value changes
-    if (!userId.isEmpty()) {
-        qDebug() << "Auto-saving after budget change";
-        saveBudgetData(userId);
-    }
+    scheduleAutosave();
 }
 
 /**
@@ -147,17 +208,11 @@ void BudgetPage::onBudgetChangeSlot(double budget) {
  * @author - Katherine R
  */
 void BudgetPage::onBudgetGoalChangedSlot(double goal) {
-    this->budgets[budgetPeriodIndex]->setBudgetGoal(goal);
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "Changed Budget goal - " << goal;
-    }
+    this->budgets[budgetPeriodIndex]->setBudgetGoal(Money::fromDouble(goal));
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget goal - " << goal;
 
     calculateRemainingBudget();
-    
-    // Auto-save when budget goal changes
-    if (!userId.isEmpty()) {
-        saveBudgetData(userId);
-    }
+    scheduleAutosave();
 }
 
 
@@ -168,21 +223,15 @@ void BudgetPage::onBudgetGoalChangedSlot(double goal) {
  * @param delta - change in expense
  * @author - Katherine R
  */
-void BudgetPage::onExpenseChangedSlot(double delta) {
+void BudgetPage::onExpenseChangedSlot(Money delta) {
     budgets[budgetPeriodIndex]->changeTotalExpenses(delta);
     //changes the expense for the budget object by adding the change
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "new delta in expense " << delta;
-    }
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "new delta in expense " << QString::fromStdString(delta.toString());
     expenses_totalExpensesLabel->setText(
-        "Total Expenses: $0" + QString::number(budgets.at(budgetPeriodIndex)->getTotalExpenses()));
+        "Total Expenses: $" + QString::fromStdString(budgets.at(budgetPeriodIndex)->getTotalExpenses().toString()));
     //updates the total expense text
     calculateRemainingBudget();
-    
-    // Auto-save when expenses change
-    if (!userId.isEmpty()) {
-        saveBudgetData(userId);
-    }
+    scheduleAutosave();
 }
 
 /**
@@ -208,9 +257,7 @@ void BudgetPage::onBudgetPeriodTypeChangedSlot(int index) {
         //changes the budgets index to the last one saved for quarter
         budgetPeriod_MonthlyComboBox->setHidden(true); //hides monthly selector combobox
         budgetPeriod_QuarterlyComboBox->setHidden(false); //shows quarter selector
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Quarterly" << budgetPeriodIndex;
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Quarterly" << budgetPeriodIndex;
         break;
     case 1: // Monthly
         budgetPeriodIndex = budgetPeriod_MonthlyComboBox->currentIndex() + 5;
@@ -219,9 +266,7 @@ void BudgetPage::onBudgetPeriodTypeChangedSlot(int index) {
         budgetPeriod_QuarterlyComboBox->setHidden(true); //hides quarter selector combobox
         labelText = tr("Monthly Budget - ") + budgetPeriod_MonthlyComboBox->currentText();
         //sets text to monthly budget - (month)
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Monthly" << budgetPeriodIndex;
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Monthly" << budgetPeriodIndex;
         break;
     case 2: // Yearly
         budgetPeriodIndex = 0;
@@ -229,14 +274,10 @@ void BudgetPage::onBudgetPeriodTypeChangedSlot(int index) {
         budgetPeriod_MonthlyComboBox->setHidden(true);
         budgetPeriod_QuarterlyComboBox->setHidden(true);
         labelText = tr("Yearly Budget"); //sets text to yearly budget
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Yearly";
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Yearly";
         break;
     default:
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Unknown";
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Unknown";
         break;
     }
     budgetSelector_Label->setText(labelText);
@@ -259,9 +300,7 @@ void BudgetPage::onBudgetPeriodChangeSlot(int index, char period) {
     //disables old expense area
     switch (period) {
     case 'Q': //Quarterly
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Quarterly " << budgetPeriod_QuarterlyComboBox->currentText();
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Quarterly " << budgetPeriod_QuarterlyComboBox->currentText();
         labelText = tr("Quarterly Budget - ") + budgetPeriod_QuarterlyComboBox->currentText();
         //sets new text as Quarterly Budget- QX
         budgetPeriodIndex = budgetPeriod_QuarterlyComboBox->currentIndex() + 1;
@@ -269,9 +308,7 @@ void BudgetPage::onBudgetPeriodChangeSlot(int index, char period) {
 
         break;
     case 'M': //monthly
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Changed Budget Period - Monthly" << budgetPeriod_MonthlyComboBox->currentText();
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed Budget Period - Monthly" << budgetPeriod_MonthlyComboBox->currentText();
 
         labelText = tr("Monthly Budget - ") + budgetPeriod_MonthlyComboBox->currentText();
         //sets text as monthly budget - month
@@ -279,9 +316,7 @@ void BudgetPage::onBudgetPeriodChangeSlot(int index, char period) {
         //changes budgets index to the selected one
         break;
     default:
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Unknown budget period changed";
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Unknown budget period changed";
         break;
     }
     budgetSelector_Label->setText(labelText);
@@ -305,7 +340,7 @@ void BudgetPage::calculateRemainingBudget() {
         budgets.at(budgetPeriodIndex)->getBudget() - budgets.at(budgetPeriodIndex)->getTotalExpenses());
     //updates remaining budget text
     expenses_remainingBudgetLabel->setText(
-        "Remaining Budget: $" + QString::number(budgets.at(budgetPeriodIndex)->getRemainingBudget()));
+        "Remaining Budget: $" + QString::fromStdString(budgets.at(budgetPeriodIndex)->getRemainingBudget().toString()));
     //changes text color to red to notify user of negative budget
     if (budgets.at(budgetPeriodIndex)->getRemainingBudget() < budgets.at(budgetPeriodIndex)->getBudgetGoal()) {
         expenses_remainingBudgetLabel->setStyleSheet("Color: #BF2C0C"); // Red for Remaining Budget
@@ -318,9 +353,7 @@ void BudgetPage::calculateRemainingBudget() {
         warningLabel->setVisible(false);
     }
 
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "Remaining Budget - " << budgets.at(budgetPeriodIndex)->getRemainingBudget();
-    }
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "Remaining Budget - " << QString::fromStdString(budgets.at(budgetPeriodIndex)->getRemainingBudget().toString());
 }
 
 /**
@@ -489,26 +522,26 @@ void BudgetPage::createExpensesSubPage() {
 
 /**
  * @brief getter for the set budget at the current period
- * @return the budgeted amount, double
+ * @return the budgeted amount
  */
-double BudgetPage::getBudget() {
-    return this->budgetSelector_SpinBox->value();
+Money BudgetPage::getBudget() {
+    return this->budgets[budgetPeriodIndex]->getBudget();
 }
 
 /**
  * @brief getter for the total expense for the budget period
- * @return the total expense, double
+ * @return the total expense
  */
-double BudgetPage::getTotalExpenses() {
+Money BudgetPage::getTotalExpenses() {
     return this->budgets[budgetPeriodIndex]->getTotalExpenses();
 }
 
 /**
  * @brief getter for the budget surplus goal at the current period
- * @return the surplus goal, double
+ * @return the surplus goal
  */
-double BudgetPage::getSurplusGoal() {
-    return this->budgetSelector_goalSpinBox->value();
+Money BudgetPage::getSurplusGoal() {
+    return this->budgets[budgetPeriodIndex]->getBudgetGoal();
 }
 
 /**
@@ -517,14 +550,18 @@ double BudgetPage::getSurplusGoal() {
  */
 void BudgetPage::setCurrentUserId(const QString& userId) {
     try {
-        qDebug() << "Setting user ID in BudgetPage:" << userId;
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Setting user ID in BudgetPage:" << userId;
+        // Pending edits belong to the previous user
+        if (!this->userId.isEmpty() && this->userId != userId) {
+            flushAutosave();
+        }
         // Don't use QString constructor here - just use direct assignment
         this->userId = userId;
-        qDebug() << "User ID set successfully in BudgetPage";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "User ID set successfully in BudgetPage";
     } catch (const std::exception& e) {
-        qDebug() << "Exception in setCurrentUserId:" << e.what();
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Exception in setCurrentUserId:" << e.what();
     } catch (...) {
-        qDebug() << "Unknown exception in setCurrentUserId";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Unknown exception in setCurrentUserId";
     }
 }
 
@@ -658,23 +695,21 @@ void BudgetPage::changeExpenseCategory(int index) {
  */
 void BudgetPage::changeBudgetPage() {
     if (this->budgetPeriodIndex >= 0 && this->budgetPeriodIndex <= 17) {
-        qDebug() << "Changed budget page";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Changed budget page";
         //changes budget setter spinbox to the value of the changed page
-        budgetSelector_SpinBox->setValue(budgets[budgetPeriodIndex]->getBudget());
+        budgetSelector_SpinBox->setValue(budgets[budgetPeriodIndex]->getBudget().toDouble());
         //changes budget goal setter spinbox to the value of the changed page
-        budgetSelector_goalSpinBox->setValue(budgets.at(budgetPeriodIndex)->getBudgetGoal());
+        budgetSelector_goalSpinBox->setValue(budgets.at(budgetPeriodIndex)->getBudgetGoal().toDouble());
         //changes the total expenses text to the value of the changed page
         expenses_totalExpensesLabel->setText(
-            "Total Expenses: $0" + QString::number(budgets.at(budgetPeriodIndex)->getTotalExpenses()));
+            "Total Expenses: $" + QString::fromStdString(budgets.at(budgetPeriodIndex)->getTotalExpenses().toString()));
         //shows and enables new expense area
         budgets[budgetPeriodIndex]->getExpensescrollarea(expenses_categoriesComboBox_index)->show();
         budgets[budgetPeriodIndex]->getExpensescrollarea(expenses_categoriesComboBox_index)->setDisabled(false);
         calculateRemainingBudget();
     }
     else {
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Budget period index out of range";
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Budget period index out of range";
     }
 }
 
@@ -699,11 +734,8 @@ void BudgetPage::newExpense() {
         [this, tempExpense]() {
             deleteExpense(tempExpense);
         });
-    
-    // Auto-save when adding a new expense
-    if (!userId.isEmpty()) {
-        saveBudgetData(userId);
-    }
+
+    scheduleAutosave();
 }
 
 
@@ -718,16 +750,11 @@ void BudgetPage::deleteExpense(BudgetPageExpenses* toDelete) {
     //gets index of expense to delete
     long long index = budgets[budgetPeriodIndex]->getExpenses()->indexOf(toDelete);
     //gets the the expense value of the object to be deleted
-    double tempExpenseTotal = budgets[budgetPeriodIndex]->getExpenses()->at(index)->getExpense();
+    Money tempExpenseTotal = budgets[budgetPeriodIndex]->getExpenses()->at(index)->getExpense();
     //deletes object, then removes it from the budget page's QVector
     budgets[budgetPeriodIndex]->getExpenses()->at(index)->deleteLater();
     budgets[budgetPeriodIndex]->getExpenses()->removeAt(index);
-    onExpenseChangedSlot(-tempExpenseTotal); //removes from total expenses
-    
-    // Auto-save when deleting an expense
-    if (!userId.isEmpty()) {
-        saveBudgetData(userId);
-    }
+    onExpenseChangedSlot(-tempExpenseTotal); //removes from total expenses, which also schedules the autosave
 }
 
 
@@ -777,15 +804,15 @@ void BudgetPage::updateBarGraph() {
     }
     //adds values from budgets to graph QBarset
     for (int i = rangelow; i <= rangehigh; i++) {
-        barChart_goalLine->append(i - rangelow, budgets.at(i)->getBudgetGoal());
-        if (budgets.at(i)->getRemainingBudget() < 0) {
+        barChart_goalLine->append(i - rangelow, budgets.at(i)->getBudgetGoal().toDouble());
+        if (budgets.at(i)->getRemainingBudget().isNegative()) {
             // if the remaining budget is negative
-            barChart_Neg->append((qreal)budgets.at(i)->getRemainingBudget()); //adds value to negative chart
+            barChart_Neg->append(budgets.at(i)->getRemainingBudget().toDouble()); //adds value to negative chart
             barChart_Value->append((qreal)0); //adds 0 to the positive chart
         }
         else {
             barChart_Neg->append((qreal)0); //adds 0 to the negative chart
-            barChart_Value->append((qreal)budgets.at(i)->getRemainingBudget()); //adds value to the positive chart
+            barChart_Value->append(budgets.at(i)->getRemainingBudget().toDouble()); //adds value to the positive chart
         }
     }
     //sets the colors for the bar chart bars
@@ -824,9 +851,14 @@ void BudgetPage::updateBarGraph() {
   * @author Katherine R
  */
 BudgetPage::~BudgetPage() {
-    qDebug() << "BudgetPage destructor started";
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "BudgetPage destructor started";
     
     try {
+        // Let a background write finish; pending edits are flushed by MainWindow::closeEvent
+        autosaveTimer->stop();
+        collectAutosaveWrite();
+
+
         // Safely disconnect signals first
         this->disconnect();
         
@@ -932,13 +964,13 @@ BudgetPage::~BudgetPage() {
             barGraph_updateButton = nullptr;
         }
         
-        qDebug() << "BudgetPage destructor completed successfully";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "BudgetPage destructor completed successfully";
     }
     catch (const std::exception& e) {
-        qDebug() << "Exception in BudgetPage destructor:" << e.what();
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Exception in BudgetPage destructor:" << e.what();
     }
     catch (...) {
-        qDebug() << "Unknown exception in BudgetPage destructor";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Unknown exception in BudgetPage destructor";
     }
 }
 
@@ -979,7 +1011,7 @@ void BudgetPage::createBudgetsCSV() {
 void BudgetPage::importCSV() {
     QString filepath = QFileDialog::getOpenFileName(this, "Select CSV File", "", "CSV Files (*.csv)");
     if (!filepath.contains("csv")) {
-        qDebug() << "Importing Non-CSV file!";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Importing Non-CSV file!";
         QMessageBox::StandardButton warning = QMessageBox::critical(this, "warning", "can't import Non CSV file!",
             QMessageBox::Ok);
         return;
@@ -994,10 +1026,11 @@ void BudgetPage::importCSV() {
     if (valueList.size() == 6) {
         //if the csv line is the expected format
         //gets the values from the csv file
-        double budget = valueList.at(0).toDouble();
-        double totalExpenses = valueList.at(1).toDouble();
-        double remainingBudget = valueList.at(2).toDouble();
-        double budgetGoal = valueList.at(3).toDouble();
+        Money budget, totalExpenses, remainingBudget, budgetGoal; //unreadable values stay 0
+        Money::parse(valueList.at(0).toStdString(), budget);
+        Money::parse(valueList.at(1).toStdString(), totalExpenses);
+        Money::parse(valueList.at(2).toStdString(), remainingBudget);
+        Money::parse(valueList.at(3).toStdString(), budgetGoal);
         int budgetIndex = valueList.at(4).toInt();
         if (budgetIndex <= 17 && budgetIndex >= 0) {
             //sets variables to new ones
@@ -1007,8 +1040,8 @@ void BudgetPage::importCSV() {
             budgets[budgetIndex]->setBudgetGoal(budgetGoal);
             //if the current selected budgetpage is the one imported - changes the variables
             if (budgetPeriodIndex == budgetIndex) {
-                budgetSelector_SpinBox->setValue(budget);
-                budgetSelector_goalSpinBox->setValue(budgetGoal);
+                budgetSelector_SpinBox->setValue(budget.toDouble());
+                budgetSelector_goalSpinBox->setValue(budgetGoal.toDouble());
             }
 
             //reads category names and desc, creates categories for them
@@ -1041,7 +1074,7 @@ void BudgetPage::importCSV() {
                         newExpense();
                     }
                     else {
-                        qDebug() << "error! expense category exceeds total category count!";
+                        NOOMYPLAN_LOG_WARNING(lcBudget) << "error! expense category exceeds total category count!";
                         // //if the category doesn't exist-adds it to a new category
                         // while (valueList.at(4).toInt() > budgets.at(budgetIndex)->getCategoriesCount()) {
                         //     addExpenseCategory();
@@ -1050,8 +1083,10 @@ void BudgetPage::importCSV() {
                     }
                     budgets[budgetIndex]->getExpenses()->last()->setExpenseName(QString(valueList.at(0)));
                     budgets[budgetIndex]->getExpenses()->last()->setExpenseDescription(QString(valueList.at(1)));
-                    budgets[budgetIndex]->getExpenses()->last()->setExpenseQuantity(valueList.at(2).toDouble());
-                    budgets[budgetIndex]->getExpenses()->last()->setExpensePrice(valueList.at(3).toDouble());
+                    Money price; //unreadable prices stay 0
+                    Money::parse(valueList.at(3).toStdString(), price);
+                    budgets[budgetIndex]->getExpenses()->last()->setExpenseQuantity(qRound(valueList.at(2).toDouble()));
+                    budgets[budgetIndex]->getExpenses()->last()->setExpensePrice(price);
                     budgets[budgetIndex]->getExpenses()->last()->setCategoryindex(valueList.at(4).toInt());
                 }
             }
@@ -1062,7 +1097,7 @@ void BudgetPage::importCSV() {
     }
     else {
         //if the csv file isn't expected format
-        qDebug() << "improper csv format";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "improper csv format";
         QMessageBox::StandardButton warning = QMessageBox::critical(this, "warning", "improper csv format!",
             QMessageBox::Ok);
         return;
@@ -1075,111 +1110,174 @@ void BudgetPage::importCSV() {
  */
 // Modify BudgetPage::saveBudgetData method to be more robust
 bool BudgetPage::saveBudgetData(const QString& userId) {
+    NOOMYPLAN_TRACE_SCOPE("budget.save");
     if (userId.isEmpty()) {
-        if (SHOW_DEBUG_LOGS) {
-            qDebug() << "Cannot save budget data: User ID is empty";
-        }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Cannot save budget data: User ID is empty";
         return false;
     }
     
+    // A background write still running must not land after this one
+    collectAutosaveWrite();
+
     try {
-        qDebug() << "Starting budget data save for user:" << userId;
-        
-        // Get the JSON data from the budget
-        QJsonObject budgetData = to_JSON();
-        
-        // Add budget period to JSON if budgetPeriod_Label is valid
-        if (budgetPeriod_Label) {
-            budgetData.insert("Budget Period", budgetPeriod_Label->text());
-        }
-        
-        // Use a consistent location across computers - AppDataLocation is platform-specific
-        QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/BusinessManagementSystem/data";
-        
-        // Ensure data directory exists
-        QDir dir;
-        if (!dir.exists(dataPath)) {
-            bool created = dir.mkpath(dataPath);
-            if (!created) {
-                qDebug() << "Failed to create data directory at:" << dataPath;
-                return false;
-            }
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Starting budget data save for user:" << userId;
+
+        const QString filePath = budgetFilePath(userId);
+        if (filePath.isEmpty()) {
+            return false;
         }
-        
-        // Save the file
-        QString filePath = dataPath + "/" + userId + "_budget.json";
-        QFile file(filePath);
-        
-        if (file.open(QIODevice::WriteOnly)) {
-            QByteArray jsonData = QJsonDocument(budgetData).toJson();
-            qint64 bytesWritten = file.write(jsonData);
-            file.close();
-            
-            if (bytesWritten == jsonData.size()) {
-                qDebug() << "Successfully saved budget data to:" << filePath;
-                return true;
-            } else {
-                qDebug() << "Failed to write all data. Written:" << bytesWritten << "Expected:" << jsonData.size();
-                return false;
-            }
-        } else {
-            qDebug() << "Failed to open file for writing:" << filePath;
-            qDebug() << "Error:" << file.errorString();
+        if (!writeBudgetFile(filePath, buildSaveData())) {
             return false;
         }
+
+        // Everything is on disk now, so a pending autosave has nothing left to do
+        if (userId == this->userId) {
+            autosaveTimer->stop();
+            autosaveDirty = false;
+        }
+        return true;
     } catch (const std::exception& e) {
-        qDebug() << "Exception in saveBudgetData:" << e.what();
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Exception in saveBudgetData:" << e.what();
         return false;
     } catch (...) {
-        qDebug() << "Unknown exception in saveBudgetData";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Unknown exception in saveBudgetData";
         return false;
     }
 }
 
+/**
+ * @brief Writes pending edits now instead of waiting for the autosave timer
+ * @return bool True unless the pending edits could not be saved
+ */
+bool BudgetPage::flushAutosave() {
+    autosaveTimer->stop();
+    collectAutosaveWrite(); // A failed background write leaves the page dirty again
+    if (autosaveDirty && !userId.isEmpty()) {
+        return saveBudgetData(userId);
+    }
+    return true;
+}
+
+/**
+ * @brief marks the budgets as changed and (re)starts the autosave timer
+ */
+void BudgetPage::scheduleAutosave() {
+    if (userId.isEmpty()) {
+        return;
+    }
+    NOOMYPLAN_TRACE_COUNT("budget.autosaveRequests", 1);
+    if (!autosaveDirty) {
+        autosaveDirty = true;
+        autosaveDirtySince.start();
+    }
+    // Holding a spin box arrow restarts the timer on every tick; stop restarting once the first edit has waited long enough
+    if (!autosaveTimer->isActive() || autosaveDirtySince.elapsed() + kAutosaveDelayMs <= kAutosaveMaxDelayMs) {
+        autosaveTimer->start();
+    }
+}
+
+/**
+ * @brief snapshots the budgets on the GUI thread and writes them on a worker thread
+ */
+void BudgetPage::startAutosaveWrite() {
+    if (!autosaveDirty || userId.isEmpty()) {
+        return;
+    }
+    if (autosaveWatcher->isRunning()) {
+        return; // Restarted by the watcher once the current write finishes
+    }
+    const QString filePath = budgetFilePath(userId);
+    if (filePath.isEmpty()) {
+        return; // Stays dirty, so the next edit or the flush on close tries again
+    }
+
+    // to_JSON() reads the budget objects, so the snapshot is taken here; only serializing and writing move off the GUI thread
+    const QJsonObject budgetData = buildSaveData();
+    autosaveDirty = false;
+    autosaveWriteUnchecked = true;
+    autosaveWatcher->setFuture(QtConcurrent::run(writeBudgetFile, filePath, budgetData));
+}
+
+/**
+ * @brief waits for the background write and marks the page dirty again if it failed
+ */
+void BudgetPage::collectAutosaveWrite() {
+    autosaveWatcher->waitForFinished();
+    if (!autosaveWriteUnchecked) {
+        return;
+    }
+    autosaveWriteUnchecked = false;
+    if (!autosaveWatcher->result()) {
+        // The edits in that snapshot are not on disk; keep them pending so a retry or the flush on close saves them
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Autosave failed; will retry";
+        if (!autosaveDirty) {
+            autosaveDirty = true;
+            autosaveDirtySince.start();
+        }
+    }
+}
+
+/**
+ * @brief returns to_JSON() plus the selected budget period, as written to the budget file
+ */
+QJsonObject BudgetPage::buildSaveData() {
+    QJsonObject budgetData = to_JSON();
+
+    // Add budget period to JSON if budgetPeriod_Label is valid
+    if (budgetPeriod_Label) {
+        budgetData.insert("Budget Period", budgetPeriod_Label->text());
+    }
+    return budgetData;
+}
+
 /**
  * @brief Loads budget data from a JSON file for the current user
  * @param userId The ID of the current user
  * @return bool True if loaded successfully, false otherwise
  */
 bool BudgetPage::loadBudgetData(const QString& userId) {
+    NOOMYPLAN_TRACE_SCOPE("budget.load");
     try {
-        qDebug() << "BudgetPage::loadBudgetData - Starting for user:" << userId;
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "BudgetPage::loadBudgetData - Starting for user:" << userId;
         
         if (userId.isEmpty()) {
-            qDebug() << "ERROR: Cannot load budget data: User ID is empty";
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "ERROR: Cannot load budget data: User ID is empty";
             return false;
         }
 
+        // Read what a background write is still putting there
+        collectAutosaveWrite();
+
         // Use the same location as in saveBudgetData
         QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/BusinessManagementSystem/data";
-        qDebug() << "Data path:" << dataPath;
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Data path:" << dataPath;
         
         QString filePath = dataPath + "/" + userId + "_budget.json";
-        qDebug() << "Full file path:" << filePath;
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Full file path:" << filePath;
         
         QFile file(filePath);
 
         if (!file.exists()) {
-            qDebug() << "Budget file does not exist for user:" << userId;
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "Budget file does not exist for user:" << userId;
             return false;
         }
 
         if (!file.open(QIODevice::ReadOnly)) {
-            qDebug() << "Failed to open budget file:" << file.errorString();
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "Failed to open budget file:" << file.errorString();
             return false;
         }
 
-        qDebug() << "Successfully opened budget file";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "Successfully opened budget file";
         QByteArray fileData = file.readAll();
         file.close();
         
-        qDebug() << "File size:" << fileData.size() << "bytes";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "File size:" << fileData.size() << "bytes";
 
         QJsonParseError parseError;
         QJsonDocument doc = QJsonDocument::fromJson(fileData, &parseError);
 
         if (parseError.error != QJsonParseError::NoError) {
-            qDebug() << "JSON parse error:" << parseError.errorString() 
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "JSON parse error:" << parseError.errorString() 
                      << "at offset" << parseError.offset;
             return false;
         }
@@ -1187,35 +1285,35 @@ bool BudgetPage::loadBudgetData(const QString& userId) {
         // Load the budget data
         QJsonObject budgetObj = doc.object();
         if (budgetObj.isEmpty()) {
-            qDebug() << "Parsed JSON object is empty";
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "Parsed JSON object is empty";
             return false;
         }
         
-        qDebug() << "JSON contains" << budgetObj.keys().size() << "keys:" << budgetObj.keys();
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "JSON contains" << budgetObj.keys().size() << "keys:" << budgetObj.keys();
         
         try {
             getJSONBudget(budgetObj);
             
             // Update UI to reflect loaded data
             if (budgetPeriodIndex >= 0 && budgetPeriodIndex < budgets.size()) {
-                qDebug() << "Calling changeBudgetPage() after loading";
+                NOOMYPLAN_LOG_DEBUG(lcBudget) << "Calling changeBudgetPage() after loading";
                 changeBudgetPage();
             }
             
-            qDebug() << "Successfully loaded budget data for user:" << userId;
+            NOOMYPLAN_LOG_INFO(lcBudget) << "Successfully loaded budget data for user:" << userId;
             return true;
         } catch (const std::exception& e) {
-            qDebug() << "Exception loading budget data:" << e.what();
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "Exception loading budget data:" << e.what();
             return false;
         } catch (...) {
-            qDebug() << "Unknown exception loading budget data";
+            NOOMYPLAN_LOG_WARNING(lcBudget) << "Unknown exception loading budget data";
             return false;
         }
     } catch (const std::exception& e) {
-        qDebug() << "Exception in loadBudgetData function:" << e.what();
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Exception in loadBudgetData function:" << e.what();
         return false;
     } catch (...) {
-        qDebug() << "Unknown exception in loadBudgetData function";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Unknown exception in loadBudgetData function";
         return false;
     }
 }
\ No newline at end of file
@@ -28,13 +28,12 @@
 #include <QStandardPaths>
 #include <QDir>
 #include <QJsonDocument>
-#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QTimer>
 #include "budgetpagebudget.h"
 #include "budgetpageexpenses.h"
-
-#ifndef SHOW_DEBUG_LOGS
-#define SHOW_DEBUG_LOGS true
-#endif
+#include "logging.h"
 
 /**
 * This is the UI class for the budgetpage
@@ -87,21 +86,21 @@ public:
 
     /**
      * @brief getter for the set budget at the current period
-     * @return the budgeted amount, double
+     * @return the budgeted amount
      */
-    double getBudget();
+    Money getBudget();
 
     /**
      * @brief getter for the total expense for the budget period
-     * @return the total expense, double
+     * @return the total expense
      */
-    double getTotalExpenses();
+    Money getTotalExpenses();
 
     /**
      * @brief getter for the budget surplus goal at the current period
-     * @return the surplus goal, double
+     * @return the surplus goal
      */
-    double getSurplusGoal();
+    Money getSurplusGoal();
 
     /**
      * @brief stter for user id
@@ -123,6 +122,13 @@ public:
      */
     bool loadBudgetData(const QString& userId);
 
+    /**
+     * @brief Writes pending edits now instead of waiting for the autosave timer
+     * \n waits for an autosave that is already being written, so the file is current when this returns
+     * @return bool True unless the pending edits could not be saved
+     */
+    bool flushAutosave();
+
 public slots:
     /**
      * @brief QT Slot to detect changes in the budget goal SpinBox
@@ -147,7 +153,7 @@ public slots:
      * @param delta - change in expense
      * @author - Katherine R
      */
-    void onExpenseChangedSlot(double delta);
+    void onExpenseChangedSlot(Money delta);
 
     /**
      * @brief Slot for when the user changes the budget period type (monthly , quarterly, yearly)
@@ -304,6 +310,36 @@ private:
     QGroupBox* budgetButtonGroupBox;
     QLabel* warningLabel;
 
+    // Autosave: edits mark the page dirty and the timer coalesces a burst of them into one background write
+    QTimer* autosaveTimer;
+    QElapsedTimer autosaveDirtySince;      // Started by the first edit since the last save
+    bool autosaveDirty = false;
+    QFutureWatcher<bool>* autosaveWatcher; // Tracks the background write, if one is running
+    bool autosaveWriteUnchecked = false;   // The last background write's result has not been looked at yet
+
+    /**
+     * @brief marks the budgets as changed and (re)starts the autosave timer
+     * \n the timer restarts on every edit, but never holds the first unsaved edit back more than a few seconds
+     */
+    void scheduleAutosave();
+
+    /**
+     * @brief snapshots the budgets on the GUI thread and writes them on a worker thread
+     * \n if a write is still running, the snapshot is taken again when it finishes
+     */
+    void startAutosaveWrite();
+
+    /**
+     * @brief waits for the background write and marks the page dirty again if it failed
+     * \n each write's result is checked once, whether by the watcher or by a save that waits for it
+     */
+    void collectAutosaveWrite();
+
+    /**
+     * @brief returns to_JSON() plus the selected budget period, as written to the budget file
+     */
+    QJsonObject buildSaveData();
+
     /**
       * @brief calculates the remaining budget for budgets[budgetPeriodIndex]
       * for budgets[budgetPeriodIndex] :budget - total expenses
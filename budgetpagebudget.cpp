@@ -12,11 +12,11 @@
  */
 BudgetPageBudget::BudgetPageBudget(QObject* parent)
     : QObject{ parent } {
-    this->budget = 0;
-    this->totalExpenses = 0;
-    this->remainingBudget = 0;
+    this->budget = Money();
+    this->totalExpenses = Money();
+    this->remainingBudget = Money();
     this->budgetIndex = 0;
-    this->budgetGoal = 0;
+    this->budgetGoal = Money();
     this->budgetCategoryNames = new QStringList("Default Category");
     this->budgetCategoryDescriptions = new QStringList("Default Description");
     //creates area for expenses
@@ -32,11 +32,11 @@ BudgetPageBudget::BudgetPageBudget(QObject* parent)
  */
 BudgetPageBudget::BudgetPageBudget(QObject* parent, int budgetindex)
     : QObject{ parent } {
-    this->budget = 0;
-    this->totalExpenses = 0;
-    this->remainingBudget = 0;
+    this->budget = Money();
+    this->totalExpenses = Money();
+    this->remainingBudget = Money();
     this->budgetIndex = budgetindex;
-    this->budgetGoal = 0;
+    this->budgetGoal = Money();
     this->budgetCategoryNames = new QStringList("Default Category");
     this->budgetCategoryDescriptions = new QStringList("Default Description");
     newExpensescrollArea();
@@ -51,8 +51,8 @@ BudgetPageBudget::BudgetPageBudget(QObject* parent, int budgetindex)
  * @param goal budget goal
  * @param budgetindex the index for the period of the budget (0=yearly, 1-5=quarterly, 6-18=monthly)
  */
-BudgetPageBudget::BudgetPageBudget(QObject* parent, double budget, double totalexpense, double remainingbudget,
-    int budgetindex, double goal)
+BudgetPageBudget::BudgetPageBudget(QObject* parent, Money budget, Money totalexpense, Money remainingbudget,
+    int budgetindex, Money goal)
     : QObject{ parent } {
     this->budget = budget;
     this->totalExpenses = totalexpense;
@@ -74,11 +74,12 @@ BudgetPageBudget::BudgetPageBudget(QObject* parent, double budget, double totale
  */
 BudgetPageBudget::BudgetPageBudget(QObject* parent, const QJsonObject& json) : QObject{ parent } {
     if (!json.isEmpty()) {
-        this->budget = json.value("Budget").toDouble();
-        this->totalExpenses = json.value("Total Expenses").toDouble();
-        this->remainingBudget = json.value("Remaining Budget").toDouble();
+        //amounts are stored as JSON numbers and rounded to whole cents
+        Money::tryFromDouble(json.value("Budget").toDouble(), this->budget);
+        Money::tryFromDouble(json.value("Total Expenses").toDouble(), this->totalExpenses);
+        Money::tryFromDouble(json.value("Remaining Budget").toDouble(), this->remainingBudget);
         this->budgetIndex = json.value("Index").toInt();
-        this->budgetGoal = json.value("Goal").toDouble();
+        Money::tryFromDouble(json.value("Goal").toDouble(), this->budgetGoal);
         this->budgetCategoryNames = new QStringList("Default Category");
         this->budgetCategoryDescriptions = new QStringList("Default Description");
         //splits Expenses into JSON array, then adds them
@@ -89,7 +90,7 @@ BudgetPageBudget::BudgetPageBudget(QObject* parent, const QJsonObject& json) : Q
         newExpensescrollArea();
     }
     else {
-        qDebug() << "empty JSON import-expense";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "empty JSON import-expense";
     }
 }
 
@@ -98,7 +99,7 @@ BudgetPageBudget::BudgetPageBudget(QObject* parent, const QJsonObject& json) : Q
  * @return budget
   * @author Katherine R
  */
-double BudgetPageBudget::getBudget() const {
+Money BudgetPageBudget::getBudget() const {
     return budget;
 }
 
@@ -107,7 +108,7 @@ double BudgetPageBudget::getBudget() const {
  * @return total expenses
   * @author Katherine R
  */
-double BudgetPageBudget::getTotalExpenses() const {
+Money BudgetPageBudget::getTotalExpenses() const {
     return totalExpenses;
 }
 
@@ -116,7 +117,7 @@ double BudgetPageBudget::getTotalExpenses() const {
  * @return remaining budget
   * @author Katherine R
  */
-double BudgetPageBudget::getRemainingBudget() const {
+Money BudgetPageBudget::getRemainingBudget() const {
     return remainingBudget;
 }
 
@@ -134,7 +135,7 @@ QVector<BudgetPageExpenses*>* BudgetPageBudget::getExpenses() {
  * @param newbudget new budget
   * @author Katherine R
  */
-void BudgetPageBudget::setBudget(double newbudget) {
+void BudgetPageBudget::setBudget(Money newbudget) {
     this->budget = newbudget;
 }
 
@@ -143,7 +144,7 @@ void BudgetPageBudget::setBudget(double newbudget) {
  * @param newtotalexpense
   * @author Katherine R
  */
-void BudgetPageBudget::setTotalExpenses(double newtotalexpense) {
+void BudgetPageBudget::setTotalExpenses(Money newtotalexpense) {
     totalExpenses = newtotalexpense;
 }
 
@@ -152,7 +153,7 @@ void BudgetPageBudget::setTotalExpenses(double newtotalexpense) {
  * @param newremainingbudget
   * @author Katherine R
  */
-void BudgetPageBudget::setRemainingBudget(double newremainingbudget) {
+void BudgetPageBudget::setRemainingBudget(Money newremainingbudget) {
     remainingBudget = newremainingbudget;
 }
 
@@ -171,7 +172,7 @@ void BudgetPageBudget::setIndex(int index) {
  * @param delta the change
   * @author Katherine R
  */
-void BudgetPageBudget::changeTotalExpenses(double delta) {
+void BudgetPageBudget::changeTotalExpenses(Money delta) {
     this->totalExpenses += delta;
 }
 
@@ -196,12 +197,12 @@ QJsonObject BudgetPageBudget::to_JSON() {
         expensesArray.append(expense->to_JSON());
     }
     //adds the other variables
-    jsonDoc.insert("Budget", this->budget);
-    jsonDoc.insert("Total Expenses", this->totalExpenses);
-    jsonDoc.insert("Remaining Budget", this->remainingBudget);
+    jsonDoc.insert("Budget", this->budget.toDouble());
+    jsonDoc.insert("Total Expenses", this->totalExpenses.toDouble());
+    jsonDoc.insert("Remaining Budget", this->remainingBudget.toDouble());
     jsonDoc.insert("Expenses", expensesArray); //adds expenses jsonarray
     jsonDoc.insert("Index", this->budgetIndex);
-    jsonDoc.insert("Goal", this->budgetGoal);
+    jsonDoc.insert("Goal", this->budgetGoal.toDouble());
     return jsonDoc;
 }
 
@@ -264,7 +265,7 @@ QVBoxLayout* BudgetPageBudget::getExpensesscrolllistvbox(int index) {
   @author Katherine R
   @return the budget goal
   */
-double BudgetPageBudget::getBudgetGoal() const {
+Money BudgetPageBudget::getBudgetGoal() const {
     return budgetGoal;
 }
 
@@ -273,7 +274,7 @@ double BudgetPageBudget::getBudgetGoal() const {
  * @param newbudgetgoal the new goal
   * @author Katherine R
  */
-void BudgetPageBudget::setBudgetGoal(double newbudgetgoal) {
+void BudgetPageBudget::setBudgetGoal(Money newbudgetgoal) {
     this->budgetGoal = newbudgetgoal;
 }
 
@@ -324,14 +325,14 @@ void BudgetPageBudget::createBudgetPageCSV() {
 
     // Check if user canceled the dialog
     if (fileName.isEmpty()) {
-        qDebug() << "CSV creation canceled by user";
+        NOOMYPLAN_LOG_DEBUG(lcBudget) << "CSV creation canceled by user";
         return;
     }
 
     // Try to open the file for writing
     QFile file(fileName);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error creating file:" << file.errorString();
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "Error creating file:" << file.errorString();
         QMessageBox::critical(nullptr, "Error",
             "Failed to create CSV file: " + file.errorString());
         return;
@@ -344,10 +345,10 @@ void BudgetPageBudget::createBudgetPageCSV() {
     stream << "budget,total expenses,remaining budget,budget goal,budget index,budget period\n";
 
     // Add the variables to the second line
-    stream << this->budget << ","
-        << this->totalExpenses << ","
-        << this->remainingBudget << ","
-        << this->budgetGoal << ","
+    stream << QString::fromStdString(this->budget.toString()) << ","
+        << QString::fromStdString(this->totalExpenses.toString()) << ","
+        << QString::fromStdString(this->remainingBudget.toString()) << ","
+        << QString::fromStdString(this->budgetGoal.toString()) << ","
         << this->budgetIndex << ","
         << getBudgetPeriodString() << "\n";
 
@@ -384,7 +385,7 @@ void BudgetPageBudget::createBudgetPageCSV() {
     QMessageBox::information(nullptr, "Success",
         "CSV file successfully created:\n" + fileName);
 
-    qDebug() << "CSV file created successfully at:" << fileName;
+    NOOMYPLAN_LOG_INFO(lcBudget) << "CSV file created successfully at:" << fileName;
 }
 
 
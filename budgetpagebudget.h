@@ -48,8 +48,8 @@ public:
     * @param goal budget goal
     * @param budgetindex the index for the period of the budget (0=yearly, 1-5=quarterly, 6-18=monthly)
     */
-    BudgetPageBudget(QObject* parent, double budget, double totalexpense, double remainingbudget, int budgetindex,
-        double goal);
+    BudgetPageBudget(QObject* parent, Money budget, Money totalexpense, Money remainingbudget, int budgetindex,
+        Money goal);
 
     /**
     * @brief parametrized constructor - creates a budget object from QJSONobject
@@ -66,21 +66,21 @@ public:
      * @return budget
       * @author Katherine R
      */
-    double getBudget() const;
+    Money getBudget() const;
 
     /**
      * @brief getter for total expenses
      * @return total expenses
       * @author Katherine R
      */
-    double getTotalExpenses() const;
+    Money getTotalExpenses() const;
 
     /**
      *  @brief getter for remaining budgets
      * @return remaining budget
       * @author Katherine R
      */
-    double getRemainingBudget() const;
+    Money getRemainingBudget() const;
 
     /**
      * @brief getter for expenses qvector
@@ -94,21 +94,21 @@ public:
      * @param newbudget new budget
       * @author Katherine R
      */
-    void setBudget(double newbudget);
+    void setBudget(Money newbudget);
 
     /**
      * @brief setter for total expense
      * @param newtotalexpense
       * @author Katherine R
      */
-    void setTotalExpenses(double newtotalexpense);
+    void setTotalExpenses(Money newtotalexpense);
 
     /**
      * @brief setter for remaining budget
      * @param newremainingbudget
       * @author Katherine R
      */
-    void setRemainingBudget(double newremainingbudget);
+    void setRemainingBudget(Money newremainingbudget);
 
     /**
      * @brief setter for index
@@ -123,7 +123,7 @@ public:
      * @param delta the change
       * @author Katherine R
      */
-    void changeTotalExpenses(double delta);
+    void changeTotalExpenses(Money delta);
 
     /**
    * @brief Creates a json object of the budget object
@@ -180,14 +180,14 @@ public:
       @author Katherine R
       @return the budget goal
       */
-    double getBudgetGoal() const;
+    Money getBudgetGoal() const;
 
     /**
      * @brief setter for budget goal
      * @param newbudgetgoal the new goal
       * @author Katherine R
      */
-    void setBudgetGoal(double newbudgetgoal);
+    void setBudgetGoal(Money newbudgetgoal);
 
     /**
      *@brief appends a new scroll area, scroll widget, and scroll list vbox to the vectors, for expenses
@@ -225,11 +225,11 @@ public:
 
 private:
     QVector<BudgetPageExpenses*> expenses; //stores expense items
-    double budget;
-    double totalExpenses;
-    double remainingBudget;
+    Money budget;
+    Money totalExpenses;
+    Money remainingBudget;
     int budgetIndex; // index 0 = yearly 1-5 = Q1-Q4, 6-18 = jan-dec
-    double budgetGoal;
+    Money budgetGoal;
     QStringList* budgetCategoryNames;
     QStringList* budgetCategoryDescriptions;
     QVector<QWidget*> budgetObj_expenseScrollWidget; //vector storing a qwidget per expense category
@@ -11,7 +11,7 @@ BudgetPageExpenses::BudgetPageExpenses(QObject* parent)
     this->expenseName = new QString("");
     this->expenseDescription = new QString("");
     this->quantity = 1;
-    this->price = 1;
+    this->price = Money::fromCents(Money::kScale);
     this->categoryIndex = 0;
     createUIobjects();
 }
@@ -27,8 +27,8 @@ BudgetPageExpenses::BudgetPageExpenses(QObject* parent)
  * @param categoryIndex the index of category
   * @author Katherine R
  */
-BudgetPageExpenses::BudgetPageExpenses(QObject* parent, const QString& name, const QString& description, double price,
-    double quantity, int categoryIndex
+BudgetPageExpenses::BudgetPageExpenses(QObject* parent, const QString& name, const QString& description, Money price,
+    int quantity, int categoryIndex
 ) : QObject{ parent } {
     expenseName = new QString(name);
     expenseDescription = new QString(description);
@@ -53,13 +53,14 @@ BudgetPageExpenses::BudgetPageExpenses(QObject* parent, const QJsonObject& Expen
     if (!Expense.isEmpty()) {
         expenseName = new QString(Expense.value("name").toString());
         expenseDescription = new QString(Expense.value("description").toString());
-        price = Expense.value("price").toDouble();
-        quantity = Expense.value("quantity").toDouble();
+        price = Money();
+        Money::tryFromDouble(Expense.value("price").toDouble(), price);
+        quantity = qRound(Expense.value("quantity").toDouble());
         categoryIndex = Expense.value("Category Index").toInt();
         createUIobjects();
     }
     else {
-        qDebug() << "empty JSON import-expense";
+        NOOMYPLAN_LOG_WARNING(lcBudget) << "empty JSON import-expense";
     }
 }
 
@@ -86,7 +87,7 @@ QJsonObject BudgetPageExpenses::to_JSON() {
     else {
         expenseJson.insert("Description", "\0");
     }
-    expenseJson.insert("Price", QString::number(price));
+    expenseJson.insert("Price", QString::fromStdString(price.toString()));
     expenseJson.insert("Quantity", quantity);
     expenseJson.insert("Category Index", categoryIndex);
     return expenseJson;
@@ -107,9 +108,9 @@ QPushButton* BudgetPageExpenses::getRemoveButton() {
      * @return price * quantity of expense item
       * @author Katherine R
      */
-double BudgetPageExpenses::getExpense() const {
-    if (quantity <= 0 || price < 0) {
-        return 0;
+Money BudgetPageExpenses::getExpense() const {
+    if (quantity <= 0 || price.isNegative()) {
+        return Money();
     }
     return this->price * this->quantity;
 }
@@ -121,9 +122,7 @@ double BudgetPageExpenses::getExpense() const {
     */
 void BudgetPageExpenses::onExpenseNameChangedSlot(const QString& newName) const {
     *expenseName = newName;
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "New Expense Name - " << *this->expenseName;
-    }
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "New Expense Name - " << *this->expenseName;
 }
 
 /**
@@ -133,9 +132,7 @@ void BudgetPageExpenses::onExpenseNameChangedSlot(const QString& newName) const
    */
 void BudgetPageExpenses::onExpenseDescriptionChangedSlot(const QString& newDescription) const {
     *expenseDescription = newDescription;
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << *this->expenseName << " - New Expense Description - " << *this->expenseDescription;
-    }
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << *this->expenseName << " - New Expense Description - " << *this->expenseDescription;
 }
 
 /**
@@ -145,25 +142,23 @@ void BudgetPageExpenses::onExpenseDescriptionChangedSlot(const QString& newDescr
      * @author Katherine R
      */
 void BudgetPageExpenses::expenseSBChangedSlot(double change, char changedType) {
-    double oldExpenses = this->quantity * this->price;
+    Money oldExpenses = this->price * this->quantity;
     //determines the type that was changed (price or quantity)
     switch (changedType) {
     case 'Q': //if quantity
-        this->quantity = change;
+        this->quantity = qRound(change);
         break;
-    case 'P': //if price
-        this->price = change;
+    case 'P': //if price, rounded to whole cents
+        Money::tryFromDouble(change, this->price);
         break;
     default:
         break;
     }
 
-    if (SHOW_DEBUG_LOGS) {
-        qDebug() << "Expense " << *this->expenseName << " changed by - " << (this->quantity * this->price) -
-            oldExpenses;
-    }
+    Money delta = this->price * this->quantity - oldExpenses;
+    NOOMYPLAN_LOG_DEBUG(lcBudget) << "Expense " << *this->expenseName << " changed by - " << QString::fromStdString(delta.toString());
 
-    emit expenseChangedSignal((this->quantity * this->price) - oldExpenses);
+    emit expenseChangedSignal(delta);
 }
 
 /**
@@ -198,7 +193,7 @@ void BudgetPageExpenses::createExpenseUI(QVBoxLayout* vbox) {
     expenseObj_NameLineEdit->setText(*this->expenseName);
     expenseObj_DescriptionLineEdit->setText(*this->expenseDescription);
     expenseObj_QuantitySpinBox->setValue(this->quantity);
-    expenseObj_PriceSpinBox->setValue(this->price);
+    expenseObj_PriceSpinBox->setValue(this->price.toDouble());
 
     //connects spin boxes to the expenseChanged slot - with a char to denote if it's the quantity or price
     connect(expenseObj_QuantitySpinBox, &QDoubleSpinBox::valueChanged, this,
@@ -257,7 +252,7 @@ QString BudgetPageExpenses::to_CSV() {
     csv.append(",");
     csv.append(std::to_string(this->quantity));
     csv.append(",");
-    csv.append(std::to_string(this->price));
+    csv.append(this->price.toString());
     csv.append(",");
     csv.append(std::to_string(this->categoryIndex));
     return csv;
@@ -283,15 +278,15 @@ void BudgetPageExpenses::setExpenseDescription(QString description) {
  * @brief setter for price
  * @param price the price
  */
-void BudgetPageExpenses::setExpensePrice(double price) {
+void BudgetPageExpenses::setExpensePrice(Money price) {
     this->price = price;
-    this->expenseObj_PriceSpinBox->setValue(this->price);
+    this->expenseObj_PriceSpinBox->setValue(this->price.toDouble());
 }
 /**
  * @brief setter for quantity
  * @param quantity the quantity
  */
-void BudgetPageExpenses::setExpenseQuantity(double quantity) {
+void BudgetPageExpenses::setExpenseQuantity(int quantity) {
     this->quantity = quantity;
     this->expenseObj_QuantitySpinBox->setValue(this->quantity);
 }
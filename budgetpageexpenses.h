@@ -10,8 +10,8 @@
 #include<QMainWindow>
 #include<QComboBox>
 #include<QJsonObject>
-
-#define SHOW_DEBUG_LOGS true
+#include "money.h"
+#include "logging.h"
 
 /**
 * this class stores information for a single expense item
@@ -42,7 +42,7 @@ public:
      * @param categoryIndex the index of category
       * @author Katherine R
      */
-    BudgetPageExpenses(QObject* parent, const QString& name, const QString& description, double price, double quantity,
+    BudgetPageExpenses(QObject* parent, const QString& name, const QString& description, Money price, int quantity,
         int categoryIndex);
 
     /**
@@ -80,7 +80,7 @@ public:
      * @return price * quantity of expense item
       * @author Katherine R
      */
-    double getExpense() const;
+    Money getExpense() const;
 
     /**
      * @brief Creates the UI for the expense item
@@ -126,13 +126,13 @@ public:
  * @brief setter for price
  * @param price the price
  */
-    void setExpensePrice(double price);
+    void setExpensePrice(Money price);
 
     /**
  * @brief setter for quantity
  * @param quantity the quantity
  */
-    void setExpenseQuantity(double quantity);
+    void setExpenseQuantity(int quantity);
 
     /**
     * @brief setter for categoryindex
@@ -141,7 +141,7 @@ public:
     void setCategoryindex(int categoryindex);
 
 signals:
-    void expenseChangedSignal(double delta);
+    void expenseChangedSignal(Money delta);
 
 public slots:
     /**
@@ -167,8 +167,8 @@ public slots:
     void onExpenseNameChangedSlot(const QString& newName) const;
 
 private:
-    double price;
-    double quantity;
+    Money price;
+    int quantity; // whole items; the quantity spinbox has no decimals
     int categoryIndex;
 
 private:
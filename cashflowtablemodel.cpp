@@ -0,0 +1,211 @@
+#include "cashflowtablemodel.h"
+#include "tracing.h"
+#include <algorithm>
+#include <QRegularExpression>
+
+/**
+ * @class cashflowtablemodel.cpp
+ * @brief Implements the CashflowTableModel that backs the cashflow transaction table.
+ *
+ * @author Abbygail Latimer
+ */
+
+CashflowTableModel::CashflowTableModel(CashflowTracking& ledger, QObject* parent)
+    : QAbstractTableModel(parent), ledger(ledger) {
+    reload();
+}
+
+int CashflowTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rowIds.size());
+}
+
+int CashflowTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/**
+ * @brief Formats one cell straight from the ledger.
+ * @param index Cell to format.
+ * @param role Requested role; only display/edit text and alignment are provided.
+ * @return The cell's value, or an invalid QVariant.
+ */
+QVariant CashflowTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(rowIds.size())) {
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        if (index.column() == IdColumn || index.column() == CostColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return QVariant();
+    }
+    if (role != Qt::DisplayRole && role != Qt::EditRole) {
+        return QVariant();
+    }
+
+    const DataEntry* entry = ledger.searchDataEntries(rowIds[index.row()]);
+    if (!entry) {
+        return QVariant();
+    }
+    NOOMYPLAN_TRACE_COUNT("table.cellsFormatted", 1);
+
+    switch (index.column()) {
+    case IdColumn: return entry->transid;
+    case DateTimeColumn: return QString::fromStdString(entry->dateTime);
+    case SellerColumn: return QString::fromStdString(ledger.text(entry->seller));
+    case BuyerColumn: return QString::fromStdString(ledger.text(entry->buyer));
+    case MerchandiseColumn: return QString::fromStdString(entry->merchandise);
+    case CostColumn: return QString::fromStdString(entry->cost.toString()); // Formatted to 2 decimal places
+    case CurrencyColumn: return QString::fromStdString(ledger.text(entry->currency));
+    case CategoryColumn: return QString::fromStdString(ledger.text(entry->category));
+    default: return QVariant();
+    }
+}
+
+QVariant CashflowTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case IdColumn: return QStringLiteral("ID");
+    case DateTimeColumn: return QStringLiteral("Date/Time");
+    case SellerColumn: return QStringLiteral("Seller");
+    case BuyerColumn: return QStringLiteral("Buyer");
+    case MerchandiseColumn: return QStringLiteral("Merchandise");
+    case CostColumn: return QStringLiteral("Cost");
+    case CurrencyColumn: return QStringLiteral("Currency");
+    case CategoryColumn: return QStringLiteral("Category");
+    default: return QVariant();
+    }
+}
+
+Qt::ItemFlags CashflowTableModel::flags(const QModelIndex& index) const {
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() != IdColumn) {
+        itemFlags |= Qt::ItemIsEditable; // IDs are assigned by the ledger
+    }
+    return itemFlags;
+}
+
+/**
+ * @brief Validates an edited cell and writes just that field to the ledger.
+ * @param index Edited cell.
+ * @param value New cell text.
+ * @param role Must be Qt::EditRole.
+ * @return True if the ledger was updated.
+ */
+bool CashflowTableModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (role != Qt::EditRole || !index.isValid() || index.row() >= static_cast<int>(rowIds.size())) {
+        return false;
+    }
+
+    QString text = value.toString().trimmed();
+    if (text.isEmpty()) {
+        return false;
+    }
+
+    CashflowTracking::Field field;
+    switch (index.column()) {
+    case DateTimeColumn: {
+        static const QRegularExpression dateTimeFormat("^\\d{4}-\\d{2}-\\d{2}, \\d{2}:\\d{2}$");
+        if (!dateTimeFormat.match(text).hasMatch() ||
+            CashflowTracking::parseTimestamp(text.toStdString()) == CashflowTracking::kNoTimestamp) {
+            return false;
+        }
+        field = CashflowTracking::Field::DateTime;
+        break;
+    }
+    case SellerColumn: field = CashflowTracking::Field::Seller; break;
+    case BuyerColumn: field = CashflowTracking::Field::Buyer; break;
+    case MerchandiseColumn: field = CashflowTracking::Field::Merchandise; break;
+    case CostColumn: {
+        Money cost; // Accepts "$" and grouping commas
+        if (!Money::parse(text.toStdString(), cost) || cost <= Money()) {
+            return false;
+        }
+        text = QString::fromStdString(cost.toString()); // Unambiguous for the ledger's parser
+        field = CashflowTracking::Field::Cost;
+        break;
+    }
+    case CurrencyColumn: field = CashflowTracking::Field::Currency; break;
+    case CategoryColumn: field = CashflowTracking::Field::Category; break;
+    default: return false;
+    }
+
+    if (!ledger.updateEntry(rowIds[index.row()], field, text.toStdString())) {
+        return false;
+    }
+    emit dataChanged(index, index, { Qt::DisplayRole, Qt::EditRole });
+    return true;
+}
+
+/**
+ * @brief Rebuilds every row from the ledger.
+ */
+void CashflowTableModel::reload() {
+    NOOMYPLAN_TRACE_SCOPE("table.refresh");
+    beginResetModel();
+    rowIds.clear();
+    rowIds.reserve(ledger.dataEntryCount());
+    ledger.forEachDataEntry([this](const DataEntry& entry) {
+        rowIds.push_back(entry.transid);
+        });
+    if (!std::is_sorted(rowIds.begin(), rowIds.end())) {
+        std::sort(rowIds.begin(), rowIds.end());
+    }
+    endResetModel();
+}
+
+/**
+ * @brief Adds the row of a transaction that was just added to the ledger.
+ * @param transID ID of the new transaction.
+ *
+ * New IDs are the largest so far, so this is normally an append.
+ */
+void CashflowTableModel::transactionAdded(int transID) {
+    NOOMYPLAN_TRACE_SCOPE("table.insertRow");
+    auto position = std::lower_bound(rowIds.begin(), rowIds.end(), transID);
+    if (position != rowIds.end() && *position == transID) {
+        return; // Already shown
+    }
+
+    const int row = static_cast<int>(position - rowIds.begin());
+    beginInsertRows(QModelIndex(), row, row);
+    rowIds.insert(position, transID);
+    endInsertRows();
+}
+
+/**
+ * @brief Removes the row of a transaction that was just deleted from the ledger.
+ * @param transID ID of the deleted transaction.
+ */
+void CashflowTableModel::transactionRemoved(int transID) {
+    NOOMYPLAN_TRACE_SCOPE("table.removeRow");
+    const int row = rowOf(transID);
+    if (row < 0) {
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), row, row);
+    rowIds.erase(rowIds.begin() + row);
+    endRemoveRows();
+}
+
+int CashflowTableModel::transactionIdAt(int row) const {
+    return row >= 0 && row < static_cast<int>(rowIds.size()) ? rowIds[row] : 0;
+}
+
+/**
+ * @brief Returns the row showing a transaction.
+ * @param transID ID of the transaction.
+ * @return The row, or -1 if the transaction is not shown.
+ */
+int CashflowTableModel::rowOf(int transID) const {
+    auto position = std::lower_bound(rowIds.begin(), rowIds.end(), transID);
+    if (position == rowIds.end() || *position != transID) {
+        return -1;
+    }
+    return static_cast<int>(position - rowIds.begin());
+}
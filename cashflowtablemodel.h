@@ -0,0 +1,95 @@
+#ifndef CASHFLOWTABLEMODEL_H
+#define CASHFLOWTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <vector>
+#include "cashflowtracking.h"
+
+/**
+ * @class CashflowTableModel
+ * @brief Table model that shows the transactions stored in a CashflowTracking ledger.
+ *
+ * The model only keeps the ID of the transaction on each row; cell text is formatted
+ * from the ledger when the view asks for it, so only visible rows cost anything.
+ * Rows are in insertion order, which is ascending ID order, so a transaction's row
+ * is found by binary search. The owner reports changes with transactionAdded() and
+ * transactionRemoved() so the view is updated row by row instead of being reset.
+ * Edited cells are validated and written back with CashflowTracking::updateEntry(),
+ * so an edit only touches, and journals, that one field.
+ *
+ * @author Abbygail Latimer
+ */
+class CashflowTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Columns shown for each transaction.
+     */
+    enum Column {
+        IdColumn,
+        DateTimeColumn,
+        SellerColumn,
+        BuyerColumn,
+        MerchandiseColumn,
+        CostColumn,
+        CurrencyColumn,
+        CategoryColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Creates a model over a ledger.
+     * @param ledger Ledger to display and edit; must outlive the model.
+     * @param parent Parent QObject (default nullptr).
+     */
+    explicit CashflowTableModel(CashflowTracking& ledger, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * @brief Validates an edited cell and writes it to the ledger.
+     * @return False if the value is rejected; the cell then keeps its old value.
+     *
+     * Uses the same rules as adding a transaction: no empty fields, a positive cost
+     * and a "yyyy-mm-dd, hh:mm" date.
+     */
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    /**
+     * @brief Rebuilds every row from the ledger, e.g. after it was loaded or cleared.
+     */
+    void reload();
+
+    /**
+     * @brief Adds the row of a transaction that was just added to the ledger.
+     * @param transID ID of the new transaction.
+     */
+    void transactionAdded(int transID);
+
+    /**
+     * @brief Removes the row of a transaction that was just deleted from the ledger.
+     * @param transID ID of the deleted transaction.
+     */
+    void transactionRemoved(int transID);
+
+    /**
+     * @brief Returns the ID of the transaction shown on a row, or 0 if the row is out of range.
+     */
+    int transactionIdAt(int row) const;
+
+    /**
+     * @brief Returns the row showing a transaction, or -1 if it is not shown.
+     */
+    int rowOf(int transID) const;
+
+private:
+    CashflowTracking& ledger;        // Ledger the rows are read from and edits are written to
+    std::vector<int> rowIds;         // Transaction ID shown on each row, ascending
+};
+
+#endif // CASHFLOWTABLEMODEL_H
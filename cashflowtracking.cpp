@@ -1,7 +1,14 @@
 #include "cashflowtracking.h"
+#include "mappedfile.h"
+#include "tracing.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 
 /**
  * @class cashflowtracking.cpp
@@ -15,6 +22,204 @@
  * @author Abbygail Latimer
  */
 
+namespace {
+
+// On-disk layout of the ledger file written by saveDataToFile()
+const char kLedgerMagic[8] = { 'N', 'P', 'L', 'E', 'D', 'G', 'E', 'R' };
+const uint32_t kLedgerFormatVersion = 4;   // 2 added journalSequence, 3 added LedgerRecord::timestamp, 4 stores cost in cents
+const uint32_t kOldestLedgerFormatVersion = 1;
+const uint32_t kLedgerByteOrderMark = 0x01020304; // Reads back differently on a host with another byte order
+
+#pragma pack(push, 1)
+struct LedgerFileHeader {
+    char magic[8];          // kLedgerMagic
+    uint32_t version;       // kLedgerFormatVersion
+    uint32_t byteOrderMark; // kLedgerByteOrderMark as written by the saving host
+    int32_t dataCounter;    // Next transaction ID to hand out
+    uint32_t recordSize;    // sizeof(LedgerRecord), guards against layout changes
+    uint64_t recordCount;   // Number of records in the record table
+    uint64_t heapSize;      // Size of the string heap in bytes
+    uint64_t checksum;      // ledgerChecksum() of the record table and string heap
+    uint64_t journalSequence; // Last journal record folded into this snapshot (zero in version 1)
+    uint8_t reserved[8];    // Zero; keeps the header at 64 bytes
+};
+
+struct LedgerStringRef {
+    uint32_t offset;        // Byte offset into the string heap
+    uint32_t length;        // Length of the string in bytes
+};
+
+struct LedgerRecord {
+    int32_t transid;
+    int32_t timestamp;      // DataEntry::timestamp (version 3; zero before)
+    int64_t cost;           // Cost in cents (version 4; the bits of a double before)
+    LedgerStringRef dateTime;
+    LedgerStringRef seller;
+    LedgerStringRef buyer;
+    LedgerStringRef merchandise;
+    LedgerStringRef currency;
+    LedgerStringRef category;
+};
+// On-disk layout of the journal appended to by every change
+const char kJournalMagic[8] = { 'N', 'P', 'J', 'O', 'U', 'R', 'N', 'L' };
+const uint32_t kJournalFormatVersion = 2;   // 2 stores costs in cents
+const uint32_t kOldestJournalFormatVersion = 1;
+
+struct JournalFileHeader {
+    char magic[8];          // kJournalMagic
+    uint32_t version;       // kJournalFormatVersion
+    uint32_t byteOrderMark; // kLedgerByteOrderMark as written by the saving host
+};
+
+// Each record is a JournalRecordHeader followed by payloadSize bytes of payload:
+// uint64 sequence, uint8 operation, then the operation's fields
+struct JournalRecordHeader {
+    uint32_t payloadSize;
+    uint32_t checksum;      // Low 32 bits of ledgerChecksum() of the payload
+};
+#pragma pack(pop)
+
+enum JournalOperation : uint8_t {
+    JournalAdd = 1,         // int32 transid, int64 cost in cents, six length-prefixed strings
+    JournalDelete = 2,      // int32 transid
+    JournalClear = 3,       // No fields
+    JournalEdit = 4         // int32 transid, uint8 CashflowTracking::Field, then int64 cents for Cost or a length-prefixed string
+};
+
+// Journals shorter than this are never compacted, however small the ledger is
+const size_t kMinJournalRecordsBeforeCompaction = 1024;
+
+static_assert(sizeof(LedgerFileHeader) == 64, "ledger header must stay 64 bytes");
+static_assert(sizeof(LedgerRecord) == 64, "ledger record must stay 64 bytes");
+
+/**
+ * @brief Checksums a block of bytes eight at a time.
+ *
+ * A 64-bit multiply-xorshift hash: cheap enough to run over a whole ledger on
+ * every load while still catching truncation and corruption.
+ */
+uint64_t ledgerChecksum(const char* data, size_t size) {
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash ^ (hash >> 32);
+}
+
+template <typename T>
+void appendValue(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& buffer, const std::string& text) {
+    appendValue(buffer, static_cast<uint32_t>(text.size()));
+    buffer += text;
+}
+
+/**
+ * @brief Reads fields back out of a journal payload, failing instead of overrunning it.
+ */
+struct JournalReader {
+    const char* cursor;
+    const char* end;
+    uint32_t formatVersion; // Version of the journal file the payload comes from
+
+    bool readCost(Money& cost) {
+        if (formatVersion >= 2) {
+            int64_t cents = 0;
+            if (!read(cents)) return false;
+            cost = Money::fromCents(cents);
+            return true;
+        }
+        double amount = 0.0;
+        return read(amount) && Money::tryFromDouble(amount, cost);
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        if (static_cast<size_t>(end - cursor) < sizeof(value)) return false;
+        std::memcpy(&value, cursor, sizeof(value));
+        cursor += sizeof(value);
+        return true;
+    }
+
+    bool readString(std::string_view& text) {
+        uint32_t length = 0;
+        if (!read(length) || static_cast<size_t>(end - cursor) < length) return false;
+        text = std::string_view(cursor, length);
+        cursor += length;
+        return true;
+    }
+
+    bool readString(std::string& text) {
+        std::string_view view;
+        if (!readString(view)) return false;
+        text.assign(view.data(), view.size());
+        return true;
+    }
+};
+
+/**
+ * @brief Writes a buffer to a temporary file and renames it over path.
+ *
+ * A crash mid-write leaves the previous file untouched.
+ */
+bool writeFileAtomically(const std::string& path, const std::vector<char>& buffer) {
+    const std::string tempPath = path + ".tmp";
+    std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << tempPath << std::endl;
+        return false;
+    }
+    outFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    outFile.close();
+    if (!outFile) {
+        std::cerr << "Error: Could not write file: " << tempPath << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Error: Could not replace " << path << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Waits for a running background snapshot and closes the journal.
+ */
+CashflowTracking::~CashflowTracking() {
+    finishCompaction();
+    journalStream.close();
+    if (journalBroken) {
+        saveDataToFile(); // Last chance for changes the journal could not take
+    }
+}
+
+/**
+ * @brief Switches to another ledger file and loads it.
+ * @param filePath Path to the snapshot file.
+ * @return True if any data was loaded.
+ */
+bool CashflowTracking::open(const std::string& filePath) {
+    finishCompaction();
+    journalStream.close();
+    dataFilePath = filePath;
+    return loadDataFromFile();
+}
+
  /**
   * @brief Adds a new transaction record to the system.
   * @param dateTime Date and time of the transaction.
@@ -24,14 +229,98 @@
   * @param cost Cost of the transaction.
   * @param currency Currency the cost is in
   * @param category Category to store transaction under.
+  * @return The ID assigned to the new transaction.
   */
-void CashflowTracking::addData(const std::string& dateTime, const std::string& seller,
+int CashflowTracking::addData(const std::string& dateTime, const std::string& seller,
     const std::string& buyer, const std::string& merchandise,
-    double cost, const std::string& currency, const std::string& category) {
+    Money cost, const std::string& currency, const std::string& category) {
     // Create a new DataEntry object and add it to the dataEntries vector
-    DataEntry data = { dataCounter++, dateTime, seller, buyer, merchandise, cost, currency, category };
-    dataEntries.push_back(data);
-    categories[category].push_back(data.transid); // Add the transaction ID to the category's list
+    DataEntry data = { dataCounter++, parseTimestamp(dateTime), dateTime, dictionary.intern(seller), dictionary.intern(buyer), merchandise,
+        cost, dictionary.intern(currency), dictionary.intern(category) };
+
+    // Journal the entry before it becomes visible
+    std::string body;
+    body.reserve(sizeof(int32_t) + sizeof(int64_t) + 6 * sizeof(uint32_t) + dateTime.size() + seller.size() +
+        buyer.size() + merchandise.size() + currency.size() + category.size());
+    appendValue(body, static_cast<int32_t>(data.transid));
+    appendValue(body, data.cost.cents());
+    appendString(body, dateTime);
+    appendString(body, seller);
+    appendString(body, buyer);
+    appendString(body, merchandise);
+    appendString(body, currency);
+    appendString(body, category);
+    appendJournalRecord(JournalAdd, body);
+
+    const int transID = data.transid;
+    insertEntry(std::move(data));
+    compactJournalIfNeeded();
+    return transID;
+}
+
+/**
+ * @brief Appends an entry that already has its ID and indexes it.
+ * @param entry The transaction to store.
+ * @param keepIndexSorted False to append postings unsorted during a bulk load.
+ */
+void CashflowTracking::insertEntry(DataEntry&& entry, bool keepIndexSorted) {
+    const size_t id = static_cast<size_t>(entry.transid);
+    if (id >= idIndex.size()) {
+        idIndex.resize(std::max(id + 1, idIndex.size() * 2), kNoSlot);
+    }
+    idIndex[id] = dataEntries.size(); // Remember the slot the entry is stored in
+    ++liveEntries;
+
+    // Add the transaction to the date index and its category's postings
+    const DatePosting posting = { entry.timestamp, entry.transid };
+    std::vector<DatePosting>& categoryPostings = categories[entry.category];
+    if (keepIndexSorted) {
+        insertPosting(dateIndex, posting);
+        insertPosting(categoryPostings, posting);
+    }
+    else {
+        dateIndex.push_back(posting);
+        categoryPostings.push_back(posting);
+    }
+    dataEntries.push_back(std::move(entry));
+}
+
+/**
+ * @brief Inserts a posting into a date-sorted list.
+ *
+ * Transactions are usually entered in date order, so the common case is an append.
+ */
+void CashflowTracking::insertPosting(std::vector<DatePosting>& postings, const DatePosting& posting) {
+    if (postings.empty() || postings.back() < posting) {
+        postings.push_back(posting);
+    }
+    else {
+        postings.insert(std::upper_bound(postings.begin(), postings.end(), posting), posting);
+    }
+}
+
+/**
+ * @brief Removes a posting from a date-sorted list by binary search.
+ */
+void CashflowTracking::erasePosting(std::vector<DatePosting>& postings, const DatePosting& posting) {
+    auto position = std::lower_bound(postings.begin(), postings.end(), posting);
+    if (position != postings.end() && position->timestamp == posting.timestamp && position->transid == posting.transid) {
+        postings.erase(position);
+    }
+}
+
+/**
+ * @brief Sorts the date index and category postings once a bulk load has appended them.
+ */
+void CashflowTracking::sortDateIndexes() {
+    if (!std::is_sorted(dateIndex.begin(), dateIndex.end())) {
+        std::sort(dateIndex.begin(), dateIndex.end());
+    }
+    for (auto& category : categories) {
+        if (!std::is_sorted(category.second.begin(), category.second.end())) {
+            std::sort(category.second.begin(), category.second.end());
+        }
+    }
 }
 
 /**
@@ -39,13 +328,24 @@ void CashflowTracking::addData(const std::string& dateTime, const std::string& s
  * @param transID Unique transaction ID to search for.
  * @return Pointer to the found DataEntry, or nullptr if not found.
  */
-DataEntry* CashflowTracking::searchDataEntries(int transID) {
-    for (auto& data : dataEntries) {
-        if (data.transid == transID) { // Check if the current entry matches the transaction ID
-            return &data; // Return a pointer to the matching entry
-        }
+const DataEntry* CashflowTracking::searchDataEntries(int transID) const {
+    size_t slot = slotOf(transID);
+    if (slot == kNoSlot) {
+        return nullptr; // Return nullptr if no matching entry is found
+    }
+    return &dataEntries[slot]; // Return a pointer to the matching entry
+}
+
+/**
+ * @brief Returns the slot of a transaction in dataEntries.
+ * @param transID Unique transaction ID to look up.
+ * @return The slot, or kNoSlot if no entry with that ID is stored.
+ */
+size_t CashflowTracking::slotOf(int transID) const {
+    if (transID <= 0 || static_cast<size_t>(transID) >= idIndex.size()) {
+        return kNoSlot;
     }
-    return nullptr; // Return nullptr if no matching entry is found
+    return idIndex[static_cast<size_t>(transID)];
 }
 
 /**
@@ -53,11 +353,12 @@ DataEntry* CashflowTracking::searchDataEntries(int transID) {
  */
 void CashflowTracking::listDataEntries() {
     for (const auto& data : dataEntries) {
+        if (data.transid == 0) continue; // Skip deleted slots
         // Print details of each transaction in the dataEntries vector
         std::cout << "ID: " << data.transid << ", Date/Time: " << data.dateTime
-            << ", Buyer: " << data.buyer << ", Seller: " << data.seller
+            << ", Buyer: " << text(data.buyer) << ", Seller: " << text(data.seller)
             << ", Merchandise: " << data.merchandise << ", Cost: " << data.cost
-            << ", Currency: " << data.currency << ", Category: " << data.category << "\n";
+            << ", Currency: " << text(data.currency) << ", Category: " << text(data.category) << "\n";
     }
 }
 
@@ -66,7 +367,227 @@ void CashflowTracking::listDataEntries() {
  * @return A vector containing all DataEntry objects.
  */
 std::vector<DataEntry> CashflowTracking::getAllDataEntries() {
-    return dataEntries;
+    std::vector<DataEntry> entries;
+    entries.reserve(liveEntries);
+    for (const auto& data : dataEntries) {
+        if (data.transid != 0) entries.push_back(data); // Skip deleted slots
+    }
+    return entries;
+}
+
+/**
+ * @brief Returns the number of stored transactions.
+ * @return The number of live transaction records.
+ */
+size_t CashflowTracking::dataEntryCount() const {
+    return liveEntries;
+}
+
+/**
+ * @brief Returns the text of a seller, buyer, currency or category symbol.
+ * @param symbol Symbol taken from a DataEntry.
+ * @return The text the symbol stands for.
+ */
+const std::string& CashflowTracking::text(StringDictionary::Symbol symbol) const {
+    return dictionary.text(symbol);
+}
+
+/**
+ * @brief Looks up the symbol of a seller, buyer, currency or category.
+ * @param text Exact text to look up.
+ * @return The symbol, or StringDictionary::kNoSymbol if it is unknown.
+ */
+StringDictionary::Symbol CashflowTracking::findSymbol(const std::string& text) const {
+    return dictionary.find(text);
+}
+
+/**
+ * @brief Returns every symbol whose text equals the given text, ignoring case.
+ *
+ * The dictionary only holds a few dozen distinct names, so scanning it once per
+ * query is cheaper than comparing text on every row.
+ */
+std::vector<StringDictionary::Symbol> CashflowTracking::symbolsMatching(const std::string& text) const {
+    std::vector<StringDictionary::Symbol> matches;
+    if (text.empty()) return matches;
+    for (size_t symbol = 0; symbol < dictionary.size(); ++symbol) {
+        if (categoryMatches(dictionary.text(static_cast<StringDictionary::Symbol>(symbol)), text)) {
+            matches.push_back(static_cast<StringDictionary::Symbol>(symbol));
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Converts a calendar date and time to minutes since 1970-01-01 00:00.
+ * @param year Four-digit year.
+ * @param month Month, 1-12.
+ * @param day Day of the month.
+ * @param hour Hour, 0-23.
+ * @param minute Minute, 0-59.
+ * @return The timestamp, or kNoTimestamp if the date is invalid or does not fit in 32 bits.
+ *
+ * Dates carry no time zone, so the timestamp is simply a serial number that
+ * orders them correctly.
+ */
+int32_t CashflowTracking::makeTimestamp(int year, int month, int day, int hour, int minute) {
+    static const int daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12 || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        return kNoTimestamp;
+    }
+    const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    const int monthLength = daysInMonth[month - 1] + (month == 2 && leapYear ? 1 : 0);
+    if (day < 1 || day > monthLength) {
+        return kNoTimestamp;
+    }
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar, counting years from March
+    const int64_t y = month <= 2 ? year - 1 : year;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yearOfEra = y - era * 400;
+    const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    const int64_t days = era * 146097 + dayOfEra - 719468;
+
+    const int64_t minutes = days * 24 * 60 + hour * 60 + minute;
+    if (minutes <= std::numeric_limits<int32_t>::min() || minutes > std::numeric_limits<int32_t>::max()) {
+        return kNoTimestamp;
+    }
+    return static_cast<int32_t>(minutes);
+}
+
+/**
+ * @brief Parses a "yyyy-mm-dd, hh:mm" or "yyyy-mm-dd" date into minutes since 1970-01-01 00:00.
+ * @param dateTime Text to parse.
+ * @return The timestamp, or kNoTimestamp if the text is not a valid date.
+ *
+ * Reads the digits by position instead of going through a date library, so it is
+ * cheap enough to run for every row while loading.
+ */
+int32_t CashflowTracking::parseTimestamp(const std::string& dateTime) {
+    auto number = [&dateTime](size_t position, size_t digits, int& value) {
+        value = 0;
+        for (size_t i = position; i < position + digits; ++i) {
+            if (i >= dateTime.size() || dateTime[i] < '0' || dateTime[i] > '9') return false;
+            value = value * 10 + (dateTime[i] - '0');
+        }
+        return true;
+    };
+
+    int year, month, day;
+    if (!number(0, 4, year) || dateTime.size() < 10 || dateTime[4] != '-' || dateTime[7] != '-' ||
+        !number(5, 2, month) || !number(8, 2, day)) {
+        return kNoTimestamp;
+    }
+    if (dateTime.size() == 10) {
+        return makeTimestamp(year, month, day);
+    }
+
+    // "yyyy-mm-dd, hh:mm"
+    int hour, minute;
+    if (dateTime.size() != 17 || dateTime[10] != ',' || dateTime[11] != ' ' || dateTime[14] != ':' ||
+        !number(12, 2, hour) || !number(15, 2, minute)) {
+        return kNoTimestamp;
+    }
+    return makeTimestamp(year, month, day, hour, minute);
+}
+
+/**
+ * @brief Compares two category names, ignoring case.
+ */
+bool CashflowTracking::categoryMatches(const std::string& category, const std::string& filter) {
+    return category.size() == filter.size() &&
+        std::equal(category.begin(), category.end(), filter.begin(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+}
+
+/**
+ * @brief Changes one field of a stored transaction.
+ * @param transID Unique transaction ID to update.
+ * @param field Field to change.
+ * @param value New text of the field, or the new cost as a decimal number.
+ * @return False if the ID is unknown or the cost cannot be read.
+ */
+bool CashflowTracking::updateEntry(int transID, Field field, const std::string& value) {
+    const size_t slot = slotOf(transID);
+    if (slot == kNoSlot) return false;
+
+    Money cost;
+    if (field == Field::Cost && !Money::parse(value, cost)) {
+        return false;
+    }
+
+    // Journal only the changed field
+    std::string body;
+    appendValue(body, static_cast<int32_t>(transID));
+    appendValue(body, static_cast<uint8_t>(field));
+    if (field == Field::Cost) {
+        appendValue(body, cost.cents());
+    }
+    else {
+        appendString(body, value);
+    }
+    appendJournalRecord(JournalEdit, body);
+
+    applyFieldUpdate(slot, field, value, cost);
+    compactJournalIfNeeded();
+    return true;
+}
+
+/**
+ * @brief Sets one field of a stored entry and keeps the date index and categories in step.
+ * @param slot Slot of the entry in dataEntries.
+ * @param field Field to change.
+ * @param text New text, for every field but Field::Cost.
+ * @param cost New cost, for Field::Cost.
+ */
+void CashflowTracking::applyFieldUpdate(size_t slot, Field field, std::string_view text, Money cost) {
+    DataEntry& entry = dataEntries[slot];
+    switch (field) {
+    case Field::DateTime: {
+        const int32_t timestamp = parseTimestamp(std::string(text));
+        if (timestamp != entry.timestamp) {
+            // Re-sort the transaction under its new date
+            const DatePosting oldPosting = { entry.timestamp, entry.transid };
+            const DatePosting newPosting = { timestamp, entry.transid };
+            std::vector<DatePosting>& categoryPostings = categories[entry.category];
+            erasePosting(dateIndex, oldPosting);
+            insertPosting(dateIndex, newPosting);
+            erasePosting(categoryPostings, oldPosting);
+            insertPosting(categoryPostings, newPosting);
+            entry.timestamp = timestamp;
+        }
+        entry.dateTime.assign(text.data(), text.size());
+        break;
+    }
+    case Field::Seller:
+        entry.seller = dictionary.intern(text);
+        break;
+    case Field::Buyer:
+        entry.buyer = dictionary.intern(text);
+        break;
+    case Field::Merchandise:
+        entry.merchandise.assign(text.data(), text.size());
+        break;
+    case Field::Cost:
+        entry.cost = cost;
+        break;
+    case Field::Currency:
+        entry.currency = dictionary.intern(text);
+        break;
+    case Field::Category: {
+        const StringDictionary::Symbol category = dictionary.intern(text);
+        if (category != entry.category) {
+            // Move the transaction to the new category's postings
+            const DatePosting posting = { entry.timestamp, entry.transid };
+            erasePosting(categories[entry.category], posting);
+            insertPosting(categories[category], posting);
+            entry.category = category;
+        }
+        break;
+    }
+    }
 }
 
 /**
@@ -74,17 +595,63 @@ std::vector<DataEntry> CashflowTracking::getAllDataEntries() {
  * @param transID Unique transaction ID to remove.
  */
 void CashflowTracking::deleteData(int transID) {
-    for (auto it = dataEntries.begin(); it != dataEntries.end(); ++it) {
-        if (it->transid == transID) {
-            // Remove the transaction ID from its category
-            categories[it->category].erase(
-                std::remove(categories[it->category].begin(), categories[it->category].end(), transID),
-                categories[it->category].end()
-            );
-            // Remove the transaction from dataEntries
-            dataEntries.erase(it);
-            return;
-        }
+    size_t slot = slotOf(transID);
+    if (slot == kNoSlot) return;
+
+    std::string body;
+    appendValue(body, static_cast<int32_t>(transID));
+    appendJournalRecord(JournalDelete, body);
+
+    removeEntry(slot);
+    compactJournalIfNeeded();
+}
+
+/**
+ * @brief Removes a stored entry from the ID index.
+ * @param slot Slot of the entry in dataEntries.
+ *
+ * The entry's date and category postings are left in place: range() skips IDs
+ * that are no longer in the ID index, and compactEntries() drops them in bulk.
+ */
+void CashflowTracking::removeEntry(size_t slot) {
+    DataEntry& data = dataEntries[slot];
+    const int transID = data.transid;
+
+    // Tombstone the slot instead of shifting every later entry down
+    data = DataEntry{};
+    idIndex[static_cast<size_t>(transID)] = kNoSlot;
+    --liveEntries;
+    ++deletedSlots;
+
+    if (deletedSlots > liveEntries) {
+        compactEntries();
+    }
+}
+
+/**
+ * @brief Removes tombstoned slots from dataEntries and rebuilds the ID index.
+ *
+ * Keeps the remaining transactions in insertion order.
+ */
+void CashflowTracking::compactEntries() {
+    dataEntries.erase(
+        std::remove_if(dataEntries.begin(), dataEntries.end(),
+            [](const DataEntry& data) { return data.transid == 0; }),
+        dataEntries.end()
+    );
+
+    for (size_t slot = 0; slot < dataEntries.size(); ++slot) {
+        idIndex[static_cast<size_t>(dataEntries[slot].transid)] = slot;
+    }
+    deletedSlots = 0;
+
+    // Drop postings of deleted transactions; erasing keeps the lists sorted
+    auto isDeleted = [this](const DatePosting& posting) { return slotOf(posting.transid) == kNoSlot; };
+    dateIndex.erase(std::remove_if(dateIndex.begin(), dateIndex.end(), isDeleted), dateIndex.end());
+    for (auto category = categories.begin(); category != categories.end();) {
+        std::vector<DatePosting>& postings = category->second;
+        postings.erase(std::remove_if(postings.begin(), postings.end(), isDeleted), postings.end());
+        category = postings.empty() ? categories.erase(category) : std::next(category);
     }
 }
 
@@ -92,8 +659,22 @@ void CashflowTracking::deleteData(int transID) {
  * @brief Clears dataEntries and categories
  */
 void CashflowTracking::clear() {
+    appendJournalRecord(JournalClear, std::string());
+    resetEntries();
+    compactJournalIfNeeded();
+}
+
+/**
+ * @brief Drops every entry and resets the ID counter without journaling it.
+ */
+void CashflowTracking::resetEntries() {
     dataEntries.clear();
+    idIndex.clear();
+    liveEntries = 0;
+    dateIndex.clear();
     categories.clear();
+    dictionary.clear();
+    deletedSlots = 0;
     dataCounter = 1;
 }
 
@@ -101,157 +682,639 @@ void CashflowTracking::clear() {
  * @brief Saves all transaction data to a file.
  * @return True if the save operation was successful, false otherwise.
  *
- * This function serializes all transaction data to a binary file.
- * The file format is structured as follows:
- * 1. dataCounter value (to maintain ID consistency)
- * 2. Number of entries
- * 3. For each entry:
- *    - Fixed-size data (transid, cost)
- *    - String lengths followed by string contents for all string fields
+ * This function serializes all transaction data into a versioned columnar file
+ * that can be loaded by memory-mapping it. The file format is structured as follows:
+ * 1. LedgerFileHeader: magic "NPLEDGER", format version, byte-order marker,
+ *    dataCounter value (to maintain ID consistency), record count, heap size
+ *    and a checksum over everything after the header
+ * 2. Record table: one fixed-width LedgerRecord per entry holding transid, cost and
+ *    an (offset, length) reference into the string heap for every string field
+ * 3. String heap: the raw bytes of all string fields, back to back
+ *
+ * The file is assembled in memory, written with a single call to a temporary
+ * file and then renamed over the old one, so a crash mid-save never leaves a
+ * half-written ledger behind. Once the snapshot is in place the journal it
+ * contains is deleted.
  */
 bool CashflowTracking::saveDataToFile() {
-    std::ofstream outFile(dataFilePath, std::ios::binary);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not open file for writing: " << dataFilePath << std::endl;
+    NOOMYPLAN_TRACE_SCOPE("ledger.save");
+    finishCompaction();
+
+    std::vector<char> buffer = buildSnapshot();
+    if (buffer.empty() || !writeFileAtomically(dataFilePath, buffer)) {
         return false;
     }
 
-    // Save the current data counter to ensure ID consistency across sessions
-    outFile.write(reinterpret_cast<const char*>(&dataCounter), sizeof(dataCounter));
+    // The snapshot now holds every journaled change
+    journalStream.close();
+    std::error_code error;
+    std::filesystem::remove(journalFilePath(), error);
+    std::filesystem::remove(journalFilePath() + ".old", error);
+    journalRecords = 0;
+    journalBroken = false;
+    return true;
+}
 
-    // Save the number of entries
-    size_t numEntries = dataEntries.size();
-    outFile.write(reinterpret_cast<const char*>(&numEntries), sizeof(numEntries));
+/**
+ * @brief Serializes every live entry into the snapshot file format.
+ * @return The complete file contents, or an empty buffer if the ledger is too large.
+ */
+std::vector<char> CashflowTracking::buildSnapshot() const {
+    NOOMYPLAN_TRACE_SCOPE("ledger.buildSnapshot");
+    const size_t recordCount = liveEntries;
 
-    // Save each data entry
+    // Size the string heap up front so the buffer is allocated once. Interned
+    // text is stored once at the start of the heap and shared by every record.
+    size_t heapSize = 0;
+    for (size_t symbol = 0; symbol < dictionary.size(); ++symbol) {
+        heapSize += dictionary.text(static_cast<StringDictionary::Symbol>(symbol)).size();
+    }
     for (const auto& entry : dataEntries) {
-        // Write fixed-size members
-        outFile.write(reinterpret_cast<const char*>(&entry.transid), sizeof(entry.transid));
-        outFile.write(reinterpret_cast<const char*>(&entry.cost), sizeof(entry.cost));
+        if (entry.transid == 0) continue; // Skip deleted slots
+        heapSize += entry.dateTime.size() + entry.merchandise.size();
+    }
+    if (heapSize > UINT32_MAX) {
+        std::cerr << "Error: Ledger too large to save: " << dataFilePath << std::endl;
+        return std::vector<char>();
+    }
 
-        // Write string lengths and then the strings
-        size_t len;
+    const size_t recordsOffset = sizeof(LedgerFileHeader);
+    const size_t heapOffset = recordsOffset + recordCount * sizeof(LedgerRecord);
+    std::vector<char> buffer(heapOffset + heapSize);
 
-        // DateTime
-        len = entry.dateTime.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.dateTime.c_str(), len);
+    // Write the record table and the string heap
+    char* heap = buffer.data() + heapOffset;
+    uint32_t heapUsed = 0;
+    auto appendString = [&](const std::string& text) {
+        LedgerStringRef ref = { heapUsed, static_cast<uint32_t>(text.size()) };
+        std::memcpy(heap + heapUsed, text.data(), text.size());
+        heapUsed += ref.length;
+        return ref;
+    };
 
-        // Seller
-        len = entry.seller.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.seller.c_str(), len);
+    std::vector<LedgerStringRef> symbolRefs(dictionary.size());
+    for (size_t symbol = 0; symbol < symbolRefs.size(); ++symbol) {
+        symbolRefs[symbol] = appendString(dictionary.text(static_cast<StringDictionary::Symbol>(symbol)));
+    }
 
-        // Buyer
-        len = entry.buyer.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.buyer.c_str(), len);
+    size_t recordIndex = 0;
+    for (const auto& entry : dataEntries) {
+        if (entry.transid == 0) continue; // Skip deleted slots
 
-        // Merchandise
-        len = entry.merchandise.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.merchandise.c_str(), len);
+        LedgerRecord record = {};
+        record.transid = entry.transid;
+        record.timestamp = entry.timestamp;
+        record.cost = entry.cost.cents();
+        record.dateTime = appendString(entry.dateTime);
+        record.seller = symbolRefs[entry.seller];
+        record.buyer = symbolRefs[entry.buyer];
+        record.merchandise = appendString(entry.merchandise);
+        record.currency = symbolRefs[entry.currency];
+        record.category = symbolRefs[entry.category];
+        std::memcpy(buffer.data() + recordsOffset + recordIndex * sizeof(LedgerRecord), &record, sizeof(record));
+        ++recordIndex;
+    }
 
-        // Currency
-        len = entry.currency.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.currency.c_str(), len);
+    // Fill in the header last so the checksum covers the finished payload
+    LedgerFileHeader header = {};
+    std::memcpy(header.magic, kLedgerMagic, sizeof(header.magic));
+    header.version = kLedgerFormatVersion;
+    header.byteOrderMark = kLedgerByteOrderMark;
+    header.dataCounter = dataCounter;
+    header.recordSize = sizeof(LedgerRecord);
+    header.recordCount = recordCount;
+    header.heapSize = heapSize;
+    header.checksum = ledgerChecksum(buffer.data() + recordsOffset, buffer.size() - recordsOffset);
+    header.journalSequence = journalSequence;
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    return buffer;
+}
 
-        // Category
-        len = entry.category.size();
-        outFile.write(reinterpret_cast<const char*>(&len), sizeof(len));
-        outFile.write(entry.category.c_str(), len);
+/**
+ * @brief Loads transaction data from a file.
+ * @return True if the load operation was successful, false otherwise.
+ *
+ * This function memory-maps the file written by saveDataToFile() and builds the
+ * entries straight from the mapped record table and string heap, without any
+ * intermediate read buffers. Before anything is read the header is validated:
+ * magic, version, byte order, record width, the exact file size implied by the
+ * record count and heap size, and the payload checksum. A truncated or corrupted
+ * file is reported, moved aside to "<file>.corrupt" so the next save cannot
+ * overwrite it, and not loaded.
+ *
+ * Files written before the format was versioned are still read through
+ * loadLegacyDataFile().
+ *
+ * The function also rebuilds the categories map based on the loaded entries.
+ *
+ * Afterwards the journal left by an interrupted background snapshot
+ * ("<file>.journal.old") and the current journal are replayed, skipping records
+ * the snapshot already contains. A leftover old journal, or one written in an
+ * older format, is folded into a fresh snapshot straight away.
+ */
+bool CashflowTracking::loadDataFromFile() {
+    NOOMYPLAN_TRACE_SCOPE("ledger.load");
+    finishCompaction();
+    journalStream.close();
+    resetEntries();
+    journalRecords = 0;
+    journalBroken = false;
+
+    uint64_t snapshotSequence = 0;
+    bool loaded = loadSnapshotFile(snapshotSequence);
+    journalSequence = snapshotSequence;
+
+    const std::string oldJournalPath = journalFilePath() + ".old";
+    std::error_code error;
+    const bool interruptedCompaction = std::filesystem::exists(oldJournalPath, error);
+    bool outdatedJournal = false;
+    if (interruptedCompaction) {
+        loaded = replayJournal(oldJournalPath, snapshotSequence, outdatedJournal) || loaded;
     }
+    loaded = replayJournal(journalFilePath(), snapshotSequence, outdatedJournal) || loaded;
 
-    outFile.close();
+    if (interruptedCompaction || outdatedJournal) {
+        if (!saveDataToFile() && !interruptedCompaction) {
+            // New records must not be appended in the current format to an outdated
+            // journal; set it aside as the old journal, which the next load replays first
+            std::filesystem::rename(journalFilePath(), oldJournalPath, error);
+        }
+    }
+    return loaded;
+}
+
+/**
+ * @brief Loads the snapshot file.
+ * @param snapshotSequence Receives the last journal sequence number the snapshot contains.
+ * @return True if the load operation was successful, false otherwise.
+ */
+bool CashflowTracking::loadSnapshotFile(uint64_t& snapshotSequence) {
+    NOOMYPLAN_TRACE_SCOPE("ledger.parseSnapshot");
+    snapshotSequence = 0;
+
+    MappedFile file;
+    if (!file.open(dataFilePath)) {
+        // File might not exist yet, which is not an error for a new user
+        return false;
+    }
+
+    if (file.size() < sizeof(kLedgerMagic) || std::memcmp(file.data(), kLedgerMagic, sizeof(kLedgerMagic)) != 0) {
+        // No magic number: the file predates the versioned format
+        file.close();
+        return loadLegacyDataFile();
+    }
+
+    auto rejectFile = [&](const char* reason) {
+        std::cerr << "Error: " << reason << ": " << dataFilePath << std::endl;
+        file.close();
+        std::error_code error;
+        std::filesystem::rename(dataFilePath, dataFilePath + ".corrupt", error);
+        return false;
+    };
+
+    if (file.size() < sizeof(LedgerFileHeader)) {
+        return rejectFile("Ledger file is truncated");
+    }
+
+    LedgerFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.byteOrderMark != kLedgerByteOrderMark) {
+        return rejectFile("Ledger file was written with a different byte order");
+    }
+    if (header.version < kOldestLedgerFormatVersion || header.version > kLedgerFormatVersion ||
+        header.recordSize != sizeof(LedgerRecord)) {
+        return rejectFile("Unsupported ledger file version");
+    }
+
+    const size_t recordsOffset = sizeof(LedgerFileHeader);
+    const uint64_t payloadSize = file.size() - recordsOffset;
+    if (header.recordCount > payloadSize / sizeof(LedgerRecord) ||
+        header.recordCount * sizeof(LedgerRecord) + header.heapSize != payloadSize) {
+        return rejectFile("Ledger file is truncated");
+    }
+    if (ledgerChecksum(file.data() + recordsOffset, payloadSize) != header.checksum) {
+        return rejectFile("Ledger file checksum mismatch");
+    }
+
+    const char* records = file.data() + recordsOffset;
+    const char* heap = records + header.recordCount * sizeof(LedgerRecord);
+    auto fieldInHeap = [&](const LedgerStringRef& ref) {
+        return static_cast<uint64_t>(ref.offset) + ref.length <= header.heapSize;
+    };
+
+    // Clear existing data
+    resetEntries();
+    dataCounter = header.dataCounter;
+    dataEntries.reserve(header.recordCount);
+    dateIndex.reserve(header.recordCount);
+    idIndex.assign(static_cast<size_t>(std::max(header.dataCounter, 1)), kNoSlot);
+
+    // Build each data entry directly from the mapped record and heap
+    for (uint64_t i = 0; i < header.recordCount; ++i) {
+        LedgerRecord record;
+        std::memcpy(&record, records + i * sizeof(LedgerRecord), sizeof(record));
+        if (!fieldInHeap(record.dateTime) || !fieldInHeap(record.seller) || !fieldInHeap(record.buyer) ||
+            !fieldInHeap(record.merchandise) || !fieldInHeap(record.currency) || !fieldInHeap(record.category)) {
+            resetEntries();
+            return rejectFile("Ledger record points outside the string heap");
+        }
+        if (record.transid <= 0 || record.transid >= header.dataCounter || slotOf(record.transid) != kNoSlot) {
+            resetEntries();
+            return rejectFile("Ledger record has an invalid transaction ID");
+        }
+
+        DataEntry entry;
+        entry.transid = record.transid;
+        if (header.version >= 4) {
+            entry.cost = Money::fromCents(record.cost);
+        }
+        else {
+            // Older files stored the cost as a double in the same eight bytes
+            double amount = 0.0;
+            std::memcpy(&amount, &record.cost, sizeof(amount));
+            if (!Money::tryFromDouble(amount, entry.cost)) {
+                resetEntries();
+                return rejectFile("Ledger record has an invalid cost");
+            }
+        }
+        entry.dateTime.assign(heap + record.dateTime.offset, record.dateTime.length);
+        entry.seller = dictionary.intern(std::string_view(heap + record.seller.offset, record.seller.length));
+        entry.buyer = dictionary.intern(std::string_view(heap + record.buyer.offset, record.buyer.length));
+        entry.merchandise.assign(heap + record.merchandise.offset, record.merchandise.length);
+        entry.currency = dictionary.intern(std::string_view(heap + record.currency.offset, record.currency.length));
+        entry.category = dictionary.intern(std::string_view(heap + record.category.offset, record.category.length));
+        // Older files have no timestamp column yet
+        entry.timestamp = header.version >= 3 ? record.timestamp : parseTimestamp(entry.dateTime);
+        insertEntry(std::move(entry), false);
+    }
+    sortDateIndexes();
+
+    snapshotSequence = header.version >= 2 ? header.journalSequence : 0;
     return true;
 }
 
 /**
- * @brief Loads transaction data from a file.
+ * @brief Loads transaction data written in the original unversioned format.
  * @return True if the load operation was successful, false otherwise.
  *
- * This function deserializes transaction data from a binary file.
- * It reads the file according to the format written by saveDataToFile():
+ * Reads the layout used before the versioned format was introduced:
  * 1. dataCounter value
  * 2. Number of entries
  * 3. For each entry:
  *    - Fixed-size data (transid, cost)
  *    - String lengths followed by string contents for all string fields
  *
- * The function also rebuilds the categories map based on the loaded entries.
+ * The next snapshot rewrites the ledger in the current format.
  */
-bool CashflowTracking::loadDataFromFile() {
+bool CashflowTracking::loadLegacyDataFile() {
     std::ifstream inFile(dataFilePath, std::ios::binary);
     if (!inFile.is_open()) {
-        // File might not exist yet, which is not an error for a new user
         return false;
     }
 
     // Clear existing data
-    dataEntries.clear();
-    categories.clear();
+    resetEntries();
 
     // Read the data counter
     inFile.read(reinterpret_cast<char*>(&dataCounter), sizeof(dataCounter));
 
     // Read the number of entries
-    size_t numEntries;
+    size_t numEntries = 0;
     inFile.read(reinterpret_cast<char*>(&numEntries), sizeof(numEntries));
 
+    auto readString = [&inFile](std::string& text) {
+        size_t len = 0;
+        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
+        if (!inFile) return false;
+        text.resize(len);
+        inFile.read(&text[0], static_cast<std::streamsize>(len));
+        return static_cast<bool>(inFile);
+    };
+
     // Read each data entry
-    for (size_t i = 0; i < numEntries; ++i) {
+    for (size_t i = 0; i < numEntries && inFile; ++i) {
         DataEntry entry;
 
         // Read fixed-size members
         inFile.read(reinterpret_cast<char*>(&entry.transid), sizeof(entry.transid));
-        inFile.read(reinterpret_cast<char*>(&entry.cost), sizeof(entry.cost));
+        double cost = 0.0;
+        inFile.read(reinterpret_cast<char*>(&cost), sizeof(cost));
+        if (!inFile || entry.transid <= 0 || entry.transid >= dataCounter || slotOf(entry.transid) != kNoSlot) {
+            std::cerr << "Error: Ledger file has an invalid transaction ID: " << dataFilePath << std::endl;
+            break;
+        }
 
         // Read string lengths and then the strings
-        size_t len;
-        std::vector<char> buffer;
+        std::string seller, buyer, currency, category;
+        if (!readString(entry.dateTime) || !readString(seller) || !readString(buyer) ||
+            !readString(entry.merchandise) || !readString(currency) || !readString(category)) {
+            std::cerr << "Error: Ledger file is truncated: " << dataFilePath << std::endl;
+            break;
+        }
+        if (!Money::tryFromDouble(cost, entry.cost)) {
+            std::cerr << "Error: Ledger file has an invalid cost: " << dataFilePath << std::endl;
+            break;
+        }
+        entry.seller = dictionary.intern(seller);
+        entry.buyer = dictionary.intern(buyer);
+        entry.currency = dictionary.intern(currency);
+        entry.category = dictionary.intern(category);
+        entry.timestamp = parseTimestamp(entry.dateTime);
 
-        // DateTime
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.dateTime.assign(buffer.data(), len);
+        // Add the entry to our collections
+        insertEntry(std::move(entry), false);
+    }
+    sortDateIndexes();
 
-        // Seller
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.seller.assign(buffer.data(), len);
+    inFile.close();
+    return true;
+}
 
-        // Buyer
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.buyer.assign(buffer.data(), len);
+/**
+ * @brief Returns the path of the journal that belongs to dataFilePath.
+ */
+std::string CashflowTracking::journalFilePath() const {
+    return dataFilePath + ".journal";
+}
 
-        // Merchandise
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.merchandise.assign(buffer.data(), len);
+/**
+ * @brief Appends one change to the journal and flushes it.
+ * @param operation Journal operation code.
+ * @param body Operation-specific payload.
+ *
+ * The journal is opened on the first change and gets a JournalFileHeader if it
+ * is new. The in-memory change still goes ahead if the journal cannot be
+ * written. The journal is then cut back to its last complete record, so the torn
+ * bytes cannot hide later records from replay, and marked broken: later changes
+ * are not journaled, because replaying them without this one would be wrong, and
+ * the compactJournalIfNeeded() that follows every change writes a snapshot instead.
+ */
+void CashflowTracking::appendJournalRecord(uint8_t operation, const std::string& body) {
+    NOOMYPLAN_TRACE_SCOPE("ledger.journalAppend");
+    NOOMYPLAN_TRACE_COUNT("ledger.journalRecords", 1);
+    ++journalSequence;
+    ++journalRecords;
+    if (journalBroken) {
+        return;
+    }
 
-        // Currency
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.currency.assign(buffer.data(), len);
+    size_t headerBytes = 0;
+    if (!journalStream.is_open()) {
+        const std::string path = journalFilePath();
+        std::error_code error;
+        const uintmax_t existingSize = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+        const bool isNew = error || existingSize == 0;
+        journalStream.open(path, std::ios::binary | std::ios::app);
+        if (!journalStream.is_open()) {
+            std::cerr << "Error: Could not open journal for writing: " << path << std::endl;
+            journalBroken = true;
+            return;
+        }
+        journalGoodSize = isNew ? 0 : existingSize;
+        if (isNew) {
+            JournalFileHeader header = {};
+            std::memcpy(header.magic, kJournalMagic, sizeof(header.magic));
+            header.version = kJournalFormatVersion;
+            header.byteOrderMark = kLedgerByteOrderMark;
+            journalStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            headerBytes = sizeof(header);
+        }
+    }
 
-        // Category
-        inFile.read(reinterpret_cast<char*>(&len), sizeof(len));
-        buffer.resize(len);
-        inFile.read(buffer.data(), len);
-        entry.category.assign(buffer.data(), len);
+    std::string record;
+    const size_t payloadSize = sizeof(uint64_t) + sizeof(uint8_t) + body.size();
+    record.reserve(sizeof(JournalRecordHeader) + payloadSize);
+    record.resize(sizeof(JournalRecordHeader));
+    appendValue(record, journalSequence);
+    appendValue(record, operation);
+    record += body;
 
-        // Add the entry to our collections
-        dataEntries.push_back(entry);
-        categories[entry.category].push_back(entry.transid);
+    JournalRecordHeader recordHeader;
+    recordHeader.payloadSize = static_cast<uint32_t>(payloadSize);
+    recordHeader.checksum = static_cast<uint32_t>(ledgerChecksum(record.data() + sizeof(recordHeader), payloadSize));
+    std::memcpy(&record[0], &recordHeader, sizeof(recordHeader));
+
+    // One write per record, so a crash can only tear the last one
+    journalStream.write(record.data(), static_cast<std::streamsize>(record.size()));
+    journalStream.flush();
+    if (!journalStream) {
+        std::cerr << "Error: Could not write journal: " << journalFilePath() << std::endl;
+        journalStream.close();
+        std::error_code error;
+        std::filesystem::resize_file(journalFilePath(), journalGoodSize, error);
+        journalBroken = true;
+        return;
     }
+    journalGoodSize += headerBytes + record.size();
+}
 
-    inFile.close();
+/**
+ * @brief Replays a journal on top of the loaded snapshot.
+ * @param path Journal file to replay.
+ * @param snapshotSequence Records up to this sequence number are already in the snapshot.
+ * @param outdated Set to true if the journal was written in an older format.
+ * @return True if at least one record was applied.
+ *
+ * Replay stops at the first record that is incomplete or fails its checksum,
+ * which is what a crash in the middle of an append leaves behind. That tail is
+ * cut off so later appends follow the last good record.
+ */
+bool CashflowTracking::replayJournal(const std::string& path, uint64_t snapshotSequence, bool& outdated) {
+    NOOMYPLAN_TRACE_SCOPE("ledger.replayJournal");
+    MappedFile file;
+    if (!file.open(path) || file.size() == 0) {
+        return false;
+    }
+
+    JournalFileHeader header;
+    if (file.size() < sizeof(header)) {
+        // Crashed while writing the header; nothing was journaled yet
+        file.close();
+        std::error_code error;
+        std::filesystem::resize_file(path, 0, error);
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) != 0 ||
+        header.byteOrderMark != kLedgerByteOrderMark || header.version < kOldestJournalFormatVersion ||
+        header.version > kJournalFormatVersion) {
+        std::cerr << "Error: Unsupported journal file: " << path << std::endl;
+        file.close();
+        std::error_code error;
+        std::filesystem::rename(path, path + ".corrupt", error);
+        return false;
+    }
+
+    const char* cursor = file.data() + sizeof(header);
+    const char* end = file.data() + file.size();
+    size_t applied = 0;
+    while (static_cast<size_t>(end - cursor) >= sizeof(JournalRecordHeader)) {
+        JournalRecordHeader recordHeader;
+        std::memcpy(&recordHeader, cursor, sizeof(recordHeader));
+        const char* payload = cursor + sizeof(recordHeader);
+        if (recordHeader.payloadSize > static_cast<size_t>(end - payload) ||
+            static_cast<uint32_t>(ledgerChecksum(payload, recordHeader.payloadSize)) != recordHeader.checksum ||
+            !applyJournalRecord(payload, recordHeader.payloadSize, snapshotSequence, header.version)) {
+            break;
+        }
+        cursor = payload + recordHeader.payloadSize;
+        ++applied;
+    }
+
+    const size_t validSize = static_cast<size_t>(cursor - file.data());
+    const bool tornTail = cursor != end;
+    file.close();
+    if (tornTail) {
+        std::cerr << "Warning: Discarding incomplete journal tail: " << path << std::endl;
+        std::error_code error;
+        std::filesystem::resize_file(path, validSize, error);
+    }
+
+    journalRecords += applied;
+    outdated = outdated || header.version != kJournalFormatVersion;
+    return applied > 0;
+}
+
+/**
+ * @brief Applies a single journal record to the in-memory ledger.
+ * @param payload Record payload, starting with its sequence number.
+ * @param size Size of the payload in bytes.
+ * @param snapshotSequence Records up to this sequence number are skipped.
+ * @param formatVersion Version of the journal file; version 1 stored costs as doubles.
+ * @return False if the record is malformed.
+ */
+bool CashflowTracking::applyJournalRecord(const char* payload, size_t size, uint64_t snapshotSequence,
+    uint32_t formatVersion) {
+    JournalReader reader = { payload, payload + size, formatVersion };
+    uint64_t sequence = 0;
+    uint8_t operation = 0;
+    if (!reader.read(sequence) || !reader.read(operation)) {
+        return false;
+    }
+    if (sequence <= snapshotSequence) {
+        return true; // Already part of the snapshot
+    }
+
+    switch (operation) {
+    case JournalAdd: {
+        int32_t transid = 0;
+        DataEntry entry;
+        std::string_view seller, buyer, currency, category;
+        if (!reader.read(transid) || !reader.readCost(entry.cost) ||
+            !reader.readString(entry.dateTime) || !reader.readString(seller) ||
+            !reader.readString(buyer) || !reader.readString(entry.merchandise) ||
+            !reader.readString(currency) || !reader.readString(category) ||
+            transid <= 0 || transid == std::numeric_limits<int32_t>::max()) {
+            return false;
+        }
+        entry.transid = transid;
+        entry.seller = dictionary.intern(seller);
+        entry.buyer = dictionary.intern(buyer);
+        entry.currency = dictionary.intern(currency);
+        entry.category = dictionary.intern(category);
+        entry.timestamp = parseTimestamp(entry.dateTime);
+        if (slotOf(transid) == kNoSlot) {
+            insertEntry(std::move(entry));
+        }
+        dataCounter = std::max(dataCounter, transid + 1);
+        break;
+    }
+    case JournalDelete: {
+        int32_t transid = 0;
+        if (!reader.read(transid)) {
+            return false;
+        }
+        const size_t slot = slotOf(transid);
+        if (slot != kNoSlot) {
+            removeEntry(slot);
+        }
+        break;
+    }
+    case JournalClear:
+        resetEntries();
+        break;
+    case JournalEdit: {
+        int32_t transid = 0;
+        uint8_t fieldValue = 0;
+        if (!reader.read(transid) || !reader.read(fieldValue) ||
+            fieldValue < static_cast<uint8_t>(Field::DateTime) || fieldValue > static_cast<uint8_t>(Field::Category)) {
+            return false;
+        }
+        const Field field = static_cast<Field>(fieldValue);
+        std::string_view text;
+        Money cost;
+        if (field == Field::Cost ? !reader.readCost(cost) : !reader.readString(text)) {
+            return false;
+        }
+        const size_t slot = slotOf(transid);
+        if (slot != kNoSlot) {
+            applyFieldUpdate(slot, field, text, cost);
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+
+    journalSequence = std::max(journalSequence, sequence);
     return true;
 }
+
+/**
+ * @brief Starts a background snapshot once the journal outgrows the ledger.
+ *
+ * The snapshot buffer is built on the calling thread, so it is consistent with
+ * the ledger at this point, and the journal is rotated to "<file>.journal.old"
+ * so new changes go to a fresh journal. Only writing the snapshot and deleting
+ * the old journal happen on the background thread; if either is interrupted,
+ * the next load replays the old journal.
+ */
+void CashflowTracking::compactJournalIfNeeded() {
+    if (journalBroken) {
+        saveDataToFile(); // Clears journalBroken once the snapshot holds every change
+        return;
+    }
+    if (journalRecords < std::max(kMinJournalRecordsBeforeCompaction, liveEntries)) {
+        return;
+    }
+
+    finishCompaction();
+
+    const std::string oldJournalPath = journalFilePath() + ".old";
+    std::error_code error;
+    if (std::filesystem::exists(oldJournalPath, error)) {
+        // An earlier snapshot never landed; fold both journals in synchronously
+        saveDataToFile();
+        return;
+    }
+
+    std::vector<char> snapshot = buildSnapshot();
+    if (snapshot.empty()) {
+        return;
+    }
+
+    journalStream.close();
+    std::filesystem::rename(journalFilePath(), oldJournalPath, error);
+    if (error) {
+        std::cerr << "Error: Could not rotate journal " << journalFilePath() << ": " << error.message() << std::endl;
+        return; // Keep appending to the current journal and try again later
+    }
+    journalRecords = 0;
+
+    compactionThread = std::thread([snapshotPath = dataFilePath, oldJournalPath, snapshot = std::move(snapshot)]() {
+        NOOMYPLAN_TRACE_SCOPE("ledger.compact");
+        if (writeFileAtomically(snapshotPath, snapshot)) {
+            std::error_code removeError;
+            std::filesystem::remove(oldJournalPath, removeError);
+        }
+    });
+}
+
+/**
+ * @brief Waits for a running background snapshot to finish.
+ */
+void CashflowTracking::finishCompaction() {
+    if (compactionThread.joinable()) {
+        compactionThread.join();
+    }
+}
\ No newline at end of file
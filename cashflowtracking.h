@@ -4,7 +4,14 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <fstream>  // Required for file input/output operations
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+#include <climits>
+#include "money.h"
+#include "stringdictionary.h"
 
 /**
  * @class cashflowtracking.h
@@ -13,7 +20,14 @@
  * This file contains the declaration of the CashflowTracking class, which provides
  * functionalities for adding, searching, and listing transactions.
  * Transactions stored in vector, and categories mapped to their respective transaction IDs.
+ * A date-sorted index and per-category postings answer date-range queries by binary search.
+ * Sellers, buyers, currencies and categories repeat across many rows, so each row
+ * stores 32-bit symbols for them and the text lives once in a StringDictionary.
+ * Transaction IDs are indexed to their storage slot so lookups and deletes run in constant time.
+ * Because IDs are handed out by a counter, the index is a dense table addressed by ID.
  * Added data persistence capabilities to save and load transaction data between sessions.
+ * Every change is appended to a journal next to the snapshot file, so saving costs
+ * O(change) instead of O(ledger); the journal is folded back into the snapshot in the background.
  *
  * @author Abbygail Latimer
  */
@@ -24,16 +38,20 @@
   *
   * Each DataEntry struct stores details about a transaction, including transaction ID,
   * date and time, seller, buyer, merchandise details, cost, and category.
+  * Seller, buyer, currency and category are symbols; CashflowTracking::text() turns
+  * them back into text. The date is parsed once into timestamp for filtering and
+  * sorting; dateTime keeps the original text for display.
   */
 struct DataEntry {
-    int transid;                // Unique transaction ID.
-    std::string dateTime;       // Date and time of the transaction.
-    std::string seller;         // Name of the seller.
-    std::string buyer;          // Name of the buyer.
-    std::string merchandise;    // Description of the merchandise involved.
-    double cost;                // Cost of the transaction.
-    std::string currency;       // Currency cost is in.
-    std::string category;       // Category of the transaction (e.g., sales, expenses).
+    int transid;                        // Unique transaction ID.
+    int32_t timestamp;                  // dateTime as minutes since 1970-01-01 00:00, or CashflowTracking::kNoTimestamp.
+    std::string dateTime;               // Date and time of the transaction.
+    StringDictionary::Symbol seller;    // Name of the seller.
+    StringDictionary::Symbol buyer;     // Name of the buyer.
+    std::string merchandise;            // Description of the merchandise involved.
+    Money cost;                         // Cost of the transaction.
+    StringDictionary::Symbol currency;  // Currency cost is in.
+    StringDictionary::Symbol category;  // Category of the transaction (e.g., sales, expenses).
 };
 
 /**
@@ -44,15 +62,193 @@ struct DataEntry {
  * It maintains a record of transactions and categorizes them.
  * Added functionality to save data to a file and load it when the program restarts,
  * ensuring transaction data persists between sessions.
+ *
+ * Persistence is split into a snapshot ("<file>") and an append-only journal
+ * ("<file>.journal"). addData(), updateEntry(), deleteData() and clear() append one checksummed,
+ * sequence-numbered record to the journal before changing memory, and loading
+ * replays the records the snapshot does not contain yet. Once the journal grows
+ * as large as the ledger it is rotated to "<file>.journal.old" and a new snapshot
+ * is written on a background thread.
  */
 class CashflowTracking {
+public:
+    static constexpr int32_t kNoTimestamp = INT32_MIN;  // Timestamp of a transaction whose date cannot be read
+
+    /**
+     * @brief Editable fields of a transaction, for updateEntry().
+     *
+     * The values are stored in the journal, so they must not change.
+     */
+    enum class Field : uint8_t {
+        DateTime = 1,
+        Seller = 2,
+        Buyer = 3,
+        Merchandise = 4,
+        Cost = 5,
+        Currency = 6,
+        Category = 7
+    };
+
 private:
-    std::vector<DataEntry> dataEntries;                         // Stores all transaction records
-    std::unordered_map<std::string, std::vector<int>> categories; // Maps categories to transaction IDs
+    /**
+     * @brief Index entry ordering a transaction by its timestamp, then its ID.
+     */
+    struct DatePosting {
+        int32_t timestamp;
+        int transid;
+
+        bool operator<(const DatePosting& other) const {
+            return timestamp != other.timestamp ? timestamp < other.timestamp : transid < other.transid;
+        }
+    };
+
+    std::vector<DataEntry> dataEntries;                         // Stores all transaction records in insertion order (deleted slots have transid 0)
+    std::vector<size_t> idIndex;                                // Dense slot table: idIndex[transid] is the entry's slot in dataEntries, or kNoSlot
+    size_t liveEntries = 0;                                     // Number of stored (non-deleted) transactions
+    StringDictionary dictionary;                                // Text of the seller, buyer, currency and category symbols
+    std::vector<DatePosting> dateIndex;                         // Every transaction, sorted by date (deleted IDs are skipped until compaction)
+    std::unordered_map<StringDictionary::Symbol, std::vector<DatePosting>> categories; // Maps category symbols to their transactions, sorted by date
+    size_t deletedSlots = 0;                                    // Number of tombstoned slots waiting for compaction
     int dataCounter = 1;                                        // Counter for generating unique transaction IDs
     std::string dataFilePath;                                   // Path to the data storage file
+    std::ofstream journalStream;                                // Open handle to the journal, opened on the first change
+    uint64_t journalSequence = 0;                               // Sequence number of the last journaled change
+    size_t journalRecords = 0;                                  // Changes journaled since the last snapshot
+    uint64_t journalGoodSize = 0;                               // Bytes of the journal that end on a complete record
+    bool journalBroken = false;                                 // A change could not be journaled; only a snapshot can save it now
+    std::thread compactionThread;                               // Writes snapshots in the background
+
+    /**
+     * @brief Removes tombstoned slots from dataEntries and rebuilds the ID index.
+     *
+     * Called once deleted slots outnumber live ones, so the cost is amortized
+     * over the deletes that created them. Postings of deleted transactions are
+     * dropped from the date index and categories at the same time.
+     */
+    void compactEntries();
+
+    static constexpr size_t kNoSlot = static_cast<size_t>(-1); // Marks IDs with no stored entry
+
+    /**
+     * @brief Returns the slot of a transaction in dataEntries, or kNoSlot if it isn't stored.
+     */
+    size_t slotOf(int transID) const;
+
+    /**
+     * @brief Appends an entry that already has its ID and adds it to the ID index, date index and categories.
+     * @param keepIndexSorted False while bulk loading; sortDateIndexes() must then be called afterwards.
+     */
+    void insertEntry(DataEntry&& entry, bool keepIndexSorted = true);
+
+    /**
+     * @brief Inserts a posting, appending when it is the newest and binary searching otherwise.
+     */
+    static void insertPosting(std::vector<DatePosting>& postings, const DatePosting& posting);
+
+    /**
+     * @brief Removes a posting from a date-sorted list, if present.
+     */
+    static void erasePosting(std::vector<DatePosting>& postings, const DatePosting& posting);
+
+    /**
+     * @brief Sorts the date index and category postings after a bulk load.
+     */
+    void sortDateIndexes();
+
+    /**
+     * @brief Removes a stored entry from the ID index and categories and tombstones its slot.
+     */
+    void removeEntry(size_t slot);
+
+    /**
+     * @brief Drops every entry without journaling it; used before loading.
+     */
+    void resetEntries();
+
+    /**
+     * @brief Sets one field of a stored entry and moves its index postings; shared by updateEntry() and replay.
+     * @param cost New cost, used when field is Field::Cost.
+     */
+    void applyFieldUpdate(size_t slot, Field field, std::string_view text, Money cost);
+
+    /**
+     * @brief Loads the snapshot file and reports the journal sequence it contains.
+     */
+    bool loadSnapshotFile(uint64_t& snapshotSequence);
+
+    /**
+     * @brief Loads a ledger file written in the original, unversioned format.
+     */
+    bool loadLegacyDataFile();
+
+    /**
+     * @brief Serializes every live entry into the snapshot file format.
+     */
+    std::vector<char> buildSnapshot() const;
+
+    /**
+     * @brief Returns the path of the journal that belongs to dataFilePath.
+     */
+    std::string journalFilePath() const;
+
+    /**
+     * @brief Appends one change to the journal and flushes it.
+     * @param operation Journal operation code.
+     * @param body Operation-specific payload.
+     *
+     * If the record cannot be written, the journal is cut back to its last complete
+     * record and marked broken until the next snapshot.
+     */
+    void appendJournalRecord(uint8_t operation, const std::string& body);
+
+    /**
+     * @brief Applies the journal records newer than snapshotSequence and truncates a torn tail.
+     * @param outdated Set to true if the journal was written in an older format.
+     * @return True if at least one record was applied.
+     */
+    bool replayJournal(const std::string& path, uint64_t snapshotSequence, bool& outdated);
+
+    /**
+     * @brief Applies a single decoded journal record.
+     * @param formatVersion Version of the journal the record comes from; version 1 stored costs as doubles.
+     * @return False if the record is malformed.
+     */
+    bool applyJournalRecord(const char* payload, size_t size, uint64_t snapshotSequence, uint32_t formatVersion);
+
+    /**
+     * @brief Starts a background snapshot once the journal outgrows the ledger.
+     */
+    void compactJournalIfNeeded();
+
+    /**
+     * @brief Waits for a running background snapshot to finish.
+     */
+    void finishCompaction();
+
+    /**
+     * @brief Compares two category names, ignoring case.
+     */
+    static bool categoryMatches(const std::string& category, const std::string& filter);
+
+    /**
+     * @brief Returns every symbol whose text equals the given text, ignoring case.
+     */
+    std::vector<StringDictionary::Symbol> symbolsMatching(const std::string& text) const;
 
 public:
+
+    /**
+     * @brief Converts a calendar date and time to minutes since 1970-01-01 00:00.
+     * @return The timestamp, or kNoTimestamp if the date is invalid or out of range.
+     */
+    static int32_t makeTimestamp(int year, int month, int day, int hour = 0, int minute = 0);
+
+    /**
+     * @brief Parses a "yyyy-mm-dd, hh:mm" or "yyyy-mm-dd" date into minutes since 1970-01-01 00:00.
+     * @return The timestamp, or kNoTimestamp if the text is not a valid date.
+     */
+    static int32_t parseTimestamp(const std::string& dateTime);
+
     /**
      * @brief Constructor that initializes the CashflowTracking object.
      * @param filePath Path to the file where data will be stored.
@@ -67,14 +263,22 @@ public:
     }
 
     /**
-     * @brief Destructor that ensures data is saved when the object is destroyed.
+     * @brief Destructor that waits for a running background snapshot.
      *
-     * Automatically saves all transaction data to the file when the CashflowTracking
-     * object goes out of scope or is deleted, ensuring no data is lost.
+     * Every change has already been appended to the journal when it was made,
+     * so nothing has to be rewritten when the object goes out of scope.
      */
-    ~CashflowTracking() {
-        saveDataToFile();
-    }
+    ~CashflowTracking();
+
+    CashflowTracking(const CashflowTracking&) = delete;
+    CashflowTracking& operator=(const CashflowTracking&) = delete;
+
+    /**
+     * @brief Switches to another ledger file and loads it.
+     * @param filePath Path to the snapshot file; its journal lives next to it.
+     * @return True if any data was loaded from the snapshot or the journal.
+     */
+    bool open(const std::string& filePath);
 
     /**
      * @brief Adds a new transaction record to the system.
@@ -85,23 +289,24 @@ public:
      * @param cost Cost of the transaction.
      * @param currency Currency the cost is in.
      * @param category Category to store transaction under.
+     * @return The ID assigned to the new transaction.
      *
      * This function assigns a unique transaction ID to each entry and stores it
      * in the dataEntries vector. It also updates the category mapping.
      */
-    void addData(const std::string& dateTime, const std::string& seller,
+    int addData(const std::string& dateTime, const std::string& seller,
         const std::string& buyer, const std::string& merchandise,
-        double cost, const std::string& currency, const std::string& category);
+        Money cost, const std::string& currency, const std::string& category);
 
     /**
      * @brief Searches for a transaction by its ID.
      * @param transID Unique transaction ID to search for.
      * @return Pointer to the found DataEntry, or nullptr if not found.
      *
-     * This function iterates through the stored transactions and returns
+     * This function looks the ID up in the ID index and returns
      * a pointer to the matching transaction if found.
      */
-    DataEntry* searchDataEntries(int transID);
+    const DataEntry* searchDataEntries(int transID) const;
 
     /**
      * @brief Lists all stored transactions.
@@ -114,22 +319,128 @@ public:
      * @brief Retrieves all stored transaction records.
      * @return A vector containing all DataEntry objects.
      *
-     * This function provides external access to the full transaction list
+     * This function provides external access to the full transaction list.
+     * It copies every entry, so read-only callers should prefer forEachDataEntry().
      */
     std::vector<DataEntry> getAllDataEntries();
 
+    /**
+     * @brief Returns the number of stored transactions.
+     * @return The number of live transaction records.
+     */
+    size_t dataEntryCount() const;
+
+    /**
+     * @brief Returns the text of a seller, buyer, currency or category symbol.
+     * @param symbol Symbol taken from a DataEntry.
+     * @return The text, valid until the ledger is cleared or reloaded.
+     */
+    const std::string& text(StringDictionary::Symbol symbol) const;
+
+    /**
+     * @brief Looks up the symbol of a seller, buyer, currency or category.
+     * @param text Exact text to look up.
+     * @return The symbol, or StringDictionary::kNoSymbol if no transaction uses the text.
+     *
+     * Lets callers filter on a column with integer compares.
+     */
+    StringDictionary::Symbol findSymbol(const std::string& text) const;
+
+    /**
+     * @brief Visits every stored transaction in insertion order without copying it.
+     * @param visit Callable invoked with a const reference to each DataEntry.
+     *
+     * The references are only valid for the duration of the call; the ledger must
+     * not be modified from inside the visitor.
+     */
+    template <typename Visitor>
+    void forEachDataEntry(Visitor&& visit) const {
+        for (const auto& data : dataEntries) {
+            if (data.transid != 0) visit(data); // Skip deleted slots
+        }
+    }
+
+    /**
+     * @brief Visits the transactions dated within a range in date order, optionally limited to one category.
+     * @param start First timestamp to include (see makeTimestamp()).
+     * @param end Last timestamp to include.
+     * @param category Category to match (case-insensitive), or an empty string for all categories.
+     * @param visit Callable invoked with a const reference to each matching DataEntry.
+     *
+     * Binary searches the date index, or the category's postings, for the start of the
+     * range and walks it from there, so the cost is O(log n + k) for k matches rather
+     * than proportional to the ledger. Transactions whose date cannot be read are
+     * never matched. The same lifetime rules as forEachDataEntry() apply.
+     */
+    template <typename Visitor>
+    void range(int32_t start, int32_t end, const std::string& category, Visitor&& visit) const {
+        if (start == kNoTimestamp || start > end) return;
+
+        // Postings of one list that fall in [start, end]
+        struct Span {
+            std::vector<DatePosting>::const_iterator next;
+            std::vector<DatePosting>::const_iterator end;
+        };
+        auto spanOf = [start, end](const std::vector<DatePosting>& postings) {
+            return Span{
+                std::lower_bound(postings.begin(), postings.end(), DatePosting{ start, INT_MIN }),
+                std::upper_bound(postings.begin(), postings.end(), DatePosting{ end, INT_MAX })
+            };
+        };
+
+        std::vector<Span> spans;
+        if (category.empty()) {
+            spans.push_back(spanOf(dateIndex));
+        }
+        else {
+            // A category can be spelled several ways; merge each spelling's postings by date
+            for (StringDictionary::Symbol symbol : symbolsMatching(category)) {
+                auto postings = categories.find(symbol);
+                if (postings != categories.end()) spans.push_back(spanOf(postings->second));
+            }
+        }
+
+        while (true) {
+            Span* earliest = nullptr;
+            for (Span& span : spans) {
+                if (span.next != span.end && (!earliest || *span.next < *earliest->next)) earliest = &span;
+            }
+            if (!earliest) break;
+
+            const size_t slot = slotOf(earliest->next->transid);
+            ++earliest->next;
+            if (slot != kNoSlot) visit(dataEntries[slot]); // Skip postings of deleted transactions
+        }
+    }
+
+    /**
+     * @brief Changes one field of a stored transaction.
+     * @param transID Unique transaction ID to update.
+     * @param field Field to change.
+     * @param value New text of the field; for Field::Cost a decimal number such as "12.50".
+     * @return False if no transaction has the ID or the cost is not a number.
+     *
+     * The transaction keeps its ID and position. Only that field is journaled, and
+     * only the affected index entries move: a new date re-sorts the transaction in
+     * the date index, a new category moves it to that category's postings.
+     */
+    bool updateEntry(int transID, Field field, const std::string& value);
+
     /**
      * @brief Removes transaction from records using its ID.
      * @param transID Unique transaction ID to remove.
      *
-     * This function iterates through the stored transactions and removes requested transaction.
+     * This function looks the ID up in the ID index and tombstones its slot, so the
+     * cost does not depend on the ledger size. Slots are compacted once they outnumber
+     * live transactions. The delete is journaled before it is applied.
      */
     void deleteData(int transID);
 
     /**
      * @brief Clears dataEntries and categories
      *
-     * This function clears all entries in dataEntries and categories
+     * This function clears all entries in dataEntries, the ID index and categories.
+     * The clear is journaled like any other change.
      */
     void clear();
 
@@ -138,9 +449,12 @@ public:
      * @return True if the save operation was successful, false otherwise.
      *
      * This function writes all current transaction data to the specified file
-     * in binary format to ensure data integrity and efficient storage.
+     * in a versioned binary format (header, fixed-width record table and string heap)
+     * to ensure data integrity and efficient storage.
      * It saves transaction IDs, all transaction details, and preserves the
      * current dataCounter value to maintain ID consistency across sessions.
+     * Changes are persisted by the journal as they happen, so calling this is only
+     * needed to fold the journal into the snapshot right away; it then deletes the journal.
      */
     bool saveDataToFile();
 
@@ -148,10 +462,11 @@ public:
      * @brief Loads transaction data from a file.
      * @return True if the load operation was successful, false otherwise.
      *
-     * This function reads transaction data from the specified file and
-     * reconstructs the dataEntries vector and categories map. It also
+     * This function memory-maps the specified file and reconstructs the
+     * dataEntries vector and categories map from it. It also
      * restores the dataCounter value to ensure new transactions receive
-     * the correct IDs. Returns false if the file doesn't exist or can't be read.
+     * the correct IDs, then replays the journal on top. Returns false if neither
+     * the file nor a journal could be read, e.g. for a new user.
      */
     bool loadDataFromFile();
 };
@@ -0,0 +1,161 @@
+#include "csvreader.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @class csvreader.cpp
+ * @brief Implements the CsvReader used to load large CSV exports in parallel.
+ */
+
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+/**
+ * @brief Maps the CSV file at the given path and skips a leading UTF-8 byte-order mark.
+ * @param path Path of the file to map.
+ * @return True if the file was opened.
+ */
+bool CsvReader::open(const std::string& path) {
+    byteOrderMarkSize = 0;
+    if (!file.open(path)) {
+        return false;
+    }
+    if (file.size() >= 3 && std::memcmp(file.data(), "\xEF\xBB\xBF", 3) == 0) {
+        byteOrderMarkSize = 3;
+    }
+    return true;
+}
+
+void CsvReader::close() {
+    file.close();
+    byteOrderMarkSize = 0;
+}
+
+const char* CsvReader::data() const {
+    return file.data() ? file.data() + byteOrderMarkSize : nullptr;
+}
+
+size_t CsvReader::size() const {
+    return file.size() - byteOrderMarkSize;
+}
+
+/**
+ * @brief Cuts the text into chunks of whole records.
+ * @param targetChunkSize Approximate size of each chunk in bytes.
+ * @return Chunks in file order.
+ */
+std::vector<CsvReader::Chunk> CsvReader::split(size_t targetChunkSize) const {
+    std::vector<Chunk> chunks;
+    const char* begin = data();
+    const char* const end = begin + size();
+    if (begin == nullptr || begin == end) {
+        return chunks;
+    }
+    targetChunkSize = std::max<size_t>(targetChunkSize, 1);
+
+    const char* scanned = begin; // Quote state is known up to here
+    bool inQuotes = false;
+    while (static_cast<size_t>(end - begin) > targetChunkSize) {
+        const char* cut = begin + targetChunkSize;
+        inQuotes ^= (std::count(scanned, cut, '"') & 1) != 0;
+
+        // Move the cut forward to the first newline outside quotes
+        const char* p = cut;
+        while (p < end) {
+            if (*p == '"') {
+                inQuotes = !inQuotes;
+            } else if (*p == '\n' && !inQuotes) {
+                break;
+            }
+            ++p;
+        }
+        if (p >= end) {
+            break;
+        }
+
+        chunks.push_back({ begin, p + 1 });
+        begin = p + 1;
+        scanned = begin;
+    }
+    chunks.push_back({ begin, end });
+    return chunks;
+}
+
+/**
+ * @brief Parses the record starting at cursor.
+ * @param cursor Start of a record.
+ * @param end End of the chunk being parsed.
+ * @param fields Receives the record's fields.
+ * @return Start of the next record, or end.
+ */
+const char* CsvReader::nextRecord(const char* cursor, const char* end, std::vector<Field>& fields) {
+    fields.clear();
+    const char* p = cursor;
+    for (;;) {
+        while (p < end && (*p == ' ' || *p == '\t')) {
+            ++p;
+        }
+
+        Field field;
+        if (p < end && *p == '"') {
+            const char* start = ++p;
+            for (;;) {
+                const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p));
+                if (quote == nullptr) {
+                    p = end; // Unterminated quote: take the rest of the chunk
+                    field.text = std::string_view(start, end - start);
+                    break;
+                }
+                if (quote + 1 < end && quote[1] == '"') {
+                    field.escaped = true;
+                    p = quote + 2;
+                    continue;
+                }
+                field.text = std::string_view(start, quote - start);
+                p = quote + 1;
+                break;
+            }
+            while (p < end && *p != ',' && *p != '\n') {
+                ++p; // Anything between the closing quote and the delimiter is ignored
+            }
+        } else {
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '\n') {
+                ++p;
+            }
+            const char* stop = p;
+            while (stop > start && isBlank(stop[-1])) {
+                --stop;
+            }
+            field.text = std::string_view(start, stop - start);
+        }
+        fields.push_back(field);
+
+        if (p < end && *p == ',') {
+            ++p;
+            continue;
+        }
+        return p < end ? p + 1 : end;
+    }
+}
+
+/**
+ * @brief Returns a quoted field's text with each "" collapsed to one quote.
+ * @param field Field returned by nextRecord().
+ */
+std::string CsvReader::unescape(const Field& field) {
+    std::string text;
+    text.reserve(field.text.size());
+    for (size_t i = 0; i < field.text.size(); ++i) {
+        text += field.text[i];
+        if (field.text[i] == '"' && i + 1 < field.text.size() && field.text[i + 1] == '"') {
+            ++i;
+        }
+    }
+    return text;
+}
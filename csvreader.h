@@ -0,0 +1,107 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mappedfile.h"
+
+/**
+ * @class CsvReader
+ * @brief Memory-mapped CSV file that can be cut into chunks and parsed in parallel.
+ *
+ * The file is mapped rather than read, so even very large exports cost no buffer
+ * copies and only the pages being parsed need to be resident. split() cuts the
+ * text into chunks that end on a record boundary, i.e. a newline outside any quoted
+ * field, so each chunk can be handed to a different thread and parsed on its own
+ * with nextRecord(). Quoting follows RFC 4180: a field may be enclosed in double
+ * quotes, inside which commas and newlines are literal and "" stands for one quote.
+ */
+class CsvReader {
+public:
+    /**
+     * @struct Chunk
+     * @brief A run of whole records inside the mapped file.
+     */
+    struct Chunk {
+        const char* begin; // First byte of the first record
+        const char* end;   // One past the last byte of the last record
+    };
+
+    /**
+     * @struct Field
+     * @brief One field of a record, viewing the mapped file.
+     *
+     * Unquoted fields are trimmed of surrounding blanks. For quoted fields the text is
+     * what lies between the quotes; if escaped is set it still contains doubled quotes
+     * and must be passed through unescape() before use.
+     */
+    struct Field {
+        std::string_view text; // Field text inside the mapping
+        bool escaped = false;  // Whether text contains "" sequences
+    };
+
+    CsvReader() = default;
+
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    /**
+     * @brief Maps the CSV file at the given path.
+     * @param path Path of the file to map.
+     * @return True if the file was opened.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close();
+
+    /**
+     * @brief Returns the first byte of CSV text, after any UTF-8 byte-order mark.
+     */
+    const char* data() const;
+
+    /**
+     * @brief Returns the number of bytes of CSV text, excluding any byte-order mark.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Cuts the text into chunks of whole records.
+     * @param targetChunkSize Approximate size of each chunk in bytes.
+     * @return Chunks in file order; together they cover the whole text.
+     *
+     * Each cut is moved forward to the next newline that is not inside a quoted field.
+     * Finding that out takes one pass counting quotes, which is far cheaper than
+     * parsing; a stray unbalanced quote can only make chunks larger, never wrong for
+     * well-formed records.
+     */
+    std::vector<Chunk> split(size_t targetChunkSize) const;
+
+    /**
+     * @brief Parses the record starting at cursor.
+     * @param cursor Start of a record.
+     * @param end End of the chunk being parsed.
+     * @param fields Receives the record's fields; cleared first.
+     * @return Start of the next record, or end.
+     *
+     * An empty line yields a single empty field. A quoted field that is not closed
+     * runs to the end of the chunk.
+     */
+    static const char* nextRecord(const char* cursor, const char* end, std::vector<Field>& fields);
+
+    /**
+     * @brief Returns a quoted field's text with each "" collapsed to one quote.
+     * @param field Field returned by nextRecord().
+     */
+    static std::string unescape(const Field& field);
+
+private:
+    MappedFile file;             // Mapping of the whole CSV file
+    size_t byteOrderMarkSize = 0; // Bytes of UTF-8 BOM skipped at the start
+};
+
+#endif // CSVREADER_H
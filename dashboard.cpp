@@ -7,6 +7,8 @@
  */
 
 #include "dashboard.h"
+#include "logging.h"
+#include "invoicestore.h"
 #include <QTableWidgetItem>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -66,6 +68,13 @@ Dashboard::Dashboard(QWidget* parent) : QWidget(parent)
         }
         });
 
+    // Receivables
+    receivablesLabel = new QLabel("Receivables", this);
+    receivablesLabel->setAlignment(Qt::AlignCenter);
+    receivablesSummaryLabel = new QLabel("No invoices loaded", this);
+    leftLayout->addWidget(receivablesLabel);
+    leftLayout->addWidget(receivablesSummaryLabel);
+
     // Monthly Reports - Initialize with all 12 months
     monthlyReportsLabel = new QLabel("Monthly Revenue", this);
     monthlyReportsLabel->setAlignment(Qt::AlignCenter);
@@ -318,6 +327,29 @@ void Dashboard::updateInventory()
     }
 }
 
+/**
+ * @brief Updates the receivables tile
+ *
+ * Shows the outstanding total and the 0-30/31-60/61-90/90+ day buckets as of today.
+ * The store keeps these current as invoices change, so this does not scan the invoices.
+ */
+void Dashboard::updateReceivables()
+{
+    if (!invoiceStore) {
+        return;
+    }
+    const AgingSummary aging = invoiceStore->receivables(QDate::currentDate());
+    QString text = QString("Outstanding: $%1 (%2 invoices, %3 overdue)")
+        .arg(QString::fromStdString(aging.totalOutstanding.toString()))
+        .arg(aging.outstandingCount)
+        .arg(aging.overdueCount);
+    for (int bucket = 0; bucket < AgingSummary::kBucketCount; ++bucket) {
+        text += QString("\n%1: $%2").arg(ReceivablesAging::bucketLabel(bucket),
+            QString::fromStdString(aging.bucketAmounts[bucket].toString()));
+    }
+    receivablesSummaryLabel->setText(text);
+}
+
 /**
  * @brief Updates monthly reports data
  *
@@ -342,6 +374,16 @@ void Dashboard::setTabWidget(QTabWidget* tabs)
     dashboardTabWidget = tabs;
 }
 
+/**
+ * @brief Sets the invoice store shown by the receivables tile
+ * @param store Pointer to the InvoiceStore
+ */
+void Dashboard::setInvoiceStore(const InvoiceStore* store)
+{
+    invoiceStore = store;
+    updateReceivables();
+}
+
 /**
  * @brief Sets the shared inventory table
  * @param sharedTable Pointer to the inventory QTableWidget
@@ -392,7 +434,7 @@ QTableWidget* Dashboard::getInventoryTable() const
  */
 Dashboard::~Dashboard()
 {
-    qDebug() << "Dashboard destructor started";
+    NOOMYPLAN_LOG_DEBUG(lcApp) << "Dashboard destructor started";
     
     try {
         // Safely disconnect from any signal connections
@@ -409,7 +451,7 @@ Dashboard::~Dashboard()
             inventoryTable = nullptr;
         }
         
-        qDebug() << "Dashboard destructor - starting chart cleanup";
+        NOOMYPLAN_LOG_DEBUG(lcApp) << "Dashboard destructor - starting chart cleanup";
         
         // Just null all pointers without attempting to delete
         // Qt's parent-child mechanism will handle the memory cleanup
@@ -423,13 +465,13 @@ Dashboard::~Dashboard()
         lineChartView = nullptr;
         pieChartView = nullptr;
         
-        qDebug() << "Dashboard destructor completed successfully";
+        NOOMYPLAN_LOG_DEBUG(lcApp) << "Dashboard destructor completed successfully";
     }
     catch (const std::exception& e) {
-        qDebug() << "Exception in Dashboard destructor:" << e.what();
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Exception in Dashboard destructor:" << e.what();
     }
     catch (...) {
-        qDebug() << "Unknown exception in Dashboard destructor";
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Unknown exception in Dashboard destructor";
     }
 }
 
@@ -543,6 +585,7 @@ void Dashboard::onUpdateDashboardClicked()
 {
     updateFinancials();
     updateInventory();
+    updateReceivables();
     updateMonthlyReports();
     updateCharts(); // charts update without showing message box
     showUpdateNotification(); // show the message here only!
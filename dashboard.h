@@ -20,6 +20,8 @@ QT_BEGIN_NAMESPACE
 class QTabWidget;
 QT_END_NAMESPACE
 
+class InvoiceStore;
+
 /**
  * @class Dashboard
  * @brief The Dashboard class represents a widget that displays various financial and inventory data in chart and table formats.
@@ -55,6 +57,12 @@ public:
      */
     void setInventoryTable(QTableWidget* sharedTable);
 
+    /**
+     * @brief Sets the invoice store whose outstanding invoices the receivables tile shows.
+     * @param store Pointer to the InvoiceStore; it must outlive the dashboard.
+     */
+    void setInvoiceStore(const InvoiceStore* store);
+
     /**
      * @brief Gets the inventory table currently displayed in the dashboard.
      * @return Pointer to the QTableWidget containing inventory data.
@@ -91,6 +99,11 @@ public:
      */
     void updateInventory();
 
+    /**
+     * @brief Updates the receivables tile from the invoice store's aging buckets.
+     */
+    void updateReceivables();
+
     /**
      * @brief Updates monthly reports displays.
      */
@@ -131,6 +144,7 @@ private:
 
     QTabWidget* dashboardTabWidget = nullptr;  ///< Pointer to the tab widget
     QTableWidget* inventoryTable = nullptr;    ///< Pointer to the inventory table
+    const InvoiceStore* invoiceStore = nullptr; ///< Invoices summarized by the receivables tile
 
     // Financial labels
     QLabel* cashInflowsLabel;        ///< Label for cash inflows display
@@ -138,6 +152,8 @@ private:
     QLabel* financialsLabel;         ///< Label for financial summary
     QLabel* inventoryLabel;          ///< Label for inventory summary
     QLabel* monthlyReportsLabel;     ///< Label for monthly reports
+    QLabel* receivablesLabel;        ///< Label for the receivables tile
+    QLabel* receivablesSummaryLabel; ///< Outstanding total and aging buckets
 
     QTableWidget* monthlyReportsTable;  ///< Table widget for monthly reports
     QPushButton* editInventoryButton;   ///< Button to edit inventory
@@ -1,23 +1,286 @@
 ﻿#include "financialreport.h"
 #include <QFile>
 #include <QTextStream>
-#include <QDebug>
 #include <QFileInfo>
 #include <QCoreApplication>
 #include <QDir>
-#include <QFileDialog>
-#include <QMessageBox>
+#include <QHash>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
+#include "aggregationkernels.h"
+#include "csvreader.h"
+#include "mappedfile.h"
+#include "logging.h"
+#include "tracing.h"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+
+/**
+ * @brief Writes an amount to a sidecar file as its count of cents.
+ */
+static QDataStream& operator<<(QDataStream& out, Money amount) {
+    return out << qint64(amount.cents());
+}
+
+/**
+ * @brief Reads an amount written by operator<<.
+ */
+static QDataStream& operator>>(QDataStream& in, Money& amount) {
+    qint64 cents = 0;
+    in >> cents;
+    amount = Money::fromCents(cents);
+    return in;
+}
+
+namespace {
+
+static_assert(sizeof(TransactionKind) == sizeof(uint8_t), "kinds are summed as a byte column");
+static_assert(sizeof(qint64) == sizeof(int64_t), "amounts are summed as an int64_t column");
+constexpr size_t kKindCount = 3; // Number of TransactionKind values
+
+/**
+ * @brief Transactions parsed from one chunk of the CSV file.
+ */
+struct ParsedChunk {
+    FinancialReportGenerator::TransactionColumns rows; // Valid rows, in file order
+    qsizetype skippedRows = 0;                         // Malformed or incomplete rows
+};
+
+/**
+ * @brief Converts a CSV field to a QString.
+ */
+QString fieldText(const CsvReader::Field& field) {
+    if (field.escaped) {
+        const std::string text = CsvReader::unescape(field);
+        return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+    }
+    return QString::fromUtf8(field.text.data(), static_cast<qsizetype>(field.text.size()));
+}
+
+/**
+ * @brief Parses one chunk of transactions; runs on a pool thread.
+ * @param chunk Whole records to parse.
+ * @return The chunk's valid rows and the number of rows skipped.
+ *
+ * Rows need at least seven fields, a decimal amount and a non-empty ID, type,
+ * description and category; the header row fails the amount check. Amounts are
+ * parsed straight into cents, so no binary rounding creeps into the totals. Each distinct
+ * type, payment method and category is decoded once per chunk and given a code in
+ * the chunk's name lists. Kinds are left as Other until the merged table is classified.
+ */
+ParsedChunk parseChunk(const CsvReader::Chunk& chunk) {
+    NOOMYPLAN_TRACE_SCOPE("report.parseChunk");
+    ParsedChunk parsed;
+    auto& rows = parsed.rows;
+    rows.reserve((chunk.end - chunk.begin) / 64); // Rough guess at the row length
+
+    QHash<QByteArrayView, quint32> typeCodes;
+    QHash<QByteArrayView, quint32> paymentMethodCodes;
+    QHash<QByteArrayView, quint32> categoryCodes;
+    QHash<QByteArrayView, quint32> monthCodes;
+    auto codeOf = [](QHash<QByteArrayView, quint32>& codes, QStringList& names, const CsvReader::Field& field) {
+        const QByteArrayView key(field.text.data(), static_cast<qsizetype>(field.text.size()));
+        auto existing = codes.constFind(key);
+        if (existing != codes.constEnd()) {
+            return *existing;
+        }
+        const quint32 code = static_cast<quint32>(names.size());
+        names.append(fieldText(field));
+        codes.insert(key, code);
+        return code;
+    };
+
+    std::vector<CsvReader::Field> fields;
+    for (const char* cursor = chunk.begin; cursor < chunk.end;) {
+        cursor = CsvReader::nextRecord(cursor, chunk.end, fields);
+        if (fields.size() == 1 && fields[0].text.empty()) {
+            continue; // Blank line
+        }
+        if (fields.size() < 7 || fields[1].text.empty() || fields[2].text.empty() ||
+            fields[3].text.empty() || fields[6].text.empty()) {
+            ++parsed.skippedRows;
+            continue;
+        }
+
+        Money amount;
+        if (!Money::parse(fields[4].text, amount)) {
+            ++parsed.skippedRows;
+            continue;
+        }
+
+        rows.dates.append(fieldText(fields[0]));
+        rows.transactionIDs.append(fieldText(fields[1]));
+        rows.descriptions.append(fieldText(fields[3]));
+        rows.amounts.append(amount.cents());
+        rows.typeCodes.append(codeOf(typeCodes, rows.typeNames, fields[2]));
+        rows.paymentMethodCodes.append(codeOf(paymentMethodCodes, rows.paymentMethodNames, fields[5]));
+        rows.categoryCodes.append(codeOf(categoryCodes, rows.categoryNames, fields[6]));
+        CsvReader::Field month = fields[0];
+        month.text = month.text.substr(0, 7); // "yyyy-MM"
+        rows.monthCodes.append(codeOf(monthCodes, rows.monthNames, month));
+        rows.kinds.append(TransactionKind::Other);
+    }
+    return parsed;
+}
+
+/**
+ * @brief Adds names to a name list, reusing the codes of names it already has.
+ * @param names Name list to extend.
+ * @param otherNames Names of another table, indexed by that table's codes.
+ * @return The code in names of each entry of otherNames.
+ */
+QVector<quint32> mergeNames(QStringList& names, const QStringList& otherNames) {
+    QHash<QString, quint32> codes;
+    codes.reserve(names.size());
+    for (qsizetype i = 0; i < names.size(); ++i) {
+        codes.insert(names[i], static_cast<quint32>(i));
+    }
+
+    QVector<quint32> translation;
+    translation.reserve(otherNames.size());
+    for (const QString& name : otherNames) {
+        auto existing = codes.constFind(name);
+        if (existing != codes.constEnd()) {
+            translation.append(*existing);
+        } else {
+            translation.append(static_cast<quint32>(names.size()));
+            names.append(name);
+        }
+    }
+    return translation;
+}
+
+/**
+ * @brief Appends another table's codes to a code column, translating each one.
+ */
+void appendCodes(QVector<quint32>& codes, const QVector<quint32>& otherCodes, const QVector<quint32>& translation) {
+    const qsizetype start = codes.size();
+    codes.resize(start + otherCodes.size());
+    for (qsizetype i = 0; i < otherCodes.size(); ++i) {
+        codes[start + i] = translation[otherCodes[i]];
+    }
+}
+
+/**
+ * @brief Returns true if every code indexes a name list of the given size.
+ */
+bool codesInRange(const QVector<quint32>& codes, qsizetype nameCount) {
+    return std::all_of(codes.cbegin(), codes.cend(), [nameCount](quint32 code) {
+        return static_cast<qsizetype>(code) < nameCount;
+        });
+}
+
+/**
+ * @brief Formats an amount for a report, e.g. "1234.50".
+ */
+QString moneyText(Money amount) {
+    char buffer[Money::kMaxFormattedSize];
+    return QString::fromLatin1(buffer, static_cast<qsizetype>(amount.format(buffer)));
+}
+
+} // namespace
+
+void FinancialReportGenerator::TransactionColumns::reserve(qsizetype rows) {
+    dates.reserve(rows);
+    transactionIDs.reserve(rows);
+    descriptions.reserve(rows);
+    amounts.reserve(rows);
+    typeCodes.reserve(rows);
+    paymentMethodCodes.reserve(rows);
+    categoryCodes.reserve(rows);
+    monthCodes.reserve(rows);
+    kinds.reserve(rows);
+}
+
+/**
+ * @brief Appends every row of another table.
+ * @param other Table to append; its names are merged into this table's name lists.
+ */
+void FinancialReportGenerator::TransactionColumns::append(const TransactionColumns& other) {
+    dates.append(other.dates);
+    transactionIDs.append(other.transactionIDs);
+    descriptions.append(other.descriptions);
+    amounts.append(other.amounts);
+    appendCodes(typeCodes, other.typeCodes, mergeNames(typeNames, other.typeNames));
+    appendCodes(paymentMethodCodes, other.paymentMethodCodes, mergeNames(paymentMethodNames, other.paymentMethodNames));
+    appendCodes(categoryCodes, other.categoryCodes, mergeNames(categoryNames, other.categoryNames));
+    appendCodes(monthCodes, other.monthCodes, mergeNames(monthNames, other.monthNames));
+    kinds.append(other.kinds);
+}
+
+/**
+ * @brief Sets the kind of every row.
+ * @param classifier Rules to classify with.
+ *
+ * Mirrors TransactionClassifier::classify(): a mapped type wins over a mapped category,
+ * which wins over a guess from the type and then from the category. The table and
+ * guess lookups are done once per distinct name, so the per-row work is a few loads.
+ */
+void FinancialReportGenerator::TransactionColumns::classify(const TransactionClassifier& classifier) {
+    QVector<std::optional<TransactionKind>> mappedTypeKinds;
+    QVector<TransactionKind> guessedTypeKinds;
+    for (const QString& name : typeNames) {
+        mappedTypeKinds.append(classifier.mappedTypeKind(name));
+        guessedTypeKinds.append(TransactionClassifier::guessKind(name));
+    }
+    QVector<std::optional<TransactionKind>> mappedCategoryKinds;
+    QVector<TransactionKind> guessedCategoryKinds;
+    for (const QString& name : categoryNames) {
+        mappedCategoryKinds.append(classifier.mappedCategoryKind(name));
+        guessedCategoryKinds.append(TransactionClassifier::guessKind(name));
+    }
+
+    kinds.resize(size());
+    for (qsizetype i = 0; i < size(); ++i) {
+        const quint32 type = typeCodes[i];
+        const quint32 category = categoryCodes[i];
+        if (mappedTypeKinds[type]) {
+            kinds[i] = *mappedTypeKinds[type];
+        } else if (mappedCategoryKinds[category]) {
+            kinds[i] = *mappedCategoryKinds[category];
+        } else if (guessedTypeKinds[type] != TransactionKind::Other) {
+            kinds[i] = guessedTypeKinds[type];
+        } else {
+            kinds[i] = guessedCategoryKinds[category];
+        }
+    }
+}
+
+void FinancialReportGenerator::TransactionColumns::clear() {
+    dates.clear();
+    transactionIDs.clear();
+    descriptions.clear();
+    amounts.clear();
+    typeCodes.clear();
+    paymentMethodCodes.clear();
+    categoryCodes.clear();
+    monthCodes.clear();
+    kinds.clear();
+    typeNames.clear();
+    paymentMethodNames.clear();
+    categoryNames.clear();
+    monthNames.clear();
+}
 
 FinancialReportGenerator::FinancialReportGenerator() {
-    transactions = QList<Transaction>();
-    qDebug() << "Constructor: FinancialReportGenerator initialized, transactions size =" << transactions.size();
+    NOOMYPLAN_LOG_DEBUG(lcReport) << "Constructor: FinancialReportGenerator initialized, transactions size =" << transactions.size();
 }
 
 FinancialReportGenerator::~FinancialReportGenerator() {
-    qDebug() << "Destructor: FinancialReportGenerator destroyed";
+    NOOMYPLAN_LOG_DEBUG(lcReport) << "Destructor: FinancialReportGenerator destroyed";
 }
 
-bool FinancialReportGenerator::loadCSV(const QString& filename) {
+/**
+ * @brief Finds a CSV file by probing the given path, the executable and working directories, and the project root.
+ * @param filename The name of the CSV file to look for.
+ * @return The path of the first existing file, or an empty string if none exists.
+ */
+QString FinancialReportGenerator::findCsvFile(const QString& filename) const {
     QStringList possiblePaths;
     possiblePaths << filename;
     possiblePaths << QCoreApplication::applicationDirPath() + "/" + filename;
@@ -31,178 +294,492 @@ bool FinancialReportGenerator::loadCSV(const QString& filename) {
     buildDir.cdUp(); // out
     QString projectRootPath = buildDir.absoluteFilePath("business_financials.csv");
     possiblePaths << projectRootPath;
-    qDebug() << "🔍 Added fallback path (project root): " << projectRootPath;
-
-    QString filePath;
-    bool fileFound = false;
+    NOOMYPLAN_LOG_DEBUG(lcReport) << "🔍 Added fallback path (project root): " << projectRootPath;
 
     for (const QString& path : possiblePaths) {
         QFileInfo check_file(path);
-        qDebug() << "Checking path: " << path << " exists: " << check_file.exists() << " isFile: " << check_file.isFile();
+        NOOMYPLAN_LOG_DEBUG(lcReport) << "Checking path: " << path << " exists: " << check_file.exists() << " isFile: " << check_file.isFile();
         if (check_file.exists() && check_file.isFile()) {
-            filePath = path;
-            fileFound = true;
-            qDebug() << "SUCCESS: File found at:" << filePath;
-            break;
+            NOOMYPLAN_LOG_DEBUG(lcReport) << "SUCCESS: File found at:" << path;
+            return path;
         }
     }
 
-    if (!fileFound) {
-        qDebug() << "ERROR: File not found in any of the checked locations:" << filename;
-        qDebug() << "Checked paths:";
-        for (const QString& path : possiblePaths) {
-            qDebug() << " - " << path;
-        }
+    NOOMYPLAN_LOG_WARNING(lcReport) << "File not found in any of the checked locations:" << filename
+        << "Checked paths:" << possiblePaths;
+    return QString();
+}
+
+bool FinancialReportGenerator::loadCSV(const QString& filename) {
+    const QString filePath = findCsvFile(filename);
+    if (filePath.isEmpty()) {
         return false;
     }
+    return parseFile(filePath, fingerprintOf(filePath));
+}
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "Error: Unable to open file:" << filePath << ", Error:" << file.errorString();
+/**
+ * @brief Loads a CSV file unless the transactions already hold its current contents.
+ * @param filename The name of the CSV file to load.
+ * @return True if transactions from the file are available.
+ *
+ * The file is compared with the fingerprint of the last load: an unchanged path, size
+ * and modification time means the data in memory is reused without reading the file.
+ * If only the modification time differs, e.g. after the file was copied, the contents
+ * are hashed to decide. With the sidecar cache enabled, a sidecar written by an
+ * earlier run is tried next, and only then is the file parsed.
+ */
+bool FinancialReportGenerator::ensureLoaded(const QString& filename) {
+    const QString filePath = findCsvFile(filename);
+    if (filePath.isEmpty()) {
         return false;
     }
 
-    QTextStream in(&file);
-    qDebug() << "Before clearing: transactions size =" << transactions.size();
+    FileFingerprint current = fingerprintOf(filePath);
+    if (!transactions.isEmpty() && hasSameContent(fingerprint, current)) {
+        fingerprint = current;
+        NOOMYPLAN_LOG_DEBUG(lcReport) << "Transactions are up to date with" << filePath << ", skipping parse";
+        return true;
+    }
+    if (sidecarCacheEnabled && readSidecar(current)) {
+        NOOMYPLAN_LOG_DEBUG(lcReport) << "Loaded" << transactions.size() << "transactions from sidecar cache of" << filePath;
+        return true;
+    }
+    return parseFile(filePath, current);
+}
+
+void FinancialReportGenerator::setSidecarCacheEnabled(bool enabled) {
+    sidecarCacheEnabled = enabled;
+}
+
+bool FinancialReportGenerator::isSidecarCacheEnabled() const {
+    return sidecarCacheEnabled;
+}
+
+void FinancialReportGenerator::setClassifier(const TransactionClassifier& newClassifier) {
+    transactionClassifier = newClassifier;
+    transactions.classify(transactionClassifier);
+    summaryValid = false;
+}
+
+const TransactionClassifier& FinancialReportGenerator::classifier() const {
+    return transactionClassifier;
+}
+
+/**
+ * @brief Parses a CSV file into the transactions, replacing any loaded before.
+ * @param filePath Path of an existing CSV file.
+ * @param current Fingerprint of the file without its content hash.
+ * @return True if the file contains valid transactions.
+ *
+ * The content hash for the fingerprint is computed on the thread pool while the
+ * chunks are being parsed, so it adds next to nothing to the load time.
+ */
+bool FinancialReportGenerator::parseFile(const QString& filePath, FileFingerprint current) {
+    NOOMYPLAN_TRACE_SCOPE("report.load");
+    CsvReader reader;
+    if (!reader.open(QFile::encodeName(filePath).toStdString())) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Unable to open file:" << filePath;
+        return false;
+    }
+
+    NOOMYPLAN_LOG_DEBUG(lcReport) << "Replacing" << transactions.size() << "transactions with" << filePath;
     transactions.clear();
-    qDebug() << "After clearing: transactions size =" << transactions.size();
+    fingerprint = FileFingerprint();
+    summaryValid = false;
 
-    int lineNum = 0;
-    const int maxLines = 100000;
+    QFuture<QByteArray> contentHash = QtConcurrent::run(hashContents, QByteArrayView(reader.data(), static_cast<qsizetype>(reader.size())));
 
-    while (!in.atEnd() && lineNum < maxLines) {
-        QString line = in.readLine();
-        lineNum++;
-        if (line.trimmed().isEmpty()) continue;
+    // A few chunks per pool thread keeps every thread busy when chunks parse unevenly
+    const size_t minChunkSize = 1 << 20;
+    const size_t poolThreads = static_cast<size_t>(qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    const std::vector<CsvReader::Chunk> chunks = reader.split(qMax(minChunkSize, reader.size() / (poolThreads * 4)));
 
-        QStringList values = line.split(',');
-        if (values.size() < 7) {
-            qDebug() << "Skipping malformed line " << lineNum << ": " << line;
-            continue;
-        }
+    const QList<ParsedChunk> parsedChunks = QtConcurrent::blockingMapped<QList<ParsedChunk>>(chunks, parseChunk);
 
-        Transaction txn;
-        txn.date = values[0].trimmed();
-        txn.transactionID = values[1].trimmed();
-        txn.type = values[2].trimmed();
-        txn.description = values[3].trimmed();
+    qsizetype totalRows = 0;
+    qsizetype skippedRows = 0;
+    for (const ParsedChunk& parsed : parsedChunks) {
+        totalRows += parsed.rows.size();
+        skippedRows += parsed.skippedRows;
+    }
+    transactions.reserve(totalRows);
+    for (const ParsedChunk& parsed : parsedChunks) {
+        transactions.append(parsed.rows);
+    }
+    transactions.classify(transactionClassifier);
 
-        bool isAmountValid;
-        txn.amount = values[4].trimmed().toDouble(&isAmountValid);
-        if (!isAmountValid) {
-            qDebug() << "Invalid amount on line " << lineNum << ": " << values[4];
-            continue;
-        }
+    current.contentHash = contentHash.result();
+    reader.close();
+    if (skippedRows > 0) {
+        NOOMYPLAN_LOG_INFO(lcReport) << "Skipped" << skippedRows << "malformed or invalid lines";
+    }
+    NOOMYPLAN_LOG_INFO(lcReport) << "Total transactions loaded: " << transactions.size() << "from" << chunks.size() << "chunks";
+    if (transactions.isEmpty()) {
+        return false;
+    }
 
-        txn.paymentMethod = values[5].trimmed();
-        txn.category = values[6].trimmed();
+    fingerprint = current;
+    if (sidecarCacheEnabled) {
+        writeSidecar();
+    }
+    return true;
+}
 
-        if (txn.transactionID.isEmpty() || txn.type.isEmpty() || txn.description.isEmpty() || txn.category.isEmpty()) {
-            qDebug() << "Skipping invalid transaction at line " << lineNum;
-            continue;
-        }
+/**
+ * @brief Describes a file by path, size and modification time; the content hash is left empty.
+ */
+FinancialReportGenerator::FileFingerprint FinancialReportGenerator::fingerprintOf(const QString& filePath) {
+    const QFileInfo info(filePath);
+    FileFingerprint result;
+    result.path = info.absoluteFilePath();
+    result.size = info.size();
+    result.modified = info.lastModified().toMSecsSinceEpoch();
+    return result;
+}
 
-        transactions.append(txn);
+/**
+ * @brief Checks whether a file still has the contents described by an earlier fingerprint.
+ * @param known Fingerprint of the earlier load.
+ * @param current Fingerprint of the file now; its content hash is filled in if it had to be computed.
+ * @return True if the contents are the same.
+ */
+bool FinancialReportGenerator::hasSameContent(const FileFingerprint& known, FileFingerprint& current) {
+    if (known.size < 0 || known.path != current.path || known.size != current.size) {
+        return false;
+    }
+    if (known.modified == current.modified) {
+        current.contentHash = known.contentHash;
+        return true;
     }
+    if (known.contentHash.isEmpty()) {
+        return false;
+    }
+    if (current.contentHash.isEmpty()) {
+        MappedFile file;
+        if (!file.open(QFile::encodeName(current.path).toStdString())) {
+            return false;
+        }
+        current.contentHash = hashContents(QByteArrayView(file.data(), static_cast<qsizetype>(file.size())));
+    }
+    return current.contentHash == known.contentHash;
+}
 
-    file.close();
-    qDebug() << "Total transactions loaded: " << transactions.size();
-    return !transactions.isEmpty();
+/**
+ * @brief Hashes file contents for change detection.
+ */
+QByteArray FinancialReportGenerator::hashContents(QByteArrayView contents) {
+    return QCryptographicHash::hash(contents, QCryptographicHash::Md5);
 }
 
-void FinancialReportGenerator::generateProfitLossStatement(const QString& outputFilename) {
-    if (transactions.isEmpty()) {
-        qDebug() << "Error: No transactions available for generating profit/loss statement";
+/**
+ * @brief Returns the path of the sidecar cache kept next to a CSV file.
+ */
+QString FinancialReportGenerator::sidecarPath(const QString& csvPath) {
+    return csvPath + ".cache";
+}
+
+/**
+ * @brief Saves the transactions and their summary next to the loaded CSV file.
+ *
+ * The sidecar starts with the CSV file's fingerprint so a later run can tell whether
+ * it still matches. It is written to a temporary file first, so a crash never leaves
+ * a half-written cache behind.
+ */
+void FinancialReportGenerator::writeSidecar() {
+    NOOMYPLAN_TRACE_SCOPE("report.saveSidecar");
+    QSaveFile file(sidecarPath(fingerprint.path));
+    if (!file.open(QIODevice::WriteOnly)) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Could not write sidecar cache " << file.fileName() << ", Error:" << file.errorString();
         return;
     }
 
-    double totalIncome = 0.0;
-    double totalExpenses = 0.0;
+    const ReportSummary& totals = summary();
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kSidecarMagic << kSidecarVersion;
+    out << fingerprint.size << fingerprint.modified << fingerprint.contentHash;
+    out << transactions.dates << transactions.transactionIDs << transactions.descriptions << transactions.amounts
+        << transactions.typeCodes << transactions.paymentMethodCodes << transactions.categoryCodes
+        << transactions.monthCodes << transactions.kinds << transactions.typeNames << transactions.paymentMethodNames
+        << transactions.categoryNames << transactions.monthNames;
+    out << transactionClassifier.signature();
+    out << qint64(totals.transactionCount) << totals.totalIncome << totals.totalExpenses
+        << totals.expensesByCategory << totals.totalsByCategory << totals.totalsByType;
+    out << qint32(totals.totalsByMonth.size());
+    for (auto it = totals.totalsByMonth.constBegin(); it != totals.totalsByMonth.constEnd(); ++it) {
+        out << it.key() << it.value().income << it.value().expenses;
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Could not write sidecar cache " << file.fileName() << ", Error:" << file.errorString();
+    }
+}
+
+/**
+ * @brief Loads the transactions from the sidecar cache of a CSV file if it matches the file.
+ * @param current Fingerprint of the CSV file now.
+ * @return True if the sidecar matched and was loaded; otherwise nothing is changed.
+ *
+ * Kinds and the summary in the sidecar are only kept if they were computed with the
+ * same classification rules as the current ones; otherwise the rows are classified again.
+ */
+bool FinancialReportGenerator::readSidecar(FileFingerprint& current) {
+    NOOMYPLAN_TRACE_SCOPE("report.loadSidecar");
+    QFile file(sidecarPath(current.path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kSidecarMagic || version != kSidecarVersion) {
+        return false;
+    }
 
-    for (const auto& txn : transactions) {
-        if (txn.type == "Income") totalIncome += txn.amount;
-        else if (txn.type == "Expense") totalExpenses += txn.amount;
+    FileFingerprint stored;
+    stored.path = current.path;
+    in >> stored.size >> stored.modified >> stored.contentHash;
+    if (in.status() != QDataStream::Ok || !hasSameContent(stored, current)) {
+        return false;
     }
 
-    double netProfit = totalIncome - totalExpenses;
+    TransactionColumns rows;
+    QByteArray classifierSignature;
+    in >> rows.dates >> rows.transactionIDs >> rows.descriptions >> rows.amounts
+       >> rows.typeCodes >> rows.paymentMethodCodes >> rows.categoryCodes
+       >> rows.monthCodes >> rows.kinds >> rows.typeNames >> rows.paymentMethodNames
+       >> rows.categoryNames >> rows.monthNames;
+    in >> classifierSignature;
+
+    ReportSummary totals;
+    qint64 transactionCount = 0;
+    qint32 monthCount = 0;
+    in >> transactionCount >> totals.totalIncome >> totals.totalExpenses
+       >> totals.expensesByCategory >> totals.totalsByCategory >> totals.totalsByType >> monthCount;
+    for (qint32 i = 0; i < monthCount && in.status() == QDataStream::Ok; ++i) {
+        QString month;
+        MonthTotals monthTotals;
+        in >> month >> monthTotals.income >> monthTotals.expenses;
+        totals.totalsByMonth.insert(month, monthTotals);
+    }
+    totals.transactionCount = transactionCount;
+
+    const qsizetype rowCount = rows.amounts.size();
+    const bool columnsMatch = rows.dates.size() == rowCount && rows.transactionIDs.size() == rowCount &&
+        rows.descriptions.size() == rowCount && rows.typeCodes.size() == rowCount &&
+        rows.paymentMethodCodes.size() == rowCount && rows.categoryCodes.size() == rowCount &&
+        rows.monthCodes.size() == rowCount && rows.kinds.size() == rowCount &&
+        codesInRange(rows.typeCodes, rows.typeNames.size()) &&
+        codesInRange(rows.paymentMethodCodes, rows.paymentMethodNames.size()) &&
+        codesInRange(rows.categoryCodes, rows.categoryNames.size()) &&
+        codesInRange(rows.monthCodes, rows.monthNames.size()) &&
+        std::all_of(rows.kinds.cbegin(), rows.kinds.cend(), [](TransactionKind kind) {
+            return static_cast<size_t>(kind) < kKindCount;
+            });
+    if (in.status() != QDataStream::Ok || !columnsMatch || rowCount == 0 || transactionCount != rowCount) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Ignoring damaged sidecar cache " << file.fileName();
+        return false;
+    }
+
+    transactions = std::move(rows);
+    fingerprint = current;
+    if (classifierSignature == transactionClassifier.signature()) {
+        cachedSummary = std::move(totals);
+        summaryValid = true;
+    } else {
+        transactions.classify(transactionClassifier);
+        summaryValid = false;
+    }
+    return true;
+}
+
+const FinancialReportGenerator::ReportSummary& FinancialReportGenerator::summary() {
+    if (!summaryValid) {
+        cachedSummary = summarize();
+        summaryValid = true;
+    }
+    return cachedSummary;
+}
+
+/**
+ * @brief Computes every report aggregate in a single scan of the transactions.
+ * @return Totals overall and per category, type and month.
+ *
+ * Works on the amount, kind and code columns with the AggregationKernels: masked sums
+ * give the income and expense totals, and grouped sums give the per-type totals and,
+ * split by kind, the per-category and per-month totals. No strings are touched until
+ * the per-code sums are turned into the summary's maps. Income and expenses are told
+ * apart by each row's classified kind, so every income- or expense-like type counts.
+ * Categories and months only appear in the income/expense maps if their sums are non-zero.
+ */
+FinancialReportGenerator::ReportSummary FinancialReportGenerator::summarize() const {
+    NOOMYPLAN_TRACE_SCOPE("report.aggregate");
+    ReportSummary result;
+    result.transactionCount = transactions.size();
+
+    const size_t rowCount = static_cast<size_t>(transactions.size());
+    const int64_t* amounts = reinterpret_cast<const int64_t*>(transactions.amounts.constData());
+    const uint8_t* kinds = reinterpret_cast<const uint8_t*>(transactions.kinds.constData());
+    const auto income = static_cast<size_t>(TransactionKind::Income);
+    const auto expense = static_cast<size_t>(TransactionKind::Expense);
+
+    // The kernels report an overflow instead of wrapping; fail the way Money's arithmetic does
+    const auto checked = [](bool fits) {
+        if (!fits) {
+            throw std::overflow_error("Money overflow in report totals");
+        }
+    };
+
+    int64_t incomeCents = 0;
+    int64_t expenseCents = 0;
+    checked(AggregationKernels::maskedSum(amounts, kinds, rowCount, static_cast<uint8_t>(income), incomeCents));
+    checked(AggregationKernels::maskedSum(amounts, kinds, rowCount, static_cast<uint8_t>(expense), expenseCents));
+    result.totalIncome = Money::fromCents(incomeCents);
+    result.totalExpenses = Money::fromCents(expenseCents);
+
+    const size_t typeCount = static_cast<size_t>(transactions.typeNames.size());
+    QVector<int64_t> typeTotals(typeCount, 0);
+    checked(AggregationKernels::groupedSum(amounts, transactions.typeCodes.constData(), rowCount, typeCount, typeTotals.data()));
+
+    const size_t categoryCount = static_cast<size_t>(transactions.categoryNames.size());
+    QVector<int64_t> categoryTotals(categoryCount * kKindCount, 0);
+    checked(AggregationKernels::groupedSumByKey(amounts, transactions.categoryCodes.constData(), kinds, rowCount,
+        categoryCount, kKindCount, categoryTotals.data()));
+
+    const size_t monthCount = static_cast<size_t>(transactions.monthNames.size());
+    QVector<int64_t> monthTotals(monthCount * kKindCount, 0);
+    checked(AggregationKernels::groupedSumByKey(amounts, transactions.monthCodes.constData(), kinds, rowCount,
+        monthCount, kKindCount, monthTotals.data()));
+
+    for (size_t code = 0; code < typeCount; ++code) {
+        result.totalsByType.insert(transactions.typeNames[code], Money::fromCents(typeTotals[code]));
+    }
+    for (size_t code = 0; code < categoryCount; ++code) {
+        const int64_t* totals = categoryTotals.constData() + code * kKindCount;
+        result.totalsByCategory.insert(transactions.categoryNames[code],
+            Money::fromCents(totals[0]) + Money::fromCents(totals[1]) + Money::fromCents(totals[2]));
+        if (totals[expense] != 0) { // Categories without expenses stay out of the breakdown
+            result.expensesByCategory.insert(transactions.categoryNames[code], Money::fromCents(totals[expense]));
+        }
+    }
+    for (size_t code = 0; code < monthCount; ++code) {
+        if (monthTotals[code * kKindCount + income] == 0 && monthTotals[code * kKindCount + expense] == 0) {
+            continue; // Nothing but transfers in this month
+        }
+        MonthTotals& month = result.totalsByMonth[transactions.monthNames[code]];
+        month.income = Money::fromCents(monthTotals[code * kKindCount + income]);
+        month.expenses = Money::fromCents(monthTotals[code * kKindCount + expense]);
+    }
+    return result;
+}
+
+qsizetype FinancialReportGenerator::transactionCount() const {
+    return transactions.size();
+}
+
+FinancialReportGenerator::Transaction FinancialReportGenerator::transactionAt(qsizetype row) const {
+    return Transaction{
+        transactions.dates[row],
+        transactions.transactionIDs[row],
+        transactions.type(row),
+        transactions.descriptions[row],
+        Money::fromCents(transactions.amounts[row]),
+        transactions.paymentMethod(row),
+        transactions.category(row),
+        transactions.kinds[row]
+    };
+}
+
+bool FinancialReportGenerator::generateProfitLossStatement(const QString& outputFilename) {
+    NOOMYPLAN_TRACE_SCOPE("report.saveProfitLoss");
+    if (transactions.isEmpty()) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: No transactions available for generating profit/loss statement";
+        return false;
+    }
+
+    const ReportSummary& totals = summary();
+    Money totalIncome = totals.totalIncome;
+    Money totalExpenses = totals.totalExpenses;
+    Money netProfit = totalIncome - totalExpenses;
 
     QFile file(outputFilename);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
-        return;
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+        return false;
     }
 
     QTextStream out(&file);
     out << "Profit & Loss Statement\n";
     out << "------------------------\n";
-    out << "Total Income: $" << totalIncome << "\n";
-    out << "Total Expenses: $" << totalExpenses << "\n";
-    out << "Net Profit: $" << netProfit << "\n";
+    out << "Total Income: $" << moneyText(totalIncome) << "\n";
+    out << "Total Expenses: $" << moneyText(totalExpenses) << "\n";
+    out << "Net Profit: $" << moneyText(netProfit) << "\n";
     file.close();
 
-    qDebug() << "Profit & Loss Statement saved to " << outputFilename;
+    NOOMYPLAN_LOG_INFO(lcReport) << "Profit & Loss Statement saved to " << outputFilename;
+    return true;
 }
 
-void FinancialReportGenerator::generateExpenseBreakdownReport(const QString& outputFilename) {
+bool FinancialReportGenerator::generateExpenseBreakdownReport(const QString& outputFilename) {
+    NOOMYPLAN_TRACE_SCOPE("report.saveExpenseBreakdown");
     if (transactions.isEmpty()) {
-        qDebug() << "Error: No transactions available for generating expense breakdown";
-        return;
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: No transactions available for generating expense breakdown";
+        return false;
     }
 
-    QMap<QString, double> expenseCategories;
-    for (const auto& txn : transactions) {
-        if (txn.type == "Expense") expenseCategories[txn.category] += txn.amount;
-    }
+    const QMap<QString, Money>& expenseCategories = summary().expensesByCategory;
 
     if (expenseCategories.isEmpty()) {
-        qDebug() << "Warning: No expense transactions found";
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Warning: No expense transactions found";
     }
 
     QFile file(outputFilename);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
-        return;
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+        return false;
     }
 
     QTextStream out(&file);
     out << "Expense Breakdown Report\n";
     out << "------------------------\n";
     for (auto it = expenseCategories.constBegin(); it != expenseCategories.constEnd(); ++it) {
-        out << it.key() << ": $" << it.value() << "\n";
+        out << it.key() << ": $" << moneyText(it.value()) << "\n";
     }
     file.close();
-    qDebug() << "Expense Breakdown Report saved to " << outputFilename;
+    NOOMYPLAN_LOG_INFO(lcReport) << "Expense Breakdown Report saved to " << outputFilename;
+    return true;
 }
 
-void FinancialReportGenerator::generateBalanceSheetReport(const QString& outputFilename) {
+bool FinancialReportGenerator::generateBalanceSheetReport(const QString& outputFilename) {
+    NOOMYPLAN_TRACE_SCOPE("report.saveBalanceSheet");
     if (transactions.isEmpty()) {
-        qDebug() << "Error: No transactions available for generating balance sheet";
-        return;
-    }
-
-    double totalAssets = 0.0;
-    double totalLiabilities = 0.0;
-
-    for (const auto& txn : transactions) {
-        if (txn.type == "Income") totalAssets += txn.amount;
-        else if (txn.type == "Expense") totalLiabilities += txn.amount;
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: No transactions available for generating balance sheet";
+        return false;
     }
 
-    double netWorth = totalAssets - totalLiabilities;
+    const ReportSummary& totals = summary();
+    Money totalAssets = totals.totalIncome;
+    Money totalLiabilities = totals.totalExpenses;
+    Money netWorth = totalAssets - totalLiabilities;
 
     QFile file(outputFilename);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qDebug() << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
-        return;
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Could not write to " << outputFilename << ", Error:" << file.errorString();
+        return false;
     }
 
     QTextStream out(&file);
     out << "Balance Sheet Report\n";
     out << "----------------------\n";
-    out << "Total Assets: $" << totalAssets << "\n";
-    out << "Total Liabilities: $" << totalLiabilities << "\n";
-    out << "Net Worth: $" << netWorth << "\n";
+    out << "Total Assets: $" << moneyText(totalAssets) << "\n";
+    out << "Total Liabilities: $" << moneyText(totalLiabilities) << "\n";
+    out << "Net Worth: $" << moneyText(netWorth) << "\n";
     file.close();
 
-    qDebug() << "Balance Sheet Report saved to " << outputFilename;
+    NOOMYPLAN_LOG_INFO(lcReport) << "Balance Sheet Report saved to " << outputFilename;
+    return true;
 }
@@ -2,8 +2,14 @@
 #define FINANCIALREPORT_H
 
 #include <QString>
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QList>
 #include <QMap>
+#include <QVector>
+#include <QStringList>
+#include "money.h"
+#include "transactionclassifier.h"
 
 /**
  * @class FinancialReportGenerator
@@ -12,7 +18,10 @@
  * This class is responsible for loading financial transactions from a CSV file,
  * processing them, and generating various financial reports. It supports operations
  * such as loading transactions, generating profit/loss statements, expense breakdowns,
- * and balance sheets.
+ * and balance sheets. The CSV file is memory-mapped and parsed in parallel chunks into
+ * column-wise storage, so multi-million-row exports load in seconds. Loaded data is
+ * remembered together with a fingerprint of the file, so asking for the same unchanged
+ * file again skips parsing; it can also be kept in a binary sidecar file across runs.
  *
  * @author Simran Kullar
  */
@@ -51,9 +60,122 @@ public:
         QString transactionID; // The unique ID of the transaction.
         QString type; // The type of the transaction (e.g., "Income" or "Expense").
         QString description; // A description of the transaction.
-        double amount; // The amount of the transaction.
+        Money amount; // The amount of the transaction.
         QString paymentMethod; // The payment method used for the transaction.
         QString category; // The category of the transaction (e.g., "Food", "Transport").
+        TransactionKind kind; // Whether the transaction counts as income, expense or neither.
+    };
+
+    /**
+     * @struct TransactionColumns
+     * @brief Loaded transactions stored column by column.
+     *
+     * Row i of the table is element i of every column. Reports only read a few columns,
+     * so keeping each one contiguous lets them scan just what they need. Types, payment
+     * methods and categories repeat a lot, so rows store a small code into a per-table
+     * list of distinct names instead of the text. Each row's TransactionKind is worked
+     * out once at load, so reports branch on integers rather than compare strings. The
+     * amount, kind and code columns are plain arrays that the AggregationKernels sum.
+     */
+    struct TransactionColumns {
+        QVector<QString> dates; // Date of each transaction.
+        QVector<QString> transactionIDs; // ID of each transaction.
+        QVector<QString> descriptions; // Description of each transaction.
+        QVector<qint64> amounts; // Amount of each transaction, in cents (Money::cents()).
+        QVector<quint32> typeCodes; // Type of each transaction, as an index into typeNames.
+        QVector<quint32> paymentMethodCodes; // Payment method of each transaction, as an index into paymentMethodNames.
+        QVector<quint32> categoryCodes; // Category of each transaction, as an index into categoryNames.
+        QVector<quint32> monthCodes; // "yyyy-MM" month of each transaction, as an index into monthNames.
+        QVector<TransactionKind> kinds; // Kind of each transaction, filled in by classify().
+        QStringList typeNames; // Distinct types, indexed by type code.
+        QStringList paymentMethodNames; // Distinct payment methods, indexed by payment method code.
+        QStringList categoryNames; // Distinct categories, indexed by category code.
+        QStringList monthNames; // Distinct "yyyy-MM" months, indexed by month code.
+
+        /**
+         * @brief Returns the type of a row.
+         */
+        const QString& type(qsizetype row) const { return typeNames[typeCodes[row]]; }
+
+        /**
+         * @brief Returns the payment method of a row.
+         */
+        const QString& paymentMethod(qsizetype row) const { return paymentMethodNames[paymentMethodCodes[row]]; }
+
+        /**
+         * @brief Returns the category of a row.
+         */
+        const QString& category(qsizetype row) const { return categoryNames[categoryCodes[row]]; }
+
+        /**
+         * @brief Returns the number of rows.
+         */
+        qsizetype size() const { return amounts.size(); }
+
+        /**
+         * @brief Returns true if there are no rows.
+         */
+        bool isEmpty() const { return amounts.isEmpty(); }
+
+        /**
+         * @brief Reserves space for the given number of rows in every column.
+         */
+        void reserve(qsizetype rows);
+
+        /**
+         * @brief Appends every row of another table, translating its codes to this table's names.
+         */
+        void append(const TransactionColumns& other);
+
+        /**
+         * @brief Sets the kind of every row.
+         *
+         * Each distinct type and category is classified once; rows then combine the two
+         * answers by code.
+         */
+        void classify(const TransactionClassifier& classifier);
+
+        /**
+         * @brief Removes every row.
+         */
+        void clear();
+    };
+
+    /**
+     * @struct MonthTotals
+     * @brief Income and expenses of one calendar month.
+     */
+    struct MonthTotals {
+        Money income; // Income booked in the month.
+        Money expenses; // Expenses booked in the month.
+    };
+
+    /**
+     * @struct ReportSummary
+     * @brief Every aggregate the reports need, computed in one pass over the transactions.
+     *
+     * Built on first use after a load and then shared by all generate* methods, so
+     * producing every report costs one parse and one scan.
+     */
+    struct ReportSummary {
+        qsizetype transactionCount = 0; // Number of transactions summarized.
+        Money totalIncome; // Sum of income amounts.
+        Money totalExpenses; // Sum of expense amounts.
+        QMap<QString, Money> expensesByCategory; // Expense amounts per category.
+        QMap<QString, Money> totalsByCategory; // All amounts per category.
+        QMap<QString, Money> totalsByType; // All amounts per transaction type.
+        QMap<QString, MonthTotals> totalsByMonth; // Income and expenses per "yyyy-MM" month.
+    };
+
+    /**
+     * @struct FileFingerprint
+     * @brief Identifies the contents of a CSV file at the time it was loaded.
+     */
+    struct FileFingerprint {
+        QString path; // Absolute path of the file.
+        qint64 size = -1; // Size in bytes, -1 if nothing was loaded.
+        qint64 modified = 0; // Last modification time in ms since the epoch.
+        QByteArray contentHash; // MD5 of the contents, empty if not computed.
     };
 
     /**
@@ -61,13 +183,70 @@ public:
      *
      * This function attempts to locate the CSV file in multiple possible locations,
      * including the executable directory, current working directory, and user-specified paths.
-     * If the file is found, it reads and parses the transactions, storing them in the `transactions` list.
+     * If the file is found, it reads and parses the transactions, storing them in the `transactions` table.
+     * Fields may be quoted as described in RFC 4180; there is no limit on the number of rows.
      *
      * @param filename The name of the CSV file to load.
      * @return True if the file was successfully loaded and contains valid transactions, false otherwise.
      */
     bool loadCSV(const QString& filename);
 
+    /**
+     * @brief Loads a CSV file unless the loaded transactions already hold its current contents.
+     *
+     * Lets several reports be generated from one parse of the same file. The file's path,
+     * size, modification time and, if those disagree, content hash are compared with the
+     * last load, so changes to the file are always picked up. With the sidecar cache
+     * enabled, a matching sidecar from an earlier run is loaded instead of parsing.
+     *
+     * @param filename The name of the CSV file to load.
+     * @return True if transactions from the file are available.
+     */
+    bool ensureLoaded(const QString& filename);
+
+    /**
+     * @brief Turns the binary sidecar cache on or off; it is off by default.
+     *
+     * When on, every parse writes "<file>.cache" next to the CSV file holding the parsed
+     * transactions and their summary, and ensureLoaded() reads it back if it still
+     * matches the CSV file.
+     */
+    void setSidecarCacheEnabled(bool enabled);
+
+    /**
+     * @brief Returns true if the binary sidecar cache is enabled.
+     */
+    bool isSidecarCacheEnabled() const;
+
+    /**
+     * @brief Replaces the rules that decide which transactions are income and expenses.
+     *
+     * Transactions that are already loaded are classified again.
+     */
+    void setClassifier(const TransactionClassifier& newClassifier);
+
+    /**
+     * @brief Returns the rules that decide which transactions are income and expenses.
+     */
+    const TransactionClassifier& classifier() const;
+
+    /**
+     * @brief Returns the aggregates of the loaded transactions, computing them on first use.
+     * @throws std::overflow_error if a total does not fit in Money.
+     */
+    const ReportSummary& summary();
+
+    /**
+     * @brief Returns the number of loaded transactions.
+     */
+    qsizetype transactionCount() const;
+
+    /**
+     * @brief Returns one loaded transaction as a row.
+     * @param row Index of the transaction, below transactionCount().
+     */
+    Transaction transactionAt(qsizetype row) const;
+
     /**
      * @brief Generates a Profit & Loss Statement and saves it to a file.
      *
@@ -75,8 +254,9 @@ public:
      * from the loaded transactions and writes the results to the specified output file.
      *
      * @param outputFilename The path to the file where the Profit & Loss Statement will be saved.
+     * @return True if the report was written; false if nothing is loaded or the file cannot be written.
      */
-    void generateProfitLossStatement(const QString& outputFilename);
+    bool generateProfitLossStatement(const QString& outputFilename);
 
     /**
      * @brief Generates an Expense Breakdown Report and saves it to a file.
@@ -85,8 +265,9 @@ public:
      * amount spent in each category. The results are written to the specified output file.
      *
      * @param outputFilename The path to the file where the Expense Breakdown Report will be saved.
+     * @return True if the report was written; false if nothing is loaded or the file cannot be written.
      */
-    void generateExpenseBreakdownReport(const QString& outputFilename);
+    bool generateExpenseBreakdownReport(const QString& outputFilename);
 
     /**
      * @brief Generates a Balance Sheet Report and saves it to a file.
@@ -95,11 +276,66 @@ public:
      * from the loaded transactions and writes the results to the specified output file.
      *
      * @param outputFilename The path to the file where the Balance Sheet Report will be saved.
+     * @return True if the report was written; false if nothing is loaded or the file cannot be written.
      */
-    void generateBalanceSheetReport(const QString& outputFilename);
+    bool generateBalanceSheetReport(const QString& outputFilename);
 
 private:
-    QList<Transaction> transactions; // List of transactions loaded from the CSV file.
+    static constexpr quint32 kSidecarMagic = 0x4E505243; // "NPRC" at the start of sidecar files
+    static constexpr quint32 kSidecarVersion = 4; // Layout version of sidecar files; 3 adds month codes, 4 stores cents
+
+    /**
+     * @brief Finds a CSV file in the user-given, executable, working and project root directories.
+     */
+    QString findCsvFile(const QString& filename) const;
+
+    /**
+     * @brief Parses a CSV file into the transactions and records its fingerprint.
+     */
+    bool parseFile(const QString& filePath, FileFingerprint current);
+
+    /**
+     * @brief Describes a file by path, size and modification time.
+     */
+    static FileFingerprint fingerprintOf(const QString& filePath);
+
+    /**
+     * @brief Checks whether a file still has the contents an earlier fingerprint describes.
+     */
+    static bool hasSameContent(const FileFingerprint& known, FileFingerprint& current);
+
+    /**
+     * @brief Hashes file contents for change detection.
+     */
+    static QByteArray hashContents(QByteArrayView contents);
+
+    /**
+     * @brief Returns the path of the sidecar cache of a CSV file.
+     */
+    static QString sidecarPath(const QString& csvPath);
+
+    /**
+     * @brief Saves the transactions and their summary to the sidecar cache.
+     */
+    void writeSidecar();
+
+    /**
+     * @brief Loads the transactions from the sidecar cache if it matches the CSV file.
+     */
+    bool readSidecar(FileFingerprint& current);
+
+    /**
+     * @brief Computes every report aggregate in a single scan of the transactions.
+     * @throws std::overflow_error if a total does not fit in Money.
+     */
+    ReportSummary summarize() const;
+
+    TransactionColumns transactions; // Transactions loaded from the CSV file.
+    FileFingerprint fingerprint; // File the transactions were loaded from.
+    bool sidecarCacheEnabled = false; // Whether loads read and write sidecar caches.
+    TransactionClassifier transactionClassifier; // Decides the kind of each transaction.
+    ReportSummary cachedSummary; // Aggregates of transactions, valid if summaryValid.
+    bool summaryValid = false; // Whether cachedSummary matches transactions.
 };
 
 #endif // FINANCIALREPORT_H
\ No newline at end of file
@@ -1,15 +1,15 @@
 #include "inventory.h"
+#include "jsonstream.h"
+#include "tracing.h"
 #include <QVBoxLayout>
 #include <QLabel>
 #include <QPushButton>
 #include <QMessageBox>
-#include <QJsonDocument>
 #include <QFile>
-#include <QJsonArray>
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDir>
-#include <QDebug>
+#include "logging.h"
 
 /**
  * @brief Constructs the InventoryPage widget.
@@ -103,7 +103,7 @@ void InventoryPage::setupUI() {
  * Clears the input fields after successful addition, and then displays a warning if not complete.
  */
 void InventoryPage::addItem() {
-    qDebug() << "Add item clicked!";
+    NOOMYPLAN_LOG_DEBUG(lcInventory) << "Add item clicked!";
     QString name = itemNameInput->text();
     QString quantity = itemQuantityInput->text();
     QString price = priceInput->text();
@@ -139,7 +139,7 @@ void InventoryPage::addItem() {
  * Ensures that an item is selected before removal and then will alert the user with a warning if there is no selection.
  */
 void InventoryPage::removeItem() {
-    qDebug() << "Remove item clicked!";
+    NOOMYPLAN_LOG_DEBUG(lcInventory) << "Remove item clicked!";
     if (!sharedInventoryTable) return;
     int currentRow = sharedInventoryTable->currentRow();
     if (currentRow >= 0) {
@@ -157,7 +157,7 @@ void InventoryPage::removeItem() {
  * Clears the input fields post-update and alerts if no item is selected.
  */
 void InventoryPage::updateItem() {
-    qDebug() << "Update item clicked!";
+    NOOMYPLAN_LOG_DEBUG(lcInventory) << "Update item clicked!";
     if (!sharedInventoryTable) return;
     int currentRow = sharedInventoryTable->currentRow();
 
@@ -221,18 +221,7 @@ void InventoryPage::setCurrentUserId(const QString& id) {
  */
 void InventoryPage::saveInventoryData() {
     if (currentUserId.isEmpty() || !sharedInventoryTable) return;
-
-    QJsonArray inventoryArray;
-    for (int row = 0; row < sharedInventoryTable->rowCount(); ++row) {
-        QJsonObject obj;
-        obj["name"] = sharedInventoryTable->item(row, 0)->text();
-        obj["quantity"] = sharedInventoryTable->item(row, 1)->text();
-        obj["price"] = sharedInventoryTable->item(row, 2)->text();
-        inventoryArray.append(obj);
-    }
-
-    QJsonObject root;
-    root["inventory"] = inventoryArray;
+    NOOMYPLAN_TRACE_SCOPE("inventory.save");
 
     // Use a consistent location across computers
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
@@ -247,11 +236,27 @@ void InventoryPage::saveInventoryData() {
     QFile file(filePath);
     
     if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(root).toJson());
-        file.close();
-        qDebug() << "Inventory saved to:" << filePath;
+        // {"inventory":[...]}, written row by row
+        JsonStreamWriter writer(&file);
+        writer.beginObject();
+        writer.key("inventory");
+        writer.beginArray();
+        for (int row = 0; row < sharedInventoryTable->rowCount(); ++row) {
+            QJsonObject obj;
+            obj["name"] = sharedInventoryTable->item(row, 0)->text();
+            obj["quantity"] = sharedInventoryTable->item(row, 1)->text();
+            obj["price"] = sharedInventoryTable->item(row, 2)->text();
+            writer.value(obj);
+        }
+        writer.endArray();
+        writer.endObject();
+        if (writer.flush()) {
+            NOOMYPLAN_LOG_INFO(lcInventory) << "Inventory saved to:" << filePath;
+        } else {
+            NOOMYPLAN_LOG_WARNING(lcInventory) << "Failed to save inventory:" << file.errorString();
+        }
     } else {
-        qDebug() << "Failed to save inventory:" << file.errorString();
+        NOOMYPLAN_LOG_WARNING(lcInventory) << "Failed to save inventory:" << file.errorString();
     }
 }
 
@@ -260,10 +265,11 @@ void InventoryPage::saveInventoryData() {
  * @param userId The ID of the user whose inventory data should be loaded.
  */
 void InventoryPage::loadInventoryData(const QString& userId) {
+    NOOMYPLAN_TRACE_SCOPE("inventory.load");
     currentUserId = userId;
     
     if (!sharedInventoryTable) {
-        qDebug() << "sharedInventoryTable is null!";
+        NOOMYPLAN_LOG_WARNING(lcInventory) << "sharedInventoryTable is null!";
         return;
     }
 
@@ -273,30 +279,31 @@ void InventoryPage::loadInventoryData(const QString& userId) {
     QFile file(filePath);
 
     if (!file.exists()) {
-        qDebug() << "No inventory file found for user:" << userId;
+        NOOMYPLAN_LOG_DEBUG(lcInventory) << "No inventory file found for user:" << userId;
         return;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Failed to open inventory file:" << file.errorString();
+        NOOMYPLAN_LOG_WARNING(lcInventory) << "Failed to open inventory file:" << file.errorString();
         return;
     }
 
     sharedInventoryTable->setRowCount(0);
-    
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
-    file.close();
 
-    QJsonArray inventoryArray = doc["inventory"].toArray();
-    for (const QJsonValue& val : inventoryArray) {
-        QJsonObject obj = val.toObject();
+    QString error;
+    const bool parsed = JsonStreamReader::readObjectArray(&file, "inventory", [this](const QJsonObject& obj) {
         int row = sharedInventoryTable->rowCount();
         sharedInventoryTable->insertRow(row);
         sharedInventoryTable->setItem(row, 0, new QTableWidgetItem(obj["name"].toString()));
         sharedInventoryTable->setItem(row, 1, new QTableWidgetItem(obj["quantity"].toString()));
         sharedInventoryTable->setItem(row, 2, new QTableWidgetItem(obj["price"].toString()));
+        }, nullptr, &error);
+    file.close();
+
+    if (!parsed) {
+        NOOMYPLAN_LOG_WARNING(lcInventory) << "Inventory file is damaged:" << error;
     }
-    qDebug() << "Loaded" << inventoryArray.size() << "inventory items";
+    NOOMYPLAN_LOG_INFO(lcInventory) << "Loaded" << sharedInventoryTable->rowCount() << "inventory items";
 }
 
 /**
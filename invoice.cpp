@@ -1,25 +1,23 @@
 #include "invoice.h"
 
-int Invoice::invoiceCounter = 1;
-
 /**
  * @brief Default constructor.
  *
  * Initializes the invoice with default values:
- * - invoice ID auto-incremented from static counter
- * - amount set to 0.0
+ * - invoice ID 0 until InvoiceStore assigns one
+ * - amount set to zero
  * - due date set to current date
  * - status set to "Pending"
  */
 Invoice::Invoice()
-    : invoiceID(invoiceCounter++), amount(0.0), dueDate(QDate::currentDate()), status("Pending") {
+    : invoiceID(0), amount(), dueDate(QDate::currentDate()), status("Pending") {
 }
 
 /**
  * @brief Parameterized constructor.
  *
  * Initializes an invoice with specified values:
- * - assigns unique invoice ID
+ * - invoice ID 0 until InvoiceStore assigns one
  * - sets customer name, address, amount, and due date
  * - status defaults to "Pending"
  *
@@ -28,8 +26,8 @@ Invoice::Invoice()
  * @param amount The total invoice amount.
  * @param dueDate The payment due date.
  */
-Invoice::Invoice(const QString& customerName, const QString& customerAddress, double amount, const QDate& dueDate)
-    : invoiceID(invoiceCounter++), customerName(customerName), customerAddress(customerAddress), amount(amount), dueDate(dueDate), status("Pending") {
+Invoice::Invoice(const QString& customerName, const QString& customerAddress, Money amount, const QDate& dueDate)
+    : invoiceID(0), customerName(customerName), customerAddress(customerAddress), amount(amount), dueDate(dueDate), status("Pending") {
 }
 
 
@@ -40,7 +38,7 @@ QString Invoice::getCustomerName() const { return customerName; }
 QString Invoice::getCustomerAddress() const { return customerAddress; }
 
 /** @return The amount due on the invoice. */
-double Invoice::getAmount() const { return amount; }
+Money Invoice::getAmount() const { return amount; }
 
 /** @return The date by which payment is due. */
 QDate Invoice::getDueDate() const { return dueDate; }
@@ -58,7 +56,7 @@ void Invoice::setCustomerName(const QString& name) { customerName = name; }
 void Invoice::setCustomerAddress(const QString& address) { customerAddress = address; }
 
 /** @param amt New invoice amount. */
-void Invoice::setAmount(double amt) { amount = amt; }
+void Invoice::setAmount(Money amt) { amount = amt; }
 
 /** @param date New due date. */
 void Invoice::setDueDate(const QDate& date) { dueDate = date; }
@@ -66,6 +64,9 @@ void Invoice::setDueDate(const QDate& date) { dueDate = date; }
 /** @param stat New payment status. */
 void Invoice::setStatus(const QString& stat) { status = stat; }
 
+/** @param id New invoice ID. */
+void Invoice::setInvoiceID(int id) { invoiceID = id; }
+
 /**
  * @brief Converts the invoice into a JSON object.
  *
@@ -84,7 +85,7 @@ QJsonObject Invoice::toJson() const {
     json["invoiceID"] = invoiceID;
     json["customerName"] = customerName;
     json["customerAddress"] = customerAddress;
-    json["amount"] = amount;
+    json["amount"] = amount.toDouble(); // Stays a JSON number; exact for any amount below 2^53 cents
     json["dueDate"] = dueDate.toString(Qt::ISODate);
     json["status"] = status;
     return json;
@@ -94,17 +95,35 @@ QJsonObject Invoice::toJson() const {
  * @brief Reconstructs an Invoice object from a JSON object.
  *
  * Parses the necessary fields from the JSON and assigns them to a new Invoice instance.
+ * The stored ID is kept as is; no ID is allocated.
  *
  * @param json The JSON object containing invoice data.
  * @return The corresponding Invoice object.
  */
 Invoice Invoice::fromJson(const QJsonObject& json) {
     Invoice invoice;
+    fromJson(json, invoice);
+    return invoice;
+}
+
+/**
+ * @brief Reconstructs an Invoice from a JSON object, reporting an unusable amount.
+ *
+ * Every field is filled in either way; the amount stays zero if it is missing, not
+ * a number, not finite or too large for Money.
+ *
+ * @param json The JSON object containing invoice data.
+ * @param invoice Receives the invoice.
+ * @return False if the amount could not be read.
+ */
+bool Invoice::fromJson(const QJsonObject& json, Invoice& invoice) {
+    invoice = Invoice();
     invoice.invoiceID = json["invoiceID"].toInt();
     invoice.customerName = json["customerName"].toString();
     invoice.customerAddress = json["customerAddress"].toString();
-    invoice.amount = json["amount"].toDouble();
+    const QJsonValue amount = json["amount"];
+    const bool amountValid = amount.isDouble() && Money::tryFromDouble(amount.toDouble(), invoice.amount); // Rounds to the nearest cent
     invoice.dueDate = QDate::fromString(json["dueDate"].toString(), Qt::ISODate);
     invoice.status = json["status"].toString();
-    return invoice;
+    return amountValid;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <QString>
 #include <QDate>
 #include <QJsonObject>
+#include "money.h"
 
 /**
  * @class Invoice
@@ -20,11 +21,26 @@ public:
     /**
      * @brief Default constructor.
      *
-     * Initializes a new invoice with a unique ID, today's date as due date,
-     * amount set to 0.0, and status set to "Pending".
+     * Initializes a new invoice without an ID (0), today's date as due date,
+     * amount set to zero, and status set to "Pending".
+     * IDs are handed out by InvoiceStore when the invoice is added.
      */
 
-    Invoice(const QString& customerName, const QString& customerAddress, double amount, const QDate& dueDate);
+    Invoice(const QString& customerName, const QString& customerAddress, Money amount, const QDate& dueDate);
+
+    /**
+     * @brief Largest amount, owed or credited, that an invoice may be entered with.
+     *
+     * Small enough that a store full of such invoices still totals within Money's range.
+     */
+    static constexpr Money kMaxAmount = Money::fromCents(100'000'000'000); // 1,000,000,000.00
+
+    /**
+     * @brief Returns true if the amount is within kMaxAmount either way.
+     */
+    static bool isAmountInRange(Money amount) {
+        return amount.cents() >= -kMaxAmount.cents() && amount.cents() <= kMaxAmount.cents();
+    }
 
     /**
      * @brief Gets the customer's name.
@@ -42,7 +58,7 @@ public:
      * @brief Gets the invoice amount.
      * @return Amount due.
      */
-    double getAmount() const;
+    Money getAmount() const;
 
     /**
      * @brief Gets the due date of the invoice.
@@ -58,7 +74,7 @@ public:
 
     /**
      * @brief Gets the unique invoice ID.
-     * @return Invoice ID.
+     * @return Invoice ID, or 0 if the invoice has not been added to an InvoiceStore yet.
      */
     int getInvoiceID() const;
 
@@ -78,7 +94,7 @@ public:
      * @brief Sets the invoice amount.
      * @param amount New amount due.
      */
-    void setAmount(double amount);
+    void setAmount(Money amount);
 
     /**
      * @brief Sets the invoice due date.
@@ -92,6 +108,12 @@ public:
      */
     void setStatus(const QString& status);
 
+    /**
+     * @brief Sets the invoice ID; used by InvoiceStore when it assigns IDs.
+     * @param invoiceID New invoice ID.
+     */
+    void setInvoiceID(int invoiceID);
+
     /**
      * @brief Serializes the invoice data to a JSON object.
      * @return JSON representation of the invoice.
@@ -105,12 +127,19 @@ public:
      */
     static Invoice fromJson(const QJsonObject& json);
 
+    /**
+     * @brief Creates an Invoice object from a JSON object, reporting an unusable amount.
+     * @param json JSON object containing invoice data.
+     * @param invoice Receives the invoice; its amount is zero if the stored one could not be read.
+     * @return False if the amount is missing, not a number or does not fit in Money.
+     */
+    static bool fromJson(const QJsonObject& json, Invoice& invoice);
+
 private:
-    static int invoiceCounter;  // Counter for generating unique invoice IDs
-    int invoiceID;              // Unique invoice ID
+    int invoiceID;              // Unique invoice ID, assigned by InvoiceStore
     QString customerName;       // Name of the customer
     QString customerAddress;    // Customer's billing address
-    double amount;              // Total amount due
+    Money amount;               // Total amount due
     QDate dueDate;              // Date payment is due
     QString status;             // Current status of the invoice
 };
@@ -1,18 +1,33 @@
 ﻿#include "invoicemanager.h"
+#include "invoicetransfer.h"
+#include <QApplication>
 #include <QVBoxLayout>
 #include <QFormLayout>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QMessageBox>
 #include <QListWidget>
-#include <QFile>
-#include <QJsonDocument>
-#include <QJsonArray>
 #include <QDialog>
 #include <QDialogButtonBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QFileDialog>
 
+namespace {
+
+/**
+ * @brief Returns the list text of an invoice: "#ID | customer | $amount | due date | status".
+ */
+QString invoiceLabel(const Invoice& inv) {
+    return QString("#%1 | %2 | $%3 | %4 | %5")
+        .arg(inv.getInvoiceID())
+        .arg(inv.getCustomerName())
+        .arg(QString::fromStdString(inv.getAmount().toString()))
+        .arg(inv.getDueDate().toString("yyyy-MM-dd"))
+        .arg(inv.getStatus());
+}
+
+} // namespace
 
 /**
  * @class InvoiceManager
@@ -75,6 +90,14 @@ InvoiceManager::InvoiceManager(QWidget* parent)
     btnLayout->addWidget(deleteInvoiceBtn);
     mainLayout->addLayout(btnLayout);
 
+    QPushButton* importInvoicesBtn = new QPushButton("📥 Import Invoices");
+    QPushButton* exportInvoicesBtn = new QPushButton("📤 Export Invoices");
+
+    QHBoxLayout* transferLayout = new QHBoxLayout();
+    transferLayout->addWidget(importInvoicesBtn);
+    transferLayout->addWidget(exportInvoicesBtn);
+    mainLayout->addLayout(transferLayout);
+
     loadInvoices();
 
     connect(addInvoiceBtn, &QPushButton::clicked, this, &InvoiceManager::addInvoice);
@@ -82,6 +105,8 @@ InvoiceManager::InvoiceManager(QWidget* parent)
     connect(markCompletedBtn, &QPushButton::clicked, this, &InvoiceManager::markAsCompleted);
     connect(editInvoiceBtn, &QPushButton::clicked, this, &InvoiceManager::editInvoice);
     connect(invoiceListWidget, &QListWidget::itemDoubleClicked, this, &InvoiceManager::viewInvoiceDetails);
+    connect(importInvoicesBtn, &QPushButton::clicked, this, &InvoiceManager::importInvoices);
+    connect(exportInvoicesBtn, &QPushButton::clicked, this, &InvoiceManager::exportInvoices);
 }
 
 /**
@@ -100,100 +125,187 @@ void InvoiceManager::addInvoice() {
         return;
     }
 
+    Money amount;
+    if (!Money::parse(amountEdit->text().toStdString(), amount)) {
+        QMessageBox::critical(this, "⚠️ Error", "Amount must be a number such as 1250.00.");
+        return;
+    }
+    if (!Invoice::isAmountInRange(amount)) {
+        QMessageBox::critical(this, "⚠️ Error", QString("Amount cannot be larger than %1.").arg(QString::fromStdString(Invoice::kMaxAmount.toString())));
+        return;
+    }
+
     Invoice inv(customerNameEdit->text(), customerAddressEdit->text(),
-        amountEdit->text().toDouble(),
+        amount,
         QDate::fromString(dueDateEdit->text(), "yyyy-MM-dd"));
 
-    invoices.append(inv);
-    saveInvoices();
-    loadInvoices();
+    const int invoiceID = invoiceStore.add(inv);
+    showInvoice(*invoiceStore.find(invoiceID));
+    emit invoicesChanged();
     QMessageBox::information(this, "✅ Success", "Invoice created successfully!");
 }
 
 /**
  * @brief Deletes the currently selected invoice.
  *
- * Removes it from the internal list and file, then refreshes the display.
+ * Removes it from the store and journal, then drops its row from the display.
  */
 void InvoiceManager::deleteInvoice() {
-    int selectedRow = invoiceListWidget->currentRow();
-    if (selectedRow < 0 || selectedRow >= invoices.size()) {
+    const Invoice* selected = selectedInvoice();
+    if (!selected) {
         QMessageBox::warning(this, "⚠️ Error", "Please select a valid invoice to delete.");
         return;
     }
-    invoices.removeAt(selectedRow);
-    saveInvoices();
-    loadInvoices();
+    const int invoiceID = selected->getInvoiceID();
+    invoiceStore.remove(invoiceID);
+    delete invoiceItems.take(invoiceID);
+    emit invoicesChanged();
     QMessageBox::information(this, "🗑️ Deleted", "Invoice deleted successfully.");
 }
 
 /**
  * @brief Marks an invoice as completed if not already done.
  *
- * Updates the status to "Completed", saves, and reloads the list.
+ * Updates the status to "Completed", journals it, and redraws its row.
  */
 void InvoiceManager::markAsCompleted() {
-    int selectedRow = invoiceListWidget->currentRow();
-    if (selectedRow < 0 || selectedRow >= invoices.size()) {
+    const Invoice* selected = selectedInvoice();
+    if (!selected) {
         QMessageBox::warning(this, "⚠️ Error", "Please select a valid invoice to update.");
         return;
     }
 
-    Invoice& inv = invoices[selectedRow];
+    Invoice inv = *selected;
     if (inv.getStatus() == "Completed") {
         QMessageBox::information(this, "ℹ️ Info", "Invoice is already marked as completed.");
         return;
     }
 
     inv.setStatus("Completed");
-    saveInvoices();
-    loadInvoices();
+    invoiceStore.update(inv);
+    showInvoice(inv);
+    emit invoicesChanged();
     QMessageBox::information(this, "✅ Updated", "Invoice marked as completed!");
 }
 
 /**
- * @brief Loads invoices from JSON file and refreshes the list widget.
+ * @brief Loads invoices from the JSON file and its journal and rebuilds the list widget.
  */
 void InvoiceManager::loadInvoices() {
     invoiceListWidget->clear();
-    invoices.clear();
+    invoiceItems.clear();
+
+    invoiceStore.load();
 
-    QFile file("invoices.json");
-    if (file.open(QIODevice::ReadOnly)) {
-        QByteArray data = file.readAll();
-        QJsonArray jsonArray = QJsonDocument::fromJson(data).array();
+    invoiceListWidget->setUpdatesEnabled(false);
+    invoiceStore.forEach([this](const Invoice& inv) { showInvoice(inv); });
+    invoiceListWidget->setUpdatesEnabled(true);
+    emit invoicesChanged();
+}
 
-        for (const auto& jsonVal : jsonArray)
-            invoices.append(Invoice::fromJson(jsonVal.toObject()));
+/**
+ * @brief Saves every invoice to the local JSON file and clears the journal.
+ */
+void InvoiceManager::saveInvoices() {
+    invoiceStore.compact();
+}
 
-        file.close();
+/**
+ * @brief Imports invoices from a CSV or JSON file in one batch.
+ *
+ * Nothing is stored unless the file could be read; rows that fail validation are
+ * skipped and listed in the report.
+ */
+void InvoiceManager::importInvoices() {
+    const QString filePath = QFileDialog::getOpenFileName(this, "Import Invoices", "",
+        "Invoice Files (*.csv *.json);;CSV Files (*.csv);;JSON Files (*.json)");
+    if (filePath.isEmpty()) {
+        return;
     }
 
-    for (const auto& inv : invoices) {
-        invoiceListWidget->addItem(
-            QString("#%1 | %2 | $%3 | %4 | %5")
-            .arg(inv.getInvoiceID())
-            .arg(inv.getCustomerName())
-            .arg(inv.getAmount())
-            .arg(inv.getDueDate().toString("yyyy-MM-dd"))
-            .arg(inv.getStatus())
-        );
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    InvoiceImport imported = InvoiceTransfer::importFile(filePath);
+    const int importedCount = static_cast<int>(imported.invoices.size());
+    QString storeError;
+    const int firstID = invoiceStore.addAll(std::move(imported.invoices), &storeError);
+    if (firstID > 0) {
+        invoiceListWidget->setUpdatesEnabled(false);
+        invoiceItems.reserve(invoiceItems.size() + importedCount);
+        for (int invoiceID = firstID; invoiceID < firstID + importedCount; ++invoiceID) {
+            showInvoice(*invoiceStore.find(invoiceID));
+        }
+        invoiceListWidget->setUpdatesEnabled(true);
+        emit invoicesChanged();
     }
+    QApplication::restoreOverrideCursor();
+
+    if (!imported.fileError.isEmpty()) {
+        QMessageBox::critical(this, "⚠️ Error", "Failed to import invoices: " + imported.fileError);
+        return;
+    }
+    if (importedCount > 0 && firstID == 0) {
+        QMessageBox::critical(this, "⚠️ Error", "Failed to import invoices: " + storeError + ".");
+        return;
+    }
+
+    QMessageBox report(this);
+    report.setWindowTitle(imported.rejectedCount > 0 ? "⚠️ Import Finished" : "✅ Success");
+    report.setIcon(imported.rejectedCount > 0 ? QMessageBox::Warning : QMessageBox::Information);
+    QString text = QString("Imported %1 of %2 invoices.").arg(importedCount).arg(imported.rowCount);
+    if (imported.rejectedCount > 0) {
+        text += QString("\n%1 were rejected; see the details for the first problems.").arg(imported.rejectedCount);
+        report.setDetailedText(imported.errors.join("\n"));
+    }
+    report.setText(text);
+    report.exec();
 }
 
 /**
- * @brief Saves the current list of invoices to a local JSON file.
+ * @brief Exports every invoice; the file name's suffix picks CSV or JSON.
  */
-void InvoiceManager::saveInvoices() {
-    QFile file("invoices.json");
-    if (file.open(QIODevice::WriteOnly)) {
-        QJsonArray jsonArray;
-        for (const auto& inv : invoices)
-            jsonArray.append(inv.toJson());
-
-        file.write(QJsonDocument(jsonArray).toJson());
-        file.close();
+void InvoiceManager::exportInvoices() {
+    const QString filePath = QFileDialog::getSaveFileName(this, "Export Invoices", "invoices.csv",
+        "CSV Files (*.csv);;JSON Files (*.json)");
+    if (filePath.isEmpty()) {
+        return;
     }
+
+    QString error;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool exported = InvoiceTransfer::exportFile(invoiceStore, filePath, &error);
+    QApplication::restoreOverrideCursor();
+    if (!exported) {
+        QMessageBox::critical(this, "⚠️ Error", "Failed to export invoices: " + error);
+        return;
+    }
+    QMessageBox::information(this, "✅ Exported", QString("Exported %1 invoices to %2.").arg(invoiceStore.count()).arg(filePath));
+}
+
+/**
+ * @brief Returns the invoice store.
+ */
+const InvoiceStore& InvoiceManager::store() const {
+    return invoiceStore;
+}
+
+/**
+ * @brief Adds the row of an invoice, or redraws it if it already has one.
+ */
+void InvoiceManager::showInvoice(const Invoice& invoice) {
+    QListWidgetItem*& item = invoiceItems[invoice.getInvoiceID()];
+    if (!item) {
+        item = new QListWidgetItem(invoiceListWidget);
+        item->setData(Qt::UserRole, invoice.getInvoiceID());
+    }
+    item->setText(invoiceLabel(invoice));
+}
+
+/**
+ * @brief Returns the invoice of the selected row, or nullptr if nothing valid is selected.
+ */
+const Invoice* InvoiceManager::selectedInvoice() const {
+    const QListWidgetItem* item = invoiceListWidget->currentItem();
+    return item ? invoiceStore.find(item->data(Qt::UserRole).toInt()) : nullptr;
 }
 
 /**
@@ -202,12 +314,12 @@ void InvoiceManager::saveInvoices() {
  * Pre-fills the form with existing invoice data and updates it upon confirmation.
  */
 void InvoiceManager::editInvoice() {
-    int selectedRow = invoiceListWidget->currentRow();
-    if (selectedRow < 0 || selectedRow >= invoices.size()) {
+    const Invoice* selected = selectedInvoice();
+    if (!selected) {
         QMessageBox::warning(this, "⚠️ Error", "Please select a valid invoice to edit.");
         return;
     }
-    Invoice& inv = invoices[selectedRow];
+    Invoice inv = *selected;
 
     QDialog editDialog(this);
     editDialog.setWindowTitle("✏️ Edit Invoice");
@@ -221,7 +333,7 @@ void InvoiceManager::editInvoice() {
     customerAddressEdit.setText(inv.getCustomerAddress());
 
     QLineEdit amountEdit;
-    amountEdit.setText(QString::number(inv.getAmount()));
+    amountEdit.setText(QString::fromStdString(inv.getAmount().toString()));
 
     QLineEdit dueDateEdit;
     dueDateEdit.setText(inv.getDueDate().toString("yyyy-MM-dd"));
@@ -245,15 +357,25 @@ void InvoiceManager::editInvoice() {
             QMessageBox::critical(&editDialog, "⚠️ Error", "All required fields must be filled.");
             return;
         }
+        Money amount;
+        if (!Money::parse(amountEdit.text().toStdString(), amount)) {
+            QMessageBox::critical(&editDialog, "⚠️ Error", "Amount must be a number such as 1250.00.");
+            return;
+        }
+        if (!Invoice::isAmountInRange(amount)) {
+            QMessageBox::critical(&editDialog, "⚠️ Error", QString("Amount cannot be larger than %1.").arg(QString::fromStdString(Invoice::kMaxAmount.toString())));
+            return;
+        }
 
         inv.setCustomerName(customerNameEdit.text());
         inv.setCustomerAddress(customerAddressEdit.text());
-        inv.setAmount(amountEdit.text().toDouble());
+        inv.setAmount(amount);
         inv.setDueDate(QDate::fromString(dueDateEdit.text(), "yyyy-MM-dd"));
         inv.setStatus(statusCombo.currentText());
 
-        saveInvoices();
-        loadInvoices();
+        invoiceStore.update(inv);
+        showInvoice(inv);
+        emit invoicesChanged();
         QMessageBox::information(this, "✅ Success", "Invoice updated successfully!");
         editDialog.accept();
         });
@@ -272,10 +394,10 @@ void InvoiceManager::editInvoice() {
  * @param item The selected invoice item.
  */
 void InvoiceManager::viewInvoiceDetails(QListWidgetItem* item) {
-    int selectedRow = invoiceListWidget->row(item);
-    if (selectedRow < 0 || selectedRow >= invoices.size()) return;
+    const Invoice* found = item ? invoiceStore.find(item->data(Qt::UserRole).toInt()) : nullptr;
+    if (!found) return;
 
-    const Invoice& inv = invoices[selectedRow];
+    const Invoice& inv = *found;
 
     QDialog detailsDialog(this);
     detailsDialog.setWindowTitle("📄 Invoice Details");
@@ -284,7 +406,7 @@ void InvoiceManager::viewInvoiceDetails(QListWidgetItem* item) {
 
     QLabel customerName(inv.getCustomerName());
     QLabel customerAddress(inv.getCustomerAddress());
-    QLabel amount(QString("$%1").arg(inv.getAmount()));
+    QLabel amount(QString("$%1").arg(QString::fromStdString(inv.getAmount().toString())));
     QLabel dueDate(inv.getDueDate().toString("yyyy-MM-dd"));
     QLabel status(inv.getStatus());
 
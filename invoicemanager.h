@@ -3,7 +3,9 @@
 
 #include <QMainWindow>
 #include <QListWidgetItem>
+#include <QHash>
 #include "invoice.h"
+#include "invoicestore.h"
 
 QT_BEGIN_NAMESPACE
 class QListWidget;
@@ -34,12 +36,23 @@ QT_END_NAMESPACE
          */
         InvoiceManager(QWidget* parent = nullptr);
 
+        /**
+         * @brief Returns the invoice store, e.g. for the dashboard's receivables tile.
+         */
+        const InvoiceStore& store() const;
+
+    signals:
+        /**
+         * @brief Emitted after invoices were loaded, added, edited, completed or deleted.
+         */
+        void invoicesChanged();
+
     private slots:
         /**
          * @brief Adds a new invoice using user-provided input.
          *
-         * Validates required fields, constructs an Invoice object, appends it to the internal list,
-         * saves to disk, and refreshes the invoice list view.
+         * Validates required fields, constructs an Invoice object, adds it to the store
+         * and appends its row to the invoice list view.
          */
         void addInvoice();
 
@@ -47,7 +60,7 @@ QT_END_NAMESPACE
          * @brief Deletes the currently selected invoice from the list.
          *
          * If no invoice is selected, shows a warning message. After deletion,
-         * updates the stored data and refreshes the display.
+         * journals the removal and drops only that row from the display.
          */
         void deleteInvoice();
 
@@ -55,23 +68,24 @@ QT_END_NAMESPACE
          * @brief Marks the selected invoice as completed.
          *
          * If the invoice is already marked completed, a notice is shown.
-         * Otherwise, updates the status, saves, and reloads the list.
+         * Otherwise, updates the status, journals the change and refreshes that row.
          */
         void markAsCompleted();
 
         /**
          * @brief Loads all invoices from a local JSON file into memory and updates the list view.
          *
-         * Reads data from 'invoices.json', deserializes it, and populates the GUI list.
-         * This is called during startup and after every edit to refresh the UI.
+         * Reads 'invoices.json' and its journal into the store and rebuilds the GUI list.
+         * This is called during startup; edits update single rows instead.
          */
         void loadInvoices();
 
         /**
          * @brief Saves the current state of all invoices to a JSON file.
          *
-         * Serializes the internal invoice list into a QJsonArray and writes it to 'invoices.json'.
-         * Ensures that all invoice data persists between app sessions.
+         * Streams every invoice into 'invoices.json' through InvoiceStore::compact(), one record at a
+         * time, and clears the journal.
+         * Edits are journaled as they happen, so this is only needed to fold the journal in early.
          */
         void saveInvoices();
 
@@ -79,7 +93,7 @@ QT_END_NAMESPACE
          * @brief Opens a modal dialog allowing the user to edit the selected invoice.
          *
          * Pre-fills fields with existing invoice data. After editing, updates the invoice,
-         * saves the changes to disk, and refreshes the UI.
+         * journals the change, and refreshes that row.
          */
         void editInvoice();
 
@@ -93,6 +107,20 @@ QT_END_NAMESPACE
          */
         void viewInvoiceDetails(QListWidgetItem* item);
 
+        /**
+         * @brief Imports invoices from a CSV or JSON file the user picks.
+         *
+         * Parses and validates the file in parallel (see InvoiceTransfer), stores the valid
+         * invoices with one InvoiceStore::addAll(), adds their rows in one pass and then
+         * reports how many were imported and why any were rejected.
+         */
+        void importInvoices();
+
+        /**
+         * @brief Exports every invoice to a CSV or JSON file the user picks.
+         */
+        void exportInvoices();
+
     private:
         // --- UI Elements ---
 
@@ -122,11 +150,26 @@ QT_END_NAMESPACE
         QListWidget* invoiceListWidget;
 
         /**
-         * @brief Internal container holding all created invoice objects.
+         * @brief Every invoice, indexed by ID, status and due date, with incremental persistence.
+         */
+        InvoiceStore invoiceStore;
+
+        /**
+         * @brief The list row of each invoice by ID, so a change redraws only its own row.
          *
-         * Used to build and serialize invoice data as well as manipulate entries.
+         * Each row also carries its invoice ID in Qt::UserRole.
+         */
+        QHash<int, QListWidgetItem*> invoiceItems;
+
+        /**
+         * @brief Adds the row of an invoice, or redraws it if it already has one.
+         */
+        void showInvoice(const Invoice& invoice);
+
+        /**
+         * @brief Returns the invoice of the selected row, or nullptr if nothing valid is selected.
          */
-        QVector<Invoice> invoices;
+        const Invoice* selectedInvoice() const;
 };
 
 #endif // INVOICEMANAGER_H
\ No newline at end of file
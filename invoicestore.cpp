@@ -0,0 +1,416 @@
+#include "invoicestore.h"
+#include "jsonstream.h"
+#include "logging.h"
+#include "tracing.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @class invoicestore.cpp
+ * @brief Implements the InvoiceStore indexes, ID allocator, journal and snapshot.
+ */
+
+namespace {
+
+// Snapshot: {"formatVersion":2,"reservedThroughID":128,"invoices":[...]}
+const QString kFormatVersionKey = "formatVersion";
+const QString kReservedThroughKey = "reservedThroughID";
+const QString kInvoicesKey = "invoices";
+constexpr int kSnapshotFormatVersion = 2; // Version 1 was a bare array of invoices
+
+// Journal record: {"op":"put","invoice":{...}}, {"op":"delete","invoiceID":7} or {"op":"reserve","reservedThroughID":128}
+const QString kOperationKey = "op";
+const QString kPutOperation = "put";
+const QString kDeleteOperation = "delete";
+const QString kReserveOperation = "reserve";
+const QString kInvoiceKey = "invoice";
+const QString kInvoiceIDKey = "invoiceID";
+
+} // namespace
+
+InvoiceStore::InvoiceStore(const QString& filePath)
+    : filePath(filePath) {
+}
+
+QString InvoiceStore::journalFilePath() const {
+    return filePath + ".journal";
+}
+
+void InvoiceStore::insert(Invoice invoice) {
+    const int invoiceID = invoice.getInvoiceID();
+    erase(invoiceID);
+    if (static_cast<size_t>(invoiceID) >= idIndex.size()) {
+        idIndex.resize(std::max(static_cast<size_t>(invoiceID) + 1, idIndex.size() * 2), kNoSlot);
+    }
+    aging.add(invoice); // First: it throws on overflow, and then no index may hold the invoice yet
+    statusIndex[invoice.getStatus()].insert(invoiceID);
+    if (invoice.getDueDate().isValid()) {
+        dueIndex.insert({ invoice.getDueDate().toJulianDay(), invoiceID });
+    }
+    idIndex[static_cast<size_t>(invoiceID)] = static_cast<int>(entries.size());
+    entries.push_back(std::move(invoice));
+
+    // Stored IDs count as reserved, whatever reservations the files recorded
+    reservedThroughID = std::max(reservedThroughID, invoiceID);
+}
+
+void InvoiceStore::erase(int invoiceID) {
+    const Invoice* invoice = find(invoiceID);
+    if (!invoice) {
+        return;
+    }
+    auto status = statusIndex.find(invoice->getStatus());
+    if (status != statusIndex.end()) {
+        status->remove(invoiceID);
+        if (status->isEmpty()) {
+            statusIndex.erase(status);
+        }
+    }
+    if (invoice->getDueDate().isValid()) {
+        dueIndex.erase({ invoice->getDueDate().toJulianDay(), invoiceID });
+    }
+    aging.remove(*invoice);
+
+    // Move the last invoice into the freed slot so entries stays dense
+    const size_t slot = static_cast<size_t>(idIndex[static_cast<size_t>(invoiceID)]);
+    if (slot != entries.size() - 1) {
+        entries[slot] = std::move(entries.back());
+        idIndex[static_cast<size_t>(entries[slot].getInvoiceID())] = static_cast<int>(slot);
+    }
+    entries.pop_back();
+    idIndex[static_cast<size_t>(invoiceID)] = kNoSlot;
+}
+
+int InvoiceStore::allocateInvoiceID() {
+    if (nextInvoiceID > reservedThroughID) {
+        // Persist the new mark before any ID from the block can reach the disk or the user
+        reservedThroughID = std::min(nextInvoiceID + kIDBlockSize - 1, kMaxInvoiceID);
+        appendJournalRecord({ { kOperationKey, kReserveOperation }, { kReservedThroughKey, reservedThroughID } });
+    }
+    return nextInvoiceID++;
+}
+
+bool InvoiceStore::load() {
+    NOOMYPLAN_TRACE_SCOPE("invoices.load");
+    entries.clear();
+    idIndex.clear();
+    statusIndex.clear();
+    dueIndex.clear();
+    aging.clear();
+    reservedThroughID = 0;
+    journalRecords = 0;
+    snapshotDamaged = false;
+
+    bool loaded = false;
+    bool needsCompaction = false;
+    QList<Invoice> unnumbered; // Invoices whose stored ID is unusable; numbered once everything is read
+
+    QFile snapshot(filePath);
+    if (snapshot.open(QIODevice::ReadOnly)) {
+        // Invoices are indexed as they are parsed; only one record is held as JSON at a time.
+        // A bare array (written before the allocator existed) reads the same way.
+        QJsonObject header;
+        QString error;
+        const bool parsed = JsonStreamReader::readObjectArray(&snapshot, kInvoicesKey, [&](const QJsonObject& record) {
+            Invoice invoice;
+            const bool amountRead = Invoice::fromJson(record, invoice);
+            const int invoiceID = invoice.getInvoiceID();
+            loaded = true;
+            if (!amountRead) {
+                // Loading it as $0.00 would write the zero over the stored amount at the next compaction
+                quarantine(record, "its amount is not a usable number");
+                needsCompaction = true;
+            }
+            else if (!Invoice::isAmountInRange(invoice.getAmount())) {
+                quarantine(record, QString("amount %1 is out of range").arg(QString::fromStdString(invoice.getAmount().toString())));
+                needsCompaction = true;
+            }
+            else if (invoiceID <= 0 || invoiceID > kMaxInvoiceID || find(invoiceID)) {
+                unnumbered.append(invoice);
+            }
+            else if (!insertLoaded(invoice, record)) {
+                needsCompaction = true;
+            }
+            }, &header, &error);
+        // insert() has raised the mark to every ID read, including those before any damage
+        reservedThroughID = std::max(reservedThroughID, std::clamp(header.value(kReservedThroughKey).toInt(), 0, kMaxInvoiceID));
+        snapshot.close();
+        if (!parsed) {
+            NOOMYPLAN_LOG_WARNING(lcInvoice) << "Snapshot" << filePath << "is damaged, keeping the invoices read before:" << error;
+            // The rest of the book may still be recoverable by hand; never write over it
+            if (setSnapshotAside()) {
+                needsCompaction = true;
+            }
+            else {
+                snapshotDamaged = true;
+            }
+        }
+    }
+
+    QFile journal(journalFilePath());
+    if (journal.open(QIODevice::ReadOnly)) {
+        while (!journal.atEnd()) {
+            const QByteArray line = journal.readLine().trimmed();
+            if (line.isEmpty()) {
+                continue;
+            }
+            if (!applyJournalRecord(line)) {
+                // Most likely a write cut short; appending after it would glue the next record onto it.
+                // Records that were readable but refused have been set aside already.
+                NOOMYPLAN_LOG_WARNING(lcInvoice) << "Skipping record in" << journalFilePath();
+                needsCompaction = true;
+                continue;
+            }
+            ++journalRecords;
+            loaded = true;
+        }
+    }
+
+    // Start above every ID this or an earlier session may have handed out
+    nextInvoiceID = reservedThroughID + 1;
+
+    // Older files could repeat IDs; number the repeats as new invoices so each can be addressed
+    for (Invoice& invoice : unnumbered) {
+        const QJsonObject record = invoice.toJson();
+        const int invoiceID = nextInvoiceID++;
+        NOOMYPLAN_LOG_INFO(lcInvoice) << "Invoice ID" << invoice.getInvoiceID() << "is unusable or used twice; renumbering to" << invoiceID;
+        invoice.setInvoiceID(invoiceID);
+        insertLoaded(invoice, record);
+        needsCompaction = true;
+    }
+
+    NOOMYPLAN_LOG_INFO(lcInvoice) << "Loaded" << count() << "invoices," << journalRecords << "from the journal; next ID" << nextInvoiceID;
+    if (needsCompaction) {
+        compact();
+    }
+    return loaded;
+}
+
+bool InvoiceStore::applyJournalRecord(const QByteArray& line) {
+    const QJsonObject record = QJsonDocument::fromJson(line).object();
+    const QString operation = record.value(kOperationKey).toString();
+    if (operation == kPutOperation && record.value(kInvoiceKey).isObject()) {
+        const QJsonObject invoiceRecord = record.value(kInvoiceKey).toObject();
+        Invoice invoice;
+        const bool amountRead = Invoice::fromJson(invoiceRecord, invoice);
+        if (invoice.getInvoiceID() <= 0 || invoice.getInvoiceID() > kMaxInvoiceID) {
+            return false;
+        }
+        if (!amountRead) {
+            quarantine(invoiceRecord, "its amount is not a usable number");
+            reservedThroughID = std::max(reservedThroughID, invoice.getInvoiceID());
+            return false;
+        }
+        if (!Invoice::isAmountInRange(invoice.getAmount())) {
+            quarantine(invoiceRecord, QString("amount %1 is out of range").arg(QString::fromStdString(invoice.getAmount().toString())));
+            reservedThroughID = std::max(reservedThroughID, invoice.getInvoiceID());
+            return false;
+        }
+        return insertLoaded(invoice, invoiceRecord);
+    }
+    if (operation == kDeleteOperation && record.contains(kInvoiceIDKey)) {
+        const int invoiceID = record.value(kInvoiceIDKey).toInt();
+        // The deleted invoice's ID was handed out too, even if the snapshot that held it is lost
+        reservedThroughID = std::max(reservedThroughID, std::clamp(invoiceID, 0, kMaxInvoiceID));
+        erase(invoiceID);
+        return true;
+    }
+    if (operation == kReserveOperation && record.contains(kReservedThroughKey)) {
+        reservedThroughID = std::max(reservedThroughID, std::clamp(record.value(kReservedThroughKey).toInt(), 0, kMaxInvoiceID));
+        return true;
+    }
+    return false;
+}
+
+bool InvoiceStore::compact() {
+    if (snapshotDamaged) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Not writing" << filePath << "while the files hold invoices that could not be loaded or set aside";
+        return false;
+    }
+    NOOMYPLAN_TRACE_SCOPE("invoices.save");
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to open" << filePath << file.errorString();
+        return false;
+    }
+
+    // Streamed one invoice at a time instead of building the whole document first
+    JsonStreamWriter writer(&file);
+    writer.beginObject();
+    writer.key(kFormatVersionKey);
+    writer.value(kSnapshotFormatVersion);
+    writer.key(kReservedThroughKey);
+    writer.value(reservedThroughID); // The journal's reservations are folded in here
+    writer.key(kInvoicesKey);
+    writer.beginArray();
+    forEach([&writer](const Invoice& invoice) { writer.value(invoice.toJson()); });
+    writer.endArray();
+    writer.endObject();
+    if (!writer.flush() || !file.commit()) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to write" << filePath << file.errorString();
+        return false;
+    }
+
+    // The snapshot now holds every journaled change
+    if (QFile::exists(journalFilePath()) && !QFile::remove(journalFilePath())) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to remove" << journalFilePath();
+    }
+    journalRecords = 0;
+    return true;
+}
+
+bool InvoiceStore::insertLoaded(const Invoice& invoice, const QJsonObject& record) {
+    try {
+        insert(invoice);
+        return true;
+    }
+    catch (const std::overflow_error&) {
+        quarantine(record, "the outstanding total would overflow");
+        reservedThroughID = std::max(reservedThroughID, invoice.getInvoiceID()); // The ID was handed out all the same
+        return false;
+    }
+}
+
+void InvoiceStore::quarantine(const QJsonObject& record, const QString& reason) {
+    const QString rejectedPath = filePath + ".rejected";
+    NOOMYPLAN_LOG_WARNING(lcInvoice) << "Setting invoice" << record.value(kInvoiceIDKey).toInt() << "aside in" << rejectedPath << "because" << reason;
+    QFile rejected(rejectedPath);
+    if (!rejected.open(QIODevice::WriteOnly | QIODevice::Append) ||
+        rejected.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n') < 0) {
+        // Compacting would drop the only copy of the record
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to write" << rejectedPath << rejected.errorString();
+        snapshotDamaged = true;
+    }
+}
+
+bool InvoiceStore::setSnapshotAside() {
+    QString target = filePath + ".corrupt";
+    for (int n = 1; QFile::exists(target); ++n) {
+        target = filePath + ".corrupt" + QString::number(n);
+    }
+    if (!QFile::rename(filePath, target)) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to move the damaged snapshot" << filePath << "to" << target;
+        return false;
+    }
+    NOOMYPLAN_LOG_WARNING(lcInvoice) << "Moved the damaged snapshot" << filePath << "to" << target;
+    return true;
+}
+
+void InvoiceStore::appendJournalRecord(const QJsonObject& record) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.journalAppend");
+    QFile journal(journalFilePath());
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to open" << journalFilePath() << journal.errorString();
+        compact(); // Keep the change on disk some other way
+        return;
+    }
+    journal.write(QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n');
+    journal.close();
+    ++journalRecords;
+
+    if (!snapshotDamaged && journalRecords >= std::max(kMinJournalRecordsBeforeCompaction, count())) {
+        compact();
+    }
+}
+
+int InvoiceStore::add(Invoice invoice) {
+    invoice.setInvoiceID(allocateInvoiceID());
+    insert(invoice);
+    appendJournalRecord({ { kOperationKey, kPutOperation }, { kInvoiceKey, invoice.toJson() } });
+    return invoice.getInvoiceID();
+}
+
+int InvoiceStore::addAll(std::vector<Invoice> invoices, QString* errorString) {
+    if (invoices.empty()) {
+        return 0;
+    }
+    const qint64 lastID = static_cast<qint64>(nextInvoiceID) + static_cast<qint64>(invoices.size()) - 1;
+    if (lastID > kMaxInvoiceID) {
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Cannot add" << invoices.size() << "invoices: IDs would pass" << kMaxInvoiceID;
+        if (errorString) {
+            *errorString = "too many invoices for the invoice ID range";
+        }
+        return 0;
+    }
+    NOOMYPLAN_TRACE_SCOPE("invoices.addAll");
+
+    const int firstID = nextInvoiceID;
+    const int previousReservedThroughID = reservedThroughID;
+    entries.reserve(entries.size() + invoices.size());
+    if (static_cast<size_t>(lastID) >= idIndex.size()) {
+        idIndex.resize(static_cast<size_t>(lastID) + 1, kNoSlot);
+    }
+    try {
+        for (Invoice& invoice : invoices) {
+            invoice.setInvoiceID(nextInvoiceID);
+            insert(std::move(invoice));
+            ++nextInvoiceID;
+        }
+    }
+    catch (const std::overflow_error&) {
+        // Nothing is on disk yet, so taking the batch back out leaves the store as it was
+        for (int invoiceID = firstID; invoiceID < nextInvoiceID; ++invoiceID) {
+            erase(invoiceID);
+        }
+        nextInvoiceID = firstID;
+        reservedThroughID = previousReservedThroughID;
+        NOOMYPLAN_LOG_WARNING(lcInvoice) << "Cannot add" << invoices.size() << "invoices: the outstanding total would overflow";
+        if (errorString) {
+            *errorString = "the invoice amounts add up to more than can be tracked";
+        }
+        return 0;
+    }
+
+    // The snapshot also records the new high-water mark; if it cannot be written, journal the invoices instead
+    if (!compact()) {
+        for (int invoiceID = firstID; invoiceID < nextInvoiceID; ++invoiceID) {
+            appendJournalRecord({ { kOperationKey, kPutOperation }, { kInvoiceKey, find(invoiceID)->toJson() } });
+        }
+    }
+    return firstID;
+}
+
+bool InvoiceStore::update(const Invoice& invoice) {
+    if (!find(invoice.getInvoiceID())) {
+        return false;
+    }
+    insert(invoice);
+    appendJournalRecord({ { kOperationKey, kPutOperation }, { kInvoiceKey, invoice.toJson() } });
+    return true;
+}
+
+bool InvoiceStore::remove(int invoiceID) {
+    if (!find(invoiceID)) {
+        return false;
+    }
+    erase(invoiceID);
+    appendJournalRecord({ { kOperationKey, kDeleteOperation }, { kInvoiceIDKey, invoiceID } });
+    return true;
+}
+
+const Invoice* InvoiceStore::find(int invoiceID) const {
+    if (invoiceID <= 0 || static_cast<size_t>(invoiceID) >= idIndex.size()) {
+        return nullptr;
+    }
+    const int slot = idIndex[static_cast<size_t>(invoiceID)];
+    return slot == kNoSlot ? nullptr : &entries[static_cast<size_t>(slot)];
+}
+
+int InvoiceStore::count() const {
+    return static_cast<int>(entries.size());
+}
+
+QSet<int> InvoiceStore::idsWithStatus(const QString& status) const {
+    return statusIndex.value(status);
+}
+
+AgingSummary InvoiceStore::receivables(const QDate& asOf) const {
+    return aging.summary(asOf);
+}
+
+int InvoiceStore::highWaterMark() const {
+    return reservedThroughID;
+}
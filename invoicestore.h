@@ -0,0 +1,245 @@
+#ifndef INVOICESTORE_H
+#define INVOICESTORE_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <climits>
+#include <set>
+#include <utility>
+#include <vector>
+#include "invoice.h"
+#include "receivablesaging.h"
+
+/**
+ * @class InvoiceStore
+ * @brief Holds every invoice in memory, indexed by ID, status and due date, and persists changes incrementally.
+ *
+ * IDs come from a persistent allocator and are never reused, so invoices sit in a dense
+ * table addressed by ID. A status index and a due-date index answer "all pending"
+ * or "due before" queries without scanning the whole book, and a ReceivablesAging
+ * keeps the outstanding amounts bucketed by age as invoices change.
+ *
+ * The allocator keeps a high-water mark: every ID up to it is reserved on disk. IDs
+ * are reserved kIDBlockSize at a time with one journal record, and a new session
+ * starts above the mark, so IDs handed out before a crash are not handed out again.
+ *
+ * Persistence is split into a snapshot ("<file>": the invoices and the high-water mark;
+ * the plain JSON array of older versions still loads) and a journal ("<file>.journal")
+ * with one JSON object per line. The snapshot is streamed through JsonStreamReader and
+ * JsonStreamWriter, so it is never held in memory as a whole document.
+ * add(), update() and remove() append a single line, so a change costs O(1) on disk
+ * no matter how many invoices there are. Loading replays the journal on top of the
+ * snapshot, and once the journal holds as many records as there are invoices it is
+ * folded back into a new snapshot.
+ */
+class InvoiceStore {
+public:
+    /**
+     * @brief Creates an empty store; call load() to read the files.
+     * @param filePath Path of the snapshot; the journal lives next to it.
+     */
+    explicit InvoiceStore(const QString& filePath = "invoices.json");
+
+    /**
+     * @brief Replaces the contents with the snapshot and journal on disk.
+     * @return True if the snapshot or the journal had any invoices.
+     *
+     * Loaded invoices keep their stored IDs; only invoices without a usable ID, or that
+     * share one with an invoice loaded before them, get a new ID.
+     *
+     * A snapshot that cannot be read to the end keeps the invoices before the damage and
+     * is renamed to "<file>.corrupt" before a new one is written. If it cannot be renamed,
+     * compact() refuses to write over it and changes go to the journal only.
+     *
+     * Invoices whose amount cannot be read, is beyond Invoice::kMaxAmount or would overflow
+     * the outstanding total are not loaded; their records are appended to "<file>.rejected".
+     */
+    bool load();
+
+    /**
+     * @brief Writes all invoices to the snapshot and deletes the journal.
+     * @return True if the snapshot was written.
+     */
+    bool compact();
+
+    /**
+     * @brief Adds an invoice under a new ID and journals it.
+     * @param invoice The invoice; its ID is replaced.
+     * @return The ID assigned to the invoice.
+     */
+    int add(Invoice invoice);
+
+    /**
+     * @brief Adds many invoices under consecutive new IDs and writes one snapshot.
+     * @param invoices The invoices; their IDs are replaced.
+     * @param errorString If set, receives the reason when 0 is returned for a non-empty batch.
+     * @return The ID of the first invoice, the others following in order; 0 if there are
+     *         none, the IDs would pass kMaxInvoiceID or the outstanding total would overflow,
+     *         in which case nothing is added.
+     *
+     * Meant for imports: the whole ID range is reserved at once, and a snapshot replaces
+     * what would otherwise be one journal record per invoice.
+     */
+    int addAll(std::vector<Invoice> invoices, QString* errorString = nullptr);
+
+    /**
+     * @brief Replaces the stored invoice with the same ID and journals it.
+     * @return False if no invoice has that ID.
+     */
+    bool update(const Invoice& invoice);
+
+    /**
+     * @brief Removes an invoice and journals the removal.
+     * @return False if no invoice has that ID.
+     */
+    bool remove(int invoiceID);
+
+    /**
+     * @brief Returns the invoice with an ID, or nullptr; valid until the store changes.
+     */
+    const Invoice* find(int invoiceID) const;
+
+    /**
+     * @brief Returns the number of stored invoices.
+     */
+    int count() const;
+
+    /**
+     * @brief Returns the IDs of the invoices with a status, in no particular order.
+     */
+    QSet<int> idsWithStatus(const QString& status) const;
+
+    /**
+     * @brief Returns the highest reserved ID; no ID at or below it is handed out again.
+     */
+    int highWaterMark() const;
+
+    /**
+     * @brief Visits every invoice in ascending ID order.
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (int slot : idIndex) {
+            if (slot != kNoSlot) visit(entries[static_cast<size_t>(slot)]);
+        }
+    }
+
+    /**
+     * @brief Returns the outstanding invoices' aging buckets and total as of a date.
+     *
+     * Constant time after the first call of the day; see ReceivablesAging.
+     */
+    AgingSummary receivables(const QDate& asOf) const;
+
+    /**
+     * @brief Visits the outstanding invoices due before asOf, most overdue first.
+     */
+    template <typename Visitor>
+    void forEachOverdue(const QDate& asOf, Visitor&& visit) const {
+        aging.forEachOverdue(asOf, [this, &visit](int invoiceID) { visit(*find(invoiceID)); });
+    }
+
+    /**
+     * @brief Visits the outstanding invoices due within the next days, soonest first.
+     */
+    template <typename Visitor>
+    void forEachDueWithin(const QDate& asOf, int days, Visitor&& visit) const {
+        aging.forEachDueWithin(asOf, days, [this, &visit](int invoiceID) { visit(*find(invoiceID)); });
+    }
+
+    /**
+     * @brief Visits the invoices due within [from, to] in due-date order.
+     *
+     * Binary searches the due-date index, so the cost is O(log n + k) for k matches.
+     * Invoices without a valid due date are never matched.
+     */
+    template <typename Visitor>
+    void forEachDueBetween(const QDate& from, const QDate& to, Visitor&& visit) const {
+        if (!from.isValid() || !to.isValid() || from > to) {
+            return;
+        }
+        auto it = dueIndex.lower_bound({ from.toJulianDay(), INT_MIN });
+        const auto end = dueIndex.upper_bound({ to.toJulianDay(), INT_MAX });
+        for (; it != end; ++it) {
+            visit(*find(it->second));
+        }
+    }
+
+private:
+    using DuePosting = std::pair<qint64, int>; // Julian day of the due date, invoice ID
+
+    QString filePath;                      // Snapshot path
+    std::vector<Invoice> entries;          // Every invoice, in no particular order
+    std::vector<int> idIndex;              // Dense table: idIndex[invoiceID] is the invoice's slot in entries, or kNoSlot
+    QHash<QString, QSet<int>> statusIndex; // IDs per status
+    std::set<DuePosting> dueIndex;         // Invoices with a valid due date, sorted by it
+    ReceivablesAging aging;                // Outstanding invoices by age and due date
+    int nextInvoiceID = 1;                 // Next ID to hand out
+    int reservedThroughID = 0;             // High-water mark: IDs up to here are reserved on disk
+    int journalRecords = 0;                // Records appended since the last snapshot
+    bool snapshotDamaged = false;          // The files on disk hold data that neither loaded nor could be set aside
+
+    static constexpr int kNoSlot = -1;
+    static constexpr int kIDBlockSize = 64;                     // IDs reserved per journal record
+    static constexpr int kMaxInvoiceID = 1 << 24;               // Bounds the ID table; larger stored IDs are renumbered
+    static constexpr int kMinJournalRecordsBeforeCompaction = 64;
+
+    /**
+     * @brief Returns an unused ID, first journaling a new block reservation if the current one is used up.
+     */
+    int allocateInvoiceID();
+
+    /**
+     * @brief Returns the path of the journal that belongs to filePath.
+     */
+    QString journalFilePath() const;
+
+    /**
+     * @brief Stores an invoice and adds it to the indexes, replacing one with the same ID.
+     *
+     * The ID must be between 1 and kMaxInvoiceID. Taken by value, because the
+     * invoice it replaces may be the caller's argument.
+     * @throws std::overflow_error if the outstanding total would overflow; the invoice is
+     *         then in no index, and one it replaced is already gone.
+     */
+    void insert(Invoice invoice);
+
+    /**
+     * @brief Drops an invoice from the indexes and the map.
+     */
+    void erase(int invoiceID);
+
+    /**
+     * @brief Stores an invoice read from the snapshot or the journal, quarantining its record if a total would overflow.
+     * @param record The invoice as stored, kept in the quarantine file if it is refused.
+     * @return False if the invoice was quarantined instead of stored.
+     */
+    bool insertLoaded(const Invoice& invoice, const QJsonObject& record);
+
+    /**
+     * @brief Appends a refused invoice record to "<file>.rejected" so compacting does not lose it.
+     *
+     * If that file cannot be written, compact() is blocked for the session instead.
+     */
+    void quarantine(const QJsonObject& record, const QString& reason);
+
+    /**
+     * @brief Renames a damaged snapshot to "<file>.corrupt" (or "<file>.corruptN" if taken).
+     * @return False if the file could not be renamed.
+     */
+    bool setSnapshotAside();
+
+    /**
+     * @brief Appends one record to the journal and folds the journal in once it is large.
+     */
+    void appendJournalRecord(const QJsonObject& record);
+
+    /**
+     * @brief Applies one journal line.
+     * @return False if the line is not a valid record.
+     */
+    bool applyJournalRecord(const QByteArray& line);
+};
+
+#endif // INVOICESTORE_H
@@ -0,0 +1,448 @@
+#include "invoicetransfer.h"
+#include "csvreader.h"
+#include "invoicestore.h"
+#include "jsonstream.h"
+#include "logging.h"
+#include "tracing.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+/**
+ * @class invoicetransfer.cpp
+ * @brief Implements the parallel invoice import and the CSV and JSON export.
+ */
+
+namespace {
+
+constexpr size_t kMinCsvChunkSize = 256 * 1024; // Smaller chunks cost more in task overhead than they gain
+constexpr int kWriteBufferSize = 64 * 1024;     // Bytes of CSV gathered before each write
+
+const QString kInvoicesKey = "invoices";
+const char* const kCsvHeader = "invoiceID,customerName,customerAddress,amount,dueDate,status\n";
+
+/**
+ * @brief Invoices validated by one pool task.
+ */
+struct ValidatedBatch {
+    std::vector<Invoice> invoices;                      // Valid invoices, in file order
+    qsizetype span = 0;                                 // CSV lines or JSON invoices covered; numbers the next batch's errors
+    qsizetype rowCount = 0;                             // Invoices read, valid or not
+    qsizetype rejectedCount = 0;                        // Invoices that failed validation
+    std::vector<std::pair<qsizetype, QString>> errors;  // Line or invoice index within the batch and the problem; capped
+
+    void reject(qsizetype position, const QString& error) {
+        ++rejectedCount;
+        if (errors.size() < static_cast<size_t>(InvoiceTransfer::kMaxReportedErrors)) {
+            errors.emplace_back(position, error);
+        }
+    }
+};
+
+/**
+ * @brief Positions of the CSV columns an invoice is built from; -1 when absent.
+ */
+struct CsvColumns {
+    int customerName = -1;
+    int customerAddress = -1;
+    int amount = -1;
+    int dueDate = -1;
+    int status = -1;
+};
+
+/**
+ * @brief Converts a CSV field to a QString.
+ */
+QString fieldText(const CsvReader::Field& field) {
+    if (field.escaped) {
+        const std::string text = CsvReader::unescape(field);
+        return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+    }
+    return QString::fromUtf8(field.text.data(), static_cast<qsizetype>(field.text.size()));
+}
+
+/**
+ * @brief Finds the invoice columns in a header row.
+ * @param missing Receives the names of the required columns that were not found.
+ * @return False if a required column is missing.
+ *
+ * Names are compared without case, spaces or punctuation, so "Due Date" matches dueDate.
+ */
+bool mapColumns(const std::vector<CsvReader::Field>& header, CsvColumns& columns, QStringList& missing) {
+    for (int column = 0; column < static_cast<int>(header.size()); ++column) {
+        QString name;
+        for (const QChar c : fieldText(header[column])) {
+            if (c.isLetterOrNumber()) {
+                name += c.toLower();
+            }
+        }
+        if (name == "customername" || name == "customer") columns.customerName = column;
+        else if (name == "customeraddress" || name == "address") columns.customerAddress = column;
+        else if (name == "amount") columns.amount = column;
+        else if (name == "duedate") columns.dueDate = column;
+        else if (name == "status") columns.status = column;
+    }
+    if (columns.customerName < 0) missing << "customerName";
+    if (columns.customerAddress < 0) missing << "customerAddress";
+    if (columns.amount < 0) missing << "amount";
+    if (columns.dueDate < 0) missing << "dueDate";
+    return missing.isEmpty();
+}
+
+/**
+ * @brief Parses and validates one chunk of CSV records; runs on a pool thread.
+ *
+ * Errors are numbered by the physical line a record starts on, so a quoted field
+ * with a line break inside does not shift the numbers of the records after it.
+ */
+ValidatedBatch validateCsvChunk(const CsvReader::Chunk& chunk, const CsvColumns& columns) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.validateChunk");
+    ValidatedBatch batch;
+    batch.invoices.reserve(static_cast<size_t>(chunk.end - chunk.begin) / 64); // Rough guess at the row length
+
+    std::vector<CsvReader::Field> fields;
+    std::string unescapedAmount;
+    for (const char* cursor = chunk.begin; cursor < chunk.end;) {
+        const char* recordBegin = cursor;
+        cursor = CsvReader::nextRecord(cursor, chunk.end, fields);
+        const qsizetype line = batch.span;
+        batch.span += std::count(recordBegin, cursor, '\n');
+        if (fields.size() == 1 && fields[0].text.empty()) {
+            continue; // Blank line
+        }
+        ++batch.rowCount;
+
+        auto text = [&fields](int column) {
+            return column < static_cast<int>(fields.size()) ? fieldText(fields[column]) : QString();
+        };
+        std::string_view amount;
+        if (columns.amount < static_cast<int>(fields.size())) {
+            const CsvReader::Field& field = fields[columns.amount];
+            if (field.escaped) {
+                unescapedAmount = CsvReader::unescape(field);
+                amount = unescapedAmount;
+            }
+            else {
+                amount = field.text;
+            }
+        }
+
+        Invoice invoice;
+        QString error;
+        if (InvoiceTransfer::validate(text(columns.customerName), text(columns.customerAddress), amount,
+            text(columns.dueDate), columns.status >= 0 ? text(columns.status) : QString(), invoice, error)) {
+            batch.invoices.push_back(std::move(invoice));
+        }
+        else {
+            batch.reject(line, error);
+        }
+    }
+    return batch;
+}
+
+/**
+ * @brief Validates one batch of JSON invoice objects; runs on a pool thread.
+ *
+ * Amounts may be JSON numbers, as exportJson() and the invoice file write them, or text.
+ */
+ValidatedBatch validateJsonBatch(const QList<QJsonObject>& records) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.validateChunk");
+    ValidatedBatch batch;
+    batch.invoices.reserve(static_cast<size_t>(records.size()));
+
+    char formatted[Money::kMaxFormattedSize];
+    std::string amountText;
+    for (const QJsonObject& record : records) {
+        const qsizetype index = batch.span++;
+        ++batch.rowCount;
+
+        const QJsonValue amountValue = record.value("amount");
+        std::string_view amount;
+        Money number;
+        if (amountValue.isDouble() && Money::tryFromDouble(amountValue.toDouble(), number)) {
+            amount = std::string_view(formatted, number.format(formatted));
+        }
+        else {
+            amountText = amountValue.isDouble() ? QByteArray::number(amountValue.toDouble()).toStdString()
+                                                 : amountValue.toString().toStdString();
+            amount = amountText;
+        }
+
+        Invoice invoice;
+        QString error;
+        if (InvoiceTransfer::validate(record.value("customerName").toString(), record.value("customerAddress").toString(),
+            amount, record.value("dueDate").toString(), record.value("status").toString(), invoice, error)) {
+            batch.invoices.push_back(std::move(invoice));
+        }
+        else {
+            batch.reject(index, error);
+        }
+    }
+    return batch;
+}
+
+/**
+ * @brief Concatenates the batches in file order and numbers their errors.
+ * @param label Word the error numbers follow: "Line" for CSV, "Invoice" for JSON.
+ * @param firstRecord Lines or invoices before the first batch, e.g. the lines of a CSV header.
+ */
+void mergeBatches(QList<ValidatedBatch>& batches, const QString& label, qsizetype firstRecord, InvoiceImport& result) {
+    size_t total = 0;
+    for (const ValidatedBatch& batch : batches) {
+        total += batch.invoices.size();
+    }
+    result.invoices.reserve(total);
+
+    qsizetype base = firstRecord;
+    for (ValidatedBatch& batch : batches) {
+        std::move(batch.invoices.begin(), batch.invoices.end(), std::back_inserter(result.invoices));
+        for (const auto& error : batch.errors) {
+            if (result.errors.size() >= InvoiceTransfer::kMaxReportedErrors) {
+                break;
+            }
+            result.errors.append(QString("%1 %2: %3").arg(label).arg(base + error.first + 1).arg(error.second));
+        }
+        result.rowCount += batch.rowCount;
+        result.rejectedCount += batch.rejectedCount;
+        base += batch.span;
+    }
+}
+
+/**
+ * @brief Appends a CSV field, quoting it when the text would not read back unchanged.
+ */
+void appendCsvField(QByteArray& out, const QString& text) {
+    const QByteArray utf8 = text.toUtf8();
+    bool quote = !utf8.isEmpty() && (utf8.front() == ' ' || utf8.front() == '\t' || utf8.back() == ' ' || utf8.back() == '\t');
+    for (const char c : utf8) {
+        if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        out.append(utf8);
+        return;
+    }
+    out.append('"');
+    for (const char c : utf8) {
+        if (c == '"') {
+            out.append('"');
+        }
+        out.append(c);
+    }
+    out.append('"');
+}
+
+/**
+ * @brief Commits a finished export, or reports why it failed.
+ */
+bool commitExport(QSaveFile& file, bool written, QString* errorString) {
+    if (written && file.commit()) {
+        return true;
+    }
+    file.cancelWriting();
+    NOOMYPLAN_LOG_WARNING(lcInvoice) << "Failed to export invoices to" << file.fileName() << file.errorString();
+    if (errorString) {
+        *errorString = file.errorString();
+    }
+    return false;
+}
+
+} // namespace
+
+bool InvoiceTransfer::validate(const QString& customerName, const QString& customerAddress, std::string_view amount,
+    const QString& dueDate, const QString& status, Invoice& invoice, QString& error) {
+    const QString name = customerName.trimmed();
+    const QString address = customerAddress.trimmed();
+    const QString due = dueDate.trimmed();
+    if (name.isEmpty()) {
+        error = "customer name is missing";
+        return false;
+    }
+    if (address.isEmpty()) {
+        error = "customer address is missing";
+        return false;
+    }
+    if (amount.find_first_not_of(" \t") == std::string_view::npos) {
+        error = "amount is missing";
+        return false;
+    }
+    Money value;
+    if (!Money::parse(amount, value)) {
+        error = QString("amount \"%1\" is not a number").arg(QString::fromUtf8(amount.data(), static_cast<qsizetype>(amount.size())));
+        return false;
+    }
+    if (!Invoice::isAmountInRange(value)) {
+        error = QString("amount \"%1\" is larger than %2").arg(QString::fromUtf8(amount.data(), static_cast<qsizetype>(amount.size())), QString::fromStdString(Invoice::kMaxAmount.toString()));
+        return false;
+    }
+    if (due.isEmpty()) {
+        error = "due date is missing";
+        return false;
+    }
+    const QDate date = QDate::fromString(due, "yyyy-MM-dd");
+    if (!date.isValid()) {
+        error = QString("due date \"%1\" is not yyyy-MM-dd").arg(due);
+        return false;
+    }
+
+    invoice = Invoice(name, address, value, date);
+    if (!status.trimmed().isEmpty()) {
+        invoice.setStatus(status.trimmed());
+    }
+    return true;
+}
+
+InvoiceImport InvoiceTransfer::importFile(const QString& filePath) {
+    if (QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) == 0) {
+        return importJson(filePath);
+    }
+    return importCsv(filePath);
+}
+
+InvoiceImport InvoiceTransfer::importCsv(const QString& filePath) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.importCsv");
+    InvoiceImport result;
+    CsvReader reader;
+    if (!reader.open(QFile::encodeName(filePath).toStdString())) {
+        result.fileError = QString("Unable to open %1").arg(filePath);
+        return result;
+    }
+
+    // The header row names the columns; everything after it is split among the pool threads
+    const char* end = reader.data() + reader.size();
+    std::vector<CsvReader::Field> header;
+    const char* body = CsvReader::nextRecord(reader.data(), end, header);
+    CsvColumns columns;
+    QStringList missing;
+    if (!mapColumns(header, columns, missing)) {
+        result.fileError = QString("The header row has no %1 column").arg(missing.join(", "));
+        return result;
+    }
+
+    const size_t poolThreads = static_cast<size_t>(qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    std::vector<CsvReader::Chunk> chunks = reader.split(qMax(kMinCsvChunkSize, reader.size() / (poolThreads * 4)));
+    while (!chunks.empty() && chunks.front().end <= body) {
+        chunks.erase(chunks.begin());
+    }
+    if (!chunks.empty()) {
+        chunks.front().begin = qMax(chunks.front().begin, body);
+    }
+
+    QList<ValidatedBatch> batches = QtConcurrent::blockingMapped<QList<ValidatedBatch>>(chunks,
+        [&columns](const CsvReader::Chunk& chunk) { return validateCsvChunk(chunk, columns); });
+    mergeBatches(batches, "Line", std::count(reader.data(), body, '\n'), result);
+    reader.close();
+
+    NOOMYPLAN_LOG_INFO(lcInvoice) << "Read" << result.invoices.size() << "invoices from" << filePath << "in" << chunks.size()
+        << "chunks," << result.rejectedCount << "rejected";
+    return result;
+}
+
+InvoiceImport InvoiceTransfer::importJson(const QString& filePath) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.importJson");
+    InvoiceImport result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.fileError = QString("Unable to open %1: %2").arg(filePath, file.errorString());
+        return result;
+    }
+
+    // Each full batch is validated on the pool while the next one is parsed
+    QList<QFuture<ValidatedBatch>> pending;
+    QList<QJsonObject> batch;
+    batch.reserve(kJsonBatchSize);
+    QString error;
+    const bool parsed = JsonStreamReader::readObjectArray(&file, kInvoicesKey, [&](const QJsonObject& record) {
+        batch.append(record);
+        if (batch.size() == kJsonBatchSize) {
+            pending.append(QtConcurrent::run(validateJsonBatch, batch));
+            batch.clear();
+            batch.reserve(kJsonBatchSize);
+        }
+        }, nullptr, &error);
+    if (!batch.isEmpty()) {
+        pending.append(QtConcurrent::run(validateJsonBatch, batch));
+    }
+
+    QList<ValidatedBatch> batches;
+    batches.reserve(pending.size());
+    for (QFuture<ValidatedBatch>& future : pending) {
+        batches.append(future.result());
+    }
+    if (!parsed) {
+        // Importing the part before the damage would make a second attempt duplicate it
+        result.fileError = QString("%1 is not valid JSON: %2").arg(filePath, error);
+        return result;
+    }
+    mergeBatches(batches, "Invoice", 0, result);
+
+    NOOMYPLAN_LOG_INFO(lcInvoice) << "Read" << result.invoices.size() << "invoices from" << filePath << "in" << batches.size()
+        << "batches," << result.rejectedCount << "rejected";
+    return result;
+}
+
+bool InvoiceTransfer::exportFile(const InvoiceStore& store, const QString& filePath, QString* errorString) {
+    if (QFileInfo(filePath).suffix().compare("json", Qt::CaseInsensitive) == 0) {
+        return exportJson(store, filePath, errorString);
+    }
+    return exportCsv(store, filePath, errorString);
+}
+
+bool InvoiceTransfer::exportCsv(const InvoiceStore& store, const QString& filePath, QString* errorString) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.exportCsv");
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return commitExport(file, false, errorString);
+    }
+
+    QByteArray buffer;
+    buffer.reserve(kWriteBufferSize + 1024);
+    buffer.append(kCsvHeader);
+    bool written = true;
+    char amount[Money::kMaxFormattedSize];
+    store.forEach([&](const Invoice& invoice) {
+        buffer.append(QByteArray::number(invoice.getInvoiceID()));
+        buffer.append(',');
+        appendCsvField(buffer, invoice.getCustomerName());
+        buffer.append(',');
+        appendCsvField(buffer, invoice.getCustomerAddress());
+        buffer.append(',');
+        buffer.append(amount, static_cast<qsizetype>(invoice.getAmount().format(amount)));
+        buffer.append(',');
+        buffer.append(invoice.getDueDate().toString("yyyy-MM-dd").toLatin1());
+        buffer.append(',');
+        appendCsvField(buffer, invoice.getStatus());
+        buffer.append('\n');
+        if (buffer.size() >= kWriteBufferSize) {
+            written = written && file.write(buffer) == buffer.size();
+            buffer.resize(0);
+        }
+        });
+    written = written && file.write(buffer) == buffer.size();
+    return commitExport(file, written, errorString);
+}
+
+bool InvoiceTransfer::exportJson(const InvoiceStore& store, const QString& filePath, QString* errorString) {
+    NOOMYPLAN_TRACE_SCOPE("invoices.exportJson");
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return commitExport(file, false, errorString);
+    }
+
+    JsonStreamWriter writer(&file);
+    writer.beginObject();
+    writer.key(kInvoicesKey);
+    writer.beginArray();
+    store.forEach([&writer](const Invoice& invoice) { writer.value(invoice.toJson()); });
+    writer.endArray();
+    writer.endObject();
+    return commitExport(file, writer.flush(), errorString);
+}
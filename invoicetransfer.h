@@ -0,0 +1,89 @@
+#ifndef INVOICETRANSFER_H
+#define INVOICETRANSFER_H
+
+#include <QString>
+#include <QStringList>
+#include <string_view>
+#include <vector>
+#include "invoice.h"
+
+class InvoiceStore;
+
+/**
+ * @struct InvoiceImport
+ * @brief Invoices read from an import file, and what was wrong with the rest.
+ */
+struct InvoiceImport {
+    std::vector<Invoice> invoices; // Valid invoices in file order; their IDs are left at 0
+    qsizetype rowCount = 0;        // Invoices in the file, valid or not
+    qsizetype rejectedCount = 0;   // Invoices that failed validation
+    QStringList errors;            // The first problems found, e.g. "Line 12: due date "2024-13-01" is not yyyy-MM-dd"
+    QString fileError;             // Set when the file could not be read at all
+};
+
+/**
+ * @class InvoiceTransfer
+ * @brief Bulk import and export of invoices as CSV or JSON.
+ *
+ * Imports are parsed and validated in parallel. A CSV file is mapped and cut into
+ * chunks of whole records (see CsvReader), one chunk per pool task. A JSON file is
+ * streamed, and every batch of kJsonBatchSize invoices is validated on the pool
+ * while the next batch is parsed. Nothing is stored; the caller commits the
+ * valid invoices with one InvoiceStore::addAll().
+ *
+ * CSV files start with a header row. Columns are matched by name, so "customerName"
+ * and "Customer Name" both work and their order does not matter. customerName,
+ * customerAddress, amount and dueDate are required, and status is optional.
+ * Other columns, including invoiceID, are ignored. JSON files hold an array of
+ * invoice objects, either bare or under "invoices", as written by exportJson().
+ */
+class InvoiceTransfer {
+public:
+    static constexpr int kMaxReportedErrors = 50;   // Problems kept in InvoiceImport::errors
+    static constexpr int kJsonBatchSize = 4096;     // JSON invoices validated per pool task
+
+    /**
+     * @brief Imports a ".json" file with importJson() and anything else with importCsv().
+     */
+    static InvoiceImport importFile(const QString& filePath);
+
+    /**
+     * @brief Reads and validates the invoices of a CSV file.
+     */
+    static InvoiceImport importCsv(const QString& filePath);
+
+    /**
+     * @brief Reads and validates the invoices of a JSON file.
+     */
+    static InvoiceImport importJson(const QString& filePath);
+
+    /**
+     * @brief Writes every stored invoice as ".json" with exportJson() or anything else with exportCsv().
+     */
+    static bool exportFile(const InvoiceStore& store, const QString& filePath, QString* errorString = nullptr);
+
+    /**
+     * @brief Writes every stored invoice as CSV, with a header row, in ID order.
+     * @return False if the file could not be written; the previous file is then left intact.
+     */
+    static bool exportCsv(const InvoiceStore& store, const QString& filePath, QString* errorString = nullptr);
+
+    /**
+     * @brief Writes every stored invoice as {"invoices":[...]}, in ID order.
+     * @return False if the file could not be written; the previous file is then left intact.
+     */
+    static bool exportJson(const InvoiceStore& store, const QString& filePath, QString* errorString = nullptr);
+
+    /**
+     * @brief Checks one invoice's fields and builds the invoice.
+     * @param status May be empty, which means "Pending".
+     * @param invoice Receives the invoice, without an ID.
+     * @param error Receives the problem when false is returned.
+     * @return False if a required field is empty, the amount is not a number or exceeds Invoice::kMaxAmount,
+     *         or the due date is not yyyy-MM-dd.
+     */
+    static bool validate(const QString& customerName, const QString& customerAddress, std::string_view amount,
+        const QString& dueDate, const QString& status, Invoice& invoice, QString& error);
+};
+
+#endif // INVOICETRANSFER_H
@@ -0,0 +1,543 @@
+#include "jsonstream.h"
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtConcurrent/QtConcurrent>
+
+/**
+ * @class jsonstream.cpp
+ * @brief Implements the JsonStreamReader tokenizer and the JsonStreamWriter.
+ */
+
+namespace {
+
+/**
+ * @brief Appends a code point to a UTF-8 buffer.
+ */
+void appendUtf8(QByteArray& out, char32_t codePoint) {
+    if (codePoint < 0x80) {
+        out.append(static_cast<char>(codePoint));
+    }
+    else if (codePoint < 0x800) {
+        out.append(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if (codePoint < 0x10000) {
+        out.append(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else {
+        out.append(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+/**
+ * @brief Serializes a scalar the way QJsonDocument does, without the surrounding array.
+ */
+QByteArray scalarToJson(const QJsonValue& value) {
+    const QByteArray json = QJsonDocument(QJsonArray{ value }).toJson(QJsonDocument::Compact);
+    return json.mid(1, json.size() - 2);
+}
+
+} // namespace
+
+// --- JsonStreamReader -------------------------------------------------------
+
+JsonStreamReader::JsonStreamReader(QIODevice* device)
+    : device(device) {
+}
+
+JsonStreamReader::~JsonStreamReader() {
+    pendingRead.waitForFinished();
+}
+
+bool JsonStreamReader::refill() {
+    if (atEnd) {
+        return false;
+    }
+    consumed += buffer.size();
+    position = 0;
+    buffer = pendingRead.isValid() ? pendingRead.result() : device->read(kChunkSize);
+    if (buffer.isEmpty()) {
+        atEnd = true;
+        pendingRead = QFuture<QByteArray>();
+        return false;
+    }
+    // Only this task touches the device until the next refill() collects it
+    QIODevice* source = device;
+    pendingRead = QtConcurrent::run([source]() { return source->read(kChunkSize); });
+    return true;
+}
+
+JsonStreamReader::Token JsonStreamReader::fail(const QString& message) {
+    if (error.isEmpty()) {
+        error = QString("%1 at byte %2").arg(message).arg(consumed + position);
+    }
+    return Token::Error;
+}
+
+void JsonStreamReader::skipWhitespace() {
+    for (int c = peek(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = peek()) {
+        ++position;
+    }
+}
+
+bool JsonStreamReader::expectLiteral(const char* literal) {
+    for (const char* expected = literal; *expected; ++expected) {
+        if (get() != *expected) {
+            fail(QString("invalid literal, expected \"%1\"").arg(literal));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsonStreamReader::parseString(QString& out) {
+    stringBytes.resize(0);
+    for (;;) {
+        // Copy the run up to the next quote, escape or control character in one go
+        const int start = position;
+        while (position < buffer.size()) {
+            const unsigned char c = static_cast<unsigned char>(buffer[position]);
+            if (c == '"' || c == '\\' || c < 0x20) {
+                break;
+            }
+            ++position;
+        }
+        stringBytes.append(buffer.constData() + start, position - start);
+
+        if (position == buffer.size()) {
+            if (!refill()) {
+                fail("unterminated string");
+                return false;
+            }
+            continue; // The run goes on in the next chunk
+        }
+        const unsigned char c = static_cast<unsigned char>(buffer[position++]);
+        if (c == '"') {
+            break;
+        }
+        if (c < 0x20) {
+            fail("control character in string");
+            return false;
+        }
+
+        switch (get()) {
+        case '"': stringBytes.append('"'); break;
+        case '\\': stringBytes.append('\\'); break;
+        case '/': stringBytes.append('/'); break;
+        case 'b': stringBytes.append('\b'); break;
+        case 'f': stringBytes.append('\f'); break;
+        case 'n': stringBytes.append('\n'); break;
+        case 'r': stringBytes.append('\r'); break;
+        case 't': stringBytes.append('\t'); break;
+        case 'u': {
+            auto readHex = [this](char32_t& unit) {
+                unit = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const int h = get();
+                    unit <<= 4;
+                    if (h >= '0' && h <= '9') unit |= static_cast<char32_t>(h - '0');
+                    else if (h >= 'a' && h <= 'f') unit |= static_cast<char32_t>(h - 'a' + 10);
+                    else if (h >= 'A' && h <= 'F') unit |= static_cast<char32_t>(h - 'A' + 10);
+                    else return false;
+                }
+                return true;
+            };
+            char32_t unit;
+            if (!readHex(unit)) {
+                fail("invalid \\u escape");
+                return false;
+            }
+            if (unit >= 0xD800 && unit < 0xDC00 && peek() == '\\') {
+                // High surrogate; a low one should follow as a second escape
+                ++position;
+                char32_t low;
+                if (get() != 'u' || !readHex(low)) {
+                    fail("invalid \\u escape");
+                    return false;
+                }
+                if (low >= 0xDC00 && low < 0xE000) {
+                    appendUtf8(stringBytes, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                }
+                else {
+                    appendUtf8(stringBytes, 0xFFFD);
+                    appendUtf8(stringBytes, low >= 0xD800 && low < 0xE000 ? 0xFFFD : low);
+                }
+            }
+            else {
+                appendUtf8(stringBytes, unit >= 0xD800 && unit < 0xE000 ? 0xFFFD : unit); // Lone surrogate
+            }
+            break;
+        }
+        default:
+            fail("invalid escape in string");
+            return false;
+        }
+    }
+    out = QString::fromUtf8(stringBytes);
+    return true;
+}
+
+bool JsonStreamReader::parseNumber() {
+    char text[64];
+    int length = 0;
+    for (int c = peek(); (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'; c = peek()) {
+        if (length == sizeof(text) - 1) {
+            fail("number too long");
+            return false;
+        }
+        text[length++] = static_cast<char>(c);
+        ++position;
+    }
+    text[length] = '\0';
+
+    bool ok = false;
+    currentNumber = QByteArray::fromRawData(text, length).toDouble(&ok);
+    if (!ok) {
+        fail("invalid number");
+        return false;
+    }
+    return true;
+}
+
+JsonStreamReader::Token JsonStreamReader::finishValue(Token token) {
+    if (scopes.empty()) {
+        rootDone = true;
+    }
+    return token;
+}
+
+JsonStreamReader::Token JsonStreamReader::parseValueStart() {
+    skipWhitespace();
+    const int c = peek();
+    switch (c) {
+    case '{':
+    case '[':
+        if (scopes.size() >= kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        ++position;
+        scopes.push_back({ c == '{' });
+        return c == '{' ? Token::BeginObject : Token::BeginArray;
+    case '"':
+        ++position;
+        return parseString(currentText) ? finishValue(Token::String) : Token::Error;
+    case 't':
+        currentBool = true;
+        return expectLiteral("true") ? finishValue(Token::Bool) : Token::Error;
+    case 'f':
+        currentBool = false;
+        return expectLiteral("false") ? finishValue(Token::Bool) : Token::Error;
+    case 'n':
+        return expectLiteral("null") ? finishValue(Token::Null) : Token::Error;
+    case -1:
+        return fail("unexpected end of data");
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return parseNumber() ? finishValue(Token::Number) : Token::Error;
+        }
+        return fail(QString("unexpected character '%1'").arg(QChar(c)));
+    }
+}
+
+JsonStreamReader::Token JsonStreamReader::next() {
+    if (hasError()) {
+        return Token::Error;
+    }
+    skipWhitespace();
+
+    if (rootDone) {
+        return peek() < 0 ? Token::End : fail("unexpected data after the top-level value");
+    }
+    if (scopes.empty() || afterKey) {
+        afterKey = false;
+        return parseValueStart();
+    }
+
+    Scope& scope = scopes.back();
+    int c = peek();
+    if (c < 0) {
+        return fail("unexpected end of data");
+    }
+    if (c == (scope.object ? '}' : ']')) {
+        ++position;
+        const bool object = scope.object;
+        scopes.pop_back();
+        return finishValue(object ? Token::EndObject : Token::EndArray);
+    }
+    if (!scope.first) {
+        if (c != ',') {
+            return fail(scope.object ? "expected ',' or '}'" : "expected ',' or ']'");
+        }
+        ++position;
+        skipWhitespace();
+        c = peek();
+    }
+    scope.first = false;
+
+    if (!scope.object) {
+        if (c == ']') {
+            return fail("trailing comma");
+        }
+        return parseValueStart();
+    }
+
+    if (c != '"') {
+        return fail("expected a member name");
+    }
+    ++position;
+    if (!parseString(currentText)) {
+        return Token::Error;
+    }
+    skipWhitespace();
+    if (get() != ':') {
+        return fail("expected ':'");
+    }
+    afterKey = true;
+    return Token::Key;
+}
+
+QJsonValue JsonStreamReader::readValue(Token token) {
+    switch (token) {
+    case Token::BeginObject: {
+        QJsonObject object;
+        for (Token member = next(); member != Token::EndObject; member = next()) {
+            if (member != Token::Key) {
+                return QJsonValue(QJsonValue::Undefined);
+            }
+            const QString name = currentText;
+            const QJsonValue value = readValue(next());
+            if (value.isUndefined()) {
+                return value;
+            }
+            object.insert(name, value);
+        }
+        return object;
+    }
+    case Token::BeginArray: {
+        QJsonArray array;
+        for (Token element = next(); element != Token::EndArray; element = next()) {
+            const QJsonValue value = readValue(element);
+            if (value.isUndefined()) {
+                return value;
+            }
+            array.append(value);
+        }
+        return array;
+    }
+    case Token::String:
+        return currentText;
+    case Token::Number:
+        return currentNumber;
+    case Token::Bool:
+        return currentBool;
+    case Token::Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+bool JsonStreamReader::skipValue(Token token) {
+    switch (token) {
+    case Token::BeginObject:
+    case Token::BeginArray: {
+        for (int depth = 1; depth > 0;) {
+            switch (next()) {
+            case Token::BeginObject:
+            case Token::BeginArray:
+                ++depth;
+                break;
+            case Token::EndObject:
+            case Token::EndArray:
+                --depth;
+                break;
+            case Token::Error:
+            case Token::End:
+                return false;
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+    case Token::String:
+    case Token::Number:
+    case Token::Bool:
+    case Token::Null:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool JsonStreamReader::readObjectArray(QIODevice* device, const QString& arrayKey,
+    const std::function<void(const QJsonObject&)>& visit,
+    QJsonObject* otherMembers, QString* errorString) {
+    JsonStreamReader reader(device);
+
+    auto readRecords = [&reader, &visit]() {
+        for (Token element = reader.next(); element != Token::EndArray; element = reader.next()) {
+            if (element == Token::BeginObject) {
+                const QJsonValue record = reader.readValue(element);
+                if (record.isUndefined()) {
+                    return false;
+                }
+                visit(record.toObject());
+            }
+            else if (!reader.skipValue(element)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    bool ok = false;
+    const Token root = reader.next();
+    if (root == Token::BeginArray) {
+        ok = readRecords();
+    }
+    else if (root == Token::BeginObject) {
+        ok = true;
+        for (Token member = reader.next(); ok && member != Token::EndObject; member = reader.next()) {
+            if (member != Token::Key) {
+                ok = false;
+                break;
+            }
+            const QString name = reader.text();
+            const Token value = reader.next();
+            if (name == arrayKey && value == Token::BeginArray) {
+                ok = readRecords();
+            }
+            else if (otherMembers) {
+                const QJsonValue memberValue = reader.readValue(value);
+                ok = !memberValue.isUndefined();
+                otherMembers->insert(name, memberValue);
+            }
+            else {
+                ok = reader.skipValue(value);
+            }
+        }
+    }
+    else if (root != Token::Error) {
+        reader.fail("expected an object or an array");
+    }
+
+    if (ok && reader.next() != Token::End) {
+        ok = false;
+    }
+    if (!ok && errorString) {
+        *errorString = reader.hasError() ? reader.errorString() : QString("invalid JSON");
+    }
+    return ok;
+}
+
+// --- JsonStreamWriter -------------------------------------------------------
+
+JsonStreamWriter::JsonStreamWriter(QIODevice* device)
+    : device(device) {
+}
+
+JsonStreamWriter::~JsonStreamWriter() {
+    flush();
+}
+
+void JsonStreamWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (scopes.empty()) {
+        return;
+    }
+    Scope& scope = scopes.back();
+    if (!scope.first) {
+        buffer.append(',');
+    }
+    scope.first = false;
+    if (!scope.object) {
+        buffer.append('\n'); // One element per line
+    }
+}
+
+void JsonStreamWriter::beginObject() {
+    separate();
+    buffer.append('{');
+    scopes.push_back({ true });
+}
+
+void JsonStreamWriter::endObject() {
+    scopes.pop_back();
+    buffer.append('}');
+    flushIfFull();
+}
+
+void JsonStreamWriter::beginArray() {
+    separate();
+    buffer.append('[');
+    scopes.push_back({ false });
+}
+
+void JsonStreamWriter::endArray() {
+    if (!scopes.back().first) {
+        buffer.append('\n');
+    }
+    scopes.pop_back();
+    buffer.append(']');
+    flushIfFull();
+}
+
+void JsonStreamWriter::key(const QString& name) {
+    separate();
+    writeString(name);
+    buffer.append(':');
+    afterKey = true;
+}
+
+void JsonStreamWriter::value(const QJsonValue& value) {
+    separate();
+    if (value.isObject()) {
+        buffer.append(QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact));
+    }
+    else if (value.isArray()) {
+        buffer.append(QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact));
+    }
+    else {
+        writeScalar(value);
+    }
+    flushIfFull();
+}
+
+void JsonStreamWriter::writeString(const QString& text) {
+    buffer.append(scalarToJson(text));
+}
+
+void JsonStreamWriter::writeScalar(const QJsonValue& value) {
+    if (value.isUndefined()) {
+        buffer.append("null");
+    }
+    else {
+        buffer.append(scalarToJson(value));
+    }
+}
+
+void JsonStreamWriter::flushIfFull() {
+    if (buffer.size() >= kFlushThreshold) {
+        flush();
+    }
+}
+
+bool JsonStreamWriter::flush() {
+    if (!buffer.isEmpty()) {
+        if (device->write(buffer) != buffer.size()) {
+            failed = true;
+        }
+        buffer.resize(0); // Keeps the allocation for the next batch
+    }
+    return !failed;
+}
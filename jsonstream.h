@@ -0,0 +1,252 @@
+#ifndef JSONSTREAM_H
+#define JSONSTREAM_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <functional>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+/**
+ * @class JsonStreamReader
+ * @brief Pull parser that reads JSON from a device token by token.
+ *
+ * The device is read in fixed-size chunks, so memory does not grow with the file.
+ * While one chunk is parsed the next is read on the global thread pool, which
+ * overlaps parsing with the disk. Each next() returns one token; readValue() turns the value starting at
+ * the current token into a QJsonValue, which is how a single record of a large
+ * array is materialized without building the whole document.
+ *
+ * readObjectArray() covers the layout all of our data files share: an array of
+ * records, either at the top level or under one member of the top-level object.
+ */
+class JsonStreamReader {
+public:
+    /**
+     * @brief Kinds of token next() returns.
+     */
+    enum class Token {
+        BeginObject,
+        EndObject,
+        BeginArray,
+        EndArray,
+        Key,    // Member name; text() holds it
+        String, // text() holds the value
+        Number, // number() holds the value
+        Bool,   // boolean() holds the value
+        Null,
+        End,    // The top-level value is complete
+        Error   // errorString() says why; every later call returns Error too
+    };
+
+    /**
+     * @brief Reads from an open device; the device must outlive the reader.
+     */
+    explicit JsonStreamReader(QIODevice* device);
+
+    /**
+     * @brief Waits for a chunk that is still being read.
+     *
+     * The reader reads ahead, so the device position is past the parsed text afterwards.
+     */
+    ~JsonStreamReader();
+
+    JsonStreamReader(const JsonStreamReader&) = delete;
+    JsonStreamReader& operator=(const JsonStreamReader&) = delete;
+
+    /**
+     * @brief Reads the next token.
+     */
+    Token next();
+
+    /**
+     * @brief Returns the member name of a Key token or the value of a String token.
+     */
+    const QString& text() const { return currentText; }
+
+    /**
+     * @brief Returns the value of a Number token.
+     */
+    double number() const { return currentNumber; }
+
+    /**
+     * @brief Returns the value of a Bool token.
+     */
+    bool boolean() const { return currentBool; }
+
+    /**
+     * @brief Reads the value that starts with token, consuming a whole object or array.
+     * @param token The token just returned by next().
+     * @return The value, or an undefined QJsonValue on error or for a non-value token.
+     */
+    QJsonValue readValue(Token token);
+
+    /**
+     * @brief Skips the value that starts with token without building it.
+     * @return False on a parse error.
+     */
+    bool skipValue(Token token);
+
+    /**
+     * @brief Returns true once a parse or read error occurred.
+     */
+    bool hasError() const { return !error.isEmpty(); }
+
+    /**
+     * @brief Describes the error, including the byte offset it was found at.
+     */
+    QString errorString() const { return error; }
+
+    /**
+     * @brief Streams the records of a JSON file one object at a time.
+     * @param device Open device positioned at the start of the JSON text.
+     * @param arrayKey Member of the top-level object that holds the records. A top-level array is read as the records too.
+     * @param visit Called with each record; elements that are not objects are skipped.
+     * @param otherMembers If set, receives the top-level object's other members.
+     * @param errorString If set, receives the reason when false is returned.
+     * @return False if the text is not valid JSON; records visited before the error stay visited.
+     */
+    static bool readObjectArray(QIODevice* device, const QString& arrayKey,
+        const std::function<void(const QJsonObject&)>& visit,
+        QJsonObject* otherMembers = nullptr, QString* errorString = nullptr);
+
+private:
+    static constexpr qint64 kChunkSize = 64 * 1024; // Bytes read from the device at a time
+    static constexpr size_t kMaxDepth = 512;         // Deepest nesting accepted, so readValue() cannot exhaust the stack
+
+    /**
+     * @brief An object or array being parsed.
+     */
+    struct Scope {
+        bool object;       // Object or array
+        bool first = true; // No member or element read yet
+    };
+
+    QIODevice* device;
+    QByteArray buffer;               // Current chunk
+    QFuture<QByteArray> pendingRead; // Next chunk, read while the current one is parsed
+    QByteArray stringBytes;          // UTF-8 of the string being parsed; reused between strings
+    int position = 0;                // Next byte in buffer
+    qint64 consumed = 0;             // Bytes of earlier chunks, for error offsets
+    bool atEnd = false;              // The device has no more data
+    std::vector<Scope> scopes;       // Open objects and arrays, innermost last
+    bool afterKey = false;           // A key and colon were read; a value follows
+    bool rootDone = false;           // The top-level value is complete
+    QString currentText;
+    double currentNumber = 0;
+    bool currentBool = false;
+    QString error;
+
+    /**
+     * @brief Returns the next byte without consuming it, or -1 at the end of the data.
+     */
+    int peek() {
+        if (position < buffer.size()) {
+            return static_cast<unsigned char>(buffer[position]);
+        }
+        return refill() ? static_cast<unsigned char>(buffer[position]) : -1;
+    }
+
+    /**
+     * @brief Consumes and returns the next byte, or -1 at the end of the data.
+     */
+    int get() {
+        const int c = peek();
+        if (c >= 0) {
+            ++position;
+        }
+        return c;
+    }
+
+    /**
+     * @brief Reads the next chunk; returns false at the end of the data.
+     */
+    bool refill();
+
+    void skipWhitespace();
+    bool expectLiteral(const char* literal);
+    bool parseString(QString& out);
+    bool parseNumber();
+    Token parseValueStart();
+    Token finishValue(Token token);
+    Token fail(const QString& message);
+};
+
+/**
+ * @class JsonStreamWriter
+ * @brief Writes JSON to a device incrementally through a small buffer.
+ *
+ * Arrays put each element on its own line, so record files stay readable and
+ * diffable, while memory stays bounded by the largest single element. Elements
+ * are typically whole records passed to value() as a QJsonObject.
+ */
+class JsonStreamWriter {
+public:
+    /**
+     * @brief Writes to an open device; the device must outlive the writer.
+     */
+    explicit JsonStreamWriter(QIODevice* device);
+
+    /**
+     * @brief Flushes whatever is still buffered.
+     */
+    ~JsonStreamWriter();
+
+    JsonStreamWriter(const JsonStreamWriter&) = delete;
+    JsonStreamWriter& operator=(const JsonStreamWriter&) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    /**
+     * @brief Writes a member name; the next call must write its value.
+     */
+    void key(const QString& name);
+
+    /**
+     * @brief Writes a complete value: a scalar, or an object or array held in memory.
+     */
+    void value(const QJsonValue& value);
+
+    /**
+     * @brief Writes the buffer to the device.
+     * @return False if the device reported a write error, now or earlier.
+     */
+    bool flush();
+
+private:
+    static constexpr int kFlushThreshold = 64 * 1024; // Buffered bytes that trigger a write
+
+    /**
+     * @brief An object or array being written.
+     */
+    struct Scope {
+        bool object;
+        bool first = true;
+    };
+
+    QIODevice* device;
+    QByteArray buffer;
+    std::vector<Scope> scopes;
+    bool afterKey = false;
+    bool failed = false;
+
+    /**
+     * @brief Writes the separator that goes before a value or member in the current scope.
+     */
+    void separate();
+
+    void writeString(const QString& text);
+    void writeScalar(const QJsonValue& value);
+    void flushIfFull();
+};
+
+#endif // JSONSTREAM_H
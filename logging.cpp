@@ -0,0 +1,194 @@
+#include "logging.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class logging.cpp
+ * @brief Implements the logging categories and the asynchronous message sink.
+ */
+
+Q_LOGGING_CATEGORY(lcApp, "noomyplan.app")
+Q_LOGGING_CATEGORY(lcAuth, "noomyplan.auth")
+Q_LOGGING_CATEGORY(lcBudget, "noomyplan.budget")
+Q_LOGGING_CATEGORY(lcInventory, "noomyplan.inventory")
+Q_LOGGING_CATEGORY(lcInvoice, "noomyplan.invoice")
+Q_LOGGING_CATEGORY(lcReport, "noomyplan.report")
+
+namespace {
+
+constexpr size_t kMaxQueuedMessages = 10000; // Beyond this, messages are dropped instead of queued
+
+/**
+ * @brief A message as handed over by Qt; formatting into a line happens on the writer thread.
+ */
+struct LogMessage {
+    QtMsgType type;
+    QByteArray category;
+    QString text;
+    qint64 timestamp; // Milliseconds since the epoch
+};
+
+/**
+ * @brief State of the running sink.
+ */
+struct Sink {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<LogMessage> queue;
+    bool stopping = false;
+    bool running = false;
+    std::thread writer;
+    std::FILE* logFile = nullptr;
+    QtMessageHandler previousHandler = nullptr;
+    std::atomic<quint64> dropped{ 0 };
+};
+
+Sink& sink() {
+    static Sink instance;
+    return instance;
+}
+
+const char* levelName(QtMsgType type) {
+    switch (type) {
+    case QtDebugMsg: return "debug";
+    case QtInfoMsg: return "info";
+    case QtWarningMsg: return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg: return "fatal";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Writes one message as "2024-06-01 12:00:00.000 warning noomyplan.report: text".
+ */
+void writeMessage(std::FILE* logFile, const LogMessage& message) {
+    const QByteArray line = QDateTime::fromMSecsSinceEpoch(message.timestamp).toString("yyyy-MM-dd HH:mm:ss.zzz").toUtf8() +
+        ' ' + levelName(message.type) + ' ' + message.category + ": " + message.text.toUtf8() + '\n';
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stderr);
+    if (logFile) {
+        std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), logFile);
+    }
+}
+
+/**
+ * @brief Writer thread: takes whole batches off the queue and flushes once per batch.
+ */
+void writerLoop() {
+    Sink& shared = sink();
+    std::deque<LogMessage> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(shared.mutex);
+            shared.wake.wait(lock, [&shared]() { return shared.stopping || !shared.queue.empty(); });
+            if (shared.queue.empty()) {
+                return; // Stopping and nothing left to write
+            }
+            batch.swap(shared.queue);
+        }
+        for (const LogMessage& message : batch) {
+            writeMessage(shared.logFile, message);
+        }
+        batch.clear();
+        std::fflush(stderr);
+        if (shared.logFile) {
+            std::fflush(shared.logFile);
+        }
+    }
+}
+
+/**
+ * @brief Message handler installed while the sink runs; only queues the message.
+ */
+void queueMessage(QtMsgType type, const QMessageLogContext& context, const QString& text) {
+    Sink& shared = sink();
+    LogMessage message{ type, QByteArray(context.category ? context.category : "default"), text,
+        QDateTime::currentMSecsSinceEpoch() };
+
+    const bool fatal = type == QtFatalMsg;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!fatal && shared.queue.size() >= kMaxQueuedMessages) {
+            shared.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        shared.queue.push_back(std::move(message));
+    }
+    shared.wake.notify_one();
+
+    if (fatal) {
+        Logging::stopAsyncSink(); // Qt aborts right after this returns, so write everything now
+    }
+}
+
+} // namespace
+
+namespace Logging {
+
+void startAsyncSink(const QString& logFilePath) {
+    Sink& shared = sink();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.running) {
+        return;
+    }
+    if (!logFilePath.isEmpty()) {
+        shared.logFile = std::fopen(QFile::encodeName(logFilePath).constData(), "a");
+        if (!shared.logFile) {
+            std::fprintf(stderr, "Could not open log file %s\n", qPrintable(logFilePath));
+        }
+    }
+    shared.stopping = false;
+    shared.running = true;
+    shared.writer = std::thread(writerLoop);
+    shared.previousHandler = qInstallMessageHandler(queueMessage);
+}
+
+void stopAsyncSink() {
+    Sink& shared = sink();
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        if (!shared.running) {
+            return;
+        }
+        shared.running = false;
+        shared.stopping = true;
+        qInstallMessageHandler(shared.previousHandler);
+    }
+    shared.wake.notify_one();
+    if (shared.writer.joinable()) {
+        shared.writer.join();
+    }
+
+    // A thread that entered queueMessage() before the handler was restored may have queued after the writer's last batch
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (const LogMessage& message : shared.queue) {
+            writeMessage(shared.logFile, message);
+        }
+        shared.queue.clear();
+        std::fflush(stderr);
+    }
+
+    const quint64 dropped = shared.dropped.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::fprintf(stderr, "%llu log messages were dropped because logging fell behind\n",
+            static_cast<unsigned long long>(dropped));
+    }
+    if (shared.logFile) {
+        std::fclose(shared.logFile);
+        shared.logFile = nullptr;
+    }
+}
+
+quint64 droppedMessageCount() {
+    return sink().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace Logging
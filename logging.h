@@ -0,0 +1,79 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+
+/**
+ * @namespace Logging
+ * @brief Leveled, categorized logging with a compile-time threshold and an asynchronous sink.
+ *
+ * Code logs through NOOMYPLAN_LOG_DEBUG(lcReport) << ... and its INFO, WARNING and
+ * CRITICAL siblings, which wrap qCDebug() and friends. Messages below
+ * NOOMYPLAN_LOG_LEVEL are compiled out: the statement becomes a loop that never
+ * runs, so its stream arguments are neither evaluated nor formatted. Debug builds
+ * keep everything; builds with NDEBUG start at INFO unless NOOMYPLAN_LOG_LEVEL is
+ * set (CMake cache variable of the same name). Messages that are compiled in can
+ * still be filtered at runtime per category with QT_LOGGING_RULES, e.g.
+ * "noomyplan.budget.debug=false".
+ *
+ * startAsyncSink() routes all Qt messages to a background thread that timestamps
+ * them and writes them to stderr and, optionally, a log file, so logging never
+ * waits for I/O on the calling thread. If the sink falls behind, further messages
+ * are dropped and counted instead of blocking.
+ */
+
+#define NOOMYPLAN_LOG_LEVEL_DEBUG 0
+#define NOOMYPLAN_LOG_LEVEL_INFO 1
+#define NOOMYPLAN_LOG_LEVEL_WARNING 2
+#define NOOMYPLAN_LOG_LEVEL_CRITICAL 3
+
+#ifndef NOOMYPLAN_LOG_LEVEL
+#ifdef NDEBUG
+#define NOOMYPLAN_LOG_LEVEL NOOMYPLAN_LOG_LEVEL_INFO
+#else
+#define NOOMYPLAN_LOG_LEVEL NOOMYPLAN_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// Same shape as Qt's qCDebug(): a one-pass loop, so the macro is safe in unbraced if/else
+#define NOOMYPLAN_LOG_AT(level, qtMacro, category) \
+    for (bool noomyplanLogEnabled = (level) >= NOOMYPLAN_LOG_LEVEL; noomyplanLogEnabled; noomyplanLogEnabled = false) \
+        qtMacro(category)
+
+#define NOOMYPLAN_LOG_DEBUG(category) NOOMYPLAN_LOG_AT(NOOMYPLAN_LOG_LEVEL_DEBUG, qCDebug, category)
+#define NOOMYPLAN_LOG_INFO(category) NOOMYPLAN_LOG_AT(NOOMYPLAN_LOG_LEVEL_INFO, qCInfo, category)
+#define NOOMYPLAN_LOG_WARNING(category) NOOMYPLAN_LOG_AT(NOOMYPLAN_LOG_LEVEL_WARNING, qCWarning, category)
+#define NOOMYPLAN_LOG_CRITICAL(category) NOOMYPLAN_LOG_AT(NOOMYPLAN_LOG_LEVEL_CRITICAL, qCCritical, category)
+
+Q_DECLARE_LOGGING_CATEGORY(lcApp)       // noomyplan.app: main window, startup and shutdown
+Q_DECLARE_LOGGING_CATEGORY(lcAuth)      // noomyplan.auth: logins, sign-ups, user file
+Q_DECLARE_LOGGING_CATEGORY(lcBudget)    // noomyplan.budget: budget page and its persistence
+Q_DECLARE_LOGGING_CATEGORY(lcInventory) // noomyplan.inventory: inventory page and its persistence
+Q_DECLARE_LOGGING_CATEGORY(lcInvoice)   // noomyplan.invoice: invoice store and its journal
+Q_DECLARE_LOGGING_CATEGORY(lcReport)    // noomyplan.report: CSV loading and financial reports
+
+namespace Logging {
+
+/**
+ * @brief Routes all Qt messages through a background writer thread.
+ * @param logFilePath File to append messages to as well as stderr; empty for stderr only.
+ *
+ * Fatal messages are written synchronously after everything queued before them.
+ * Calling it again while the sink runs does nothing.
+ */
+void startAsyncSink(const QString& logFilePath = QString());
+
+/**
+ * @brief Writes out every queued message, stops the writer thread and restores the previous handler.
+ */
+void stopAsyncSink();
+
+/**
+ * @brief Returns how many messages were dropped because the queue was full.
+ */
+quint64 droppedMessageCount();
+
+} // namespace Logging
+
+#endif // LOGGING_H
@@ -1,5 +1,5 @@
 #include "loginpage.h"
-#include <iostream>
+#include "logging.h"
 #include <QDir>
 #include <QDialog>
 #include <QTimer>
@@ -96,7 +96,7 @@ void LoginPage::handleLogin() {
         return;
     }
 
-    std::cout << "Attempting login for user: " << id.toStdString() << std::endl;
+    NOOMYPLAN_LOG_DEBUG(lcAuth) << "Attempting login for user:" << id;
 
     bool success = authSystem->authenticateUser(id);
 
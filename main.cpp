@@ -5,6 +5,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QHeaderView>
@@ -24,6 +25,7 @@
 #include <QGroupBox>
 #include <QInputDialog>
 #include <QTextEdit>
+#include <QShortcut>
 #include "loginpage.h"
 #include "authenticatesystem.h"
 #include "financialreport.h"
@@ -33,11 +35,14 @@
 #include "inventory.h"
 #include "mainwindow.h"
 #include "invoicemanager.h"
+#include "jsonstream.h"
+#include "metricspanel.h"
+#include "tracing.h"
 #include <QTextBrowser>
 #include <QDir>
 #include <QCoreApplication>
 #include <QStandardPaths>
-#include <QDebug>
+#include "logging.h"
 
 /**
  * @brief Constructor for MainWindow.
@@ -67,7 +72,7 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
 
     dashboardPage = new Dashboard();  // Create the dashboard widget
     QWidget* financialsPage = new QWidget(); // Create the financials page widget
-    BudgetPage* budgetPage = new BudgetPage(); // Create the budget page widget
+    budgetPage = new BudgetPage(); // Create the budget page widget; the member, so closeEvent can flush it
     QWidget* cashflowTrackingPage = new QWidget(); // Create the cashflow tracking page widget
     InvoiceManager* billingPage = new InvoiceManager();
 
@@ -79,6 +84,8 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
 
 
     dashboardPage->setInventoryTable(sharedInventoryTable); // Set the shared inventory table for the dashboard
+    dashboardPage->setInvoiceStore(&billingPage->store()); // Receivables tile follows the invoice book
+    connect(billingPage, &InvoiceManager::invoicesChanged, dashboardPage, &Dashboard::updateReceivables);
 
 
     inventoryPage = new InventoryPage(); // Create the inventory page widget
@@ -174,12 +181,14 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     // Connect the profit/loss button to generate and display a profit/loss report
     connect(profitLossButton, &QPushButton::clicked, this, [this]() {
         try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateProfitLossStatement("profit_loss_statement.csv");
+            if (!reportGenerator.ensureLoaded("business_financials.csv")) {
+                QMessageBox::warning(this, "Error", "Failed to load financial data");
+            }
+            else if (reportGenerator.generateProfitLossStatement("profit_loss_statement.csv")) {
                 QMessageBox::information(this, "Success", "Profit & Loss statement generated");
             }
             else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
+                QMessageBox::warning(this, "Error", "Failed to write profit_loss_statement.csv");
             }
         }
         catch (const std::exception& e) {
@@ -190,12 +199,14 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     // Connect the expense breakdown button to generate and display a expense breakdown report
     connect(expenseBreakdownButton, &QPushButton::clicked, this, [this]() {
         try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateExpenseBreakdownReport("expense_breakdown_report.csv");
+            if (!reportGenerator.ensureLoaded("business_financials.csv")) {
+                QMessageBox::warning(this, "Error", "Failed to load financial data");
+            }
+            else if (reportGenerator.generateExpenseBreakdownReport("expense_breakdown_report.csv")) {
                 QMessageBox::information(this, "Success", "Expense breakdown report generated");
             }
             else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
+                QMessageBox::warning(this, "Error", "Failed to write expense_breakdown_report.csv");
             }
         }
         catch (const std::exception& e) {
@@ -206,12 +217,14 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     // Connect the balance sheet button to generate and display a balance sheet report
     connect(balanceSheetButton, &QPushButton::clicked, this, [this]() {
         try {
-            if (reportGenerator.loadCSV("business_financials.csv")) {
-                reportGenerator.generateBalanceSheetReport("balance_sheet_report.csv");
+            if (!reportGenerator.ensureLoaded("business_financials.csv")) {
+                QMessageBox::warning(this, "Error", "Failed to load financial data");
+            }
+            else if (reportGenerator.generateBalanceSheetReport("balance_sheet_report.csv")) {
                 QMessageBox::information(this, "Success", "Balance sheet report generated");
             }
             else {
-                QMessageBox::warning(this, "Error", "Failed to load financial data");
+                QMessageBox::warning(this, "Error", "Failed to write balance_sheet_report.csv");
             }
         }
         catch (const std::exception& e) {
@@ -221,7 +234,7 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
 
     // Connect tab changes to update the budget page when the Budget tab is selected
     connect(tabWidget, &QTabWidget::currentChanged, this, [=](int index) {
-        qDebug() << "Switched to tab:" << index;
+        NOOMYPLAN_LOG_DEBUG(lcApp) << "Switched to tab:" << index;
         if (index == 3) {  // Budget tab
             budgetPage->update();
             budgetPage->repaint();
@@ -393,10 +406,14 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     cashflowLayout->addSpacing(8);
     cashflowLayout->addWidget(titleLabel);
 
-    tableWidget = new QTableWidget(cashflowTrackingPage);
-    tableWidget->setColumnCount(8);
-    tableWidget->setHorizontalHeaderLabels({ "ID", "Date/Time", "Seller", "Buyer", "Merchandise", "Cost", "Currency", "Category" });
-    tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // The model formats rows from the ledger on demand, so only visible rows cost anything
+    transactionModel = new CashflowTableModel(cashflowTracking, this);
+    transactionTable = new QTableView(cashflowTrackingPage);
+    transactionTable->setModel(transactionModel);
+    transactionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    transactionTable->verticalHeader()->setVisible(false);
+    transactionTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed); // Uniform rows; no per-row size hints
+    transactionTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
 
 
 
@@ -421,7 +438,7 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
     // Add the button layout to the main vertical layout
     cashflowLayout->addLayout(buttonLayout);
 
-    cashflowLayout->addWidget(tableWidget);
+    cashflowLayout->addWidget(transactionTable);
     cashflowTrackingPage->setLayout(cashflowLayout);
 
     //connect buttons
@@ -434,8 +451,8 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
         if (ok) {
             if (cashflowTracking.searchDataEntries(transID)) {
                 cashflowTracking.deleteData(transID);
+                transactionModel->transactionRemoved(transID); // Remove just that row
                 QMessageBox::information(this, "Success", "Transaction deleted successfully.");
-                updateTransactionTable(); // Refresh the table
             }
             else {
                 QMessageBox::warning(this, "Error", "Transaction ID not found.");
@@ -447,6 +464,10 @@ MainWindow::MainWindow(AuthenticateSystem* authSystem, QWidget* parent)
 
     //connect(qApp, &QCoreApplication::aboutToQuit, inventoryPage, &InventoryPage::saveInventoryData);
 
+    // Developer shortcut; the metrics panel is deliberately not in any menu
+    QShortcut* metricsShortcut = new QShortcut(QKeySequence("Ctrl+Shift+M"), this);
+    connect(metricsShortcut, &QShortcut::activated, this, &MainWindow::showMetricsPanel);
+
 }
 
 /**
@@ -461,6 +482,18 @@ MainWindow::~MainWindow() {
     // Nothing needs to be deleted manually because Qt handles child QObjects
 }
 
+/**
+ * @brief Shows the hidden performance metrics panel, creating it on first use.
+ */
+void MainWindow::showMetricsPanel() {
+    if (!metricsPanel) {
+        metricsPanel = new MetricsPanel(this);
+    }
+    metricsPanel->show();
+    metricsPanel->raise();
+    metricsPanel->activateWindow();
+}
+
 void MainWindow::handleLogout() {
     QMessageBox::StandardButton confirm = QMessageBox::question(
         this, "Logout", "Are you sure you want to logout?",
@@ -475,34 +508,6 @@ void MainWindow::handleLogout() {
     }
 }
 
-void MainWindow::handleTableEdit(int row, int column) {
-    if (row < 0 || row >= tableWidget->rowCount()) return;
-
-    // Clear previous data and rebuild from table
-    cashflowTracking.clear();  // You’ll need to add this method (see below)
-
-    for (int i = 0; i < tableWidget->rowCount(); ++i) {
-        int id = tableWidget->item(i, 0)->text().toInt();
-        QString dateTime = tableWidget->item(i, 1)->text();
-        QString seller = tableWidget->item(i, 2)->text();
-        QString buyer = tableWidget->item(i, 3)->text();
-        QString merchandise = tableWidget->item(i, 4)->text();
-        QString costStr = tableWidget->item(i, 5)->text();
-        QString currency = tableWidget->item(i, 6)->text();
-        QString category = tableWidget->item(i, 7)->text();
-
-        costStr.remove('$');
-        costStr.remove(',');
-        double cost = costStr.toDouble();
-
-        cashflowTracking.addData(dateTime.toStdString(), seller.toStdString(), buyer.toStdString(),
-            merchandise.toStdString(), cost, currency.toStdString(), category.toStdString());
-
-    }
-
-    saveTransactions();  // persist updates
-}
-
 
 void MainWindow::showTutorialDialog() {
     QDialog* tutorialDialog = new QDialog(this);
@@ -683,10 +688,10 @@ void MainWindow::addTransaction() {
         QString category = categoryEdit.text().trimmed();
         QString costStr = costEdit.text().trimmed();
 
-        bool ok;
-        double cost = costStr.toDouble(&ok);
+        Money cost;
+        const bool ok = Money::parse(costStr.toStdString(), cost);
 
-        if (!ok || cost <= 0 || dateTime.isEmpty() || seller.isEmpty() || buyer.isEmpty() || merchandise.isEmpty() || category.isEmpty()) {
+        if (!ok || cost <= Money() || dateTime.isEmpty() || seller.isEmpty() || buyer.isEmpty() || merchandise.isEmpty() || category.isEmpty()) {
             QMessageBox::warning(&dialog, "Input Error", "All fields must be filled with valid data.");
             return;
         }
@@ -697,7 +702,7 @@ void MainWindow::addTransaction() {
             return;
         }
 
-        cashflowTracking.addData(
+        int transID = cashflowTracking.addData(
             dateTime.toStdString(),
             seller.toStdString(),
             buyer.toStdString(),
@@ -707,7 +712,7 @@ void MainWindow::addTransaction() {
             category.toStdString()
         );
 
-        updateTransactionTable();
+        transactionModel->transactionAdded(transID); // Insert just the new row
         dialog.accept();
         });
 
@@ -718,36 +723,14 @@ void MainWindow::addTransaction() {
 /**
  * @brief Updates the transaction table with the latest data.
  *
- * Retrieves all transactions from CashflowTracking and populates the table widget
- * with the transaction details.
+ * Resets the table model so it re-reads the transaction IDs from CashflowTracking,
+ * e.g. after a ledger was loaded. Cell text is only formatted for visible rows.
+ * Single additions and deletions update the model directly instead.
  *
  * @author Abbygail Latimer
  */
 void MainWindow::updateTransactionTable() {
-    // Populate the transaction table with data from CashflowTracking
-    tableWidget->setRowCount(0); // Clear the table by setting the row count to 0
-
-    // Retrieve all data entries from the CashflowTracking object
-    std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-
-    // Iterate through each transaction entry
-    for (const auto& entry : transactions) {
-        // Get the current row count and insert a new row at the end
-        int row = tableWidget->rowCount();
-        tableWidget->insertRow(row);
-
-        // Populate the table with data from the current entry
-        tableWidget->setItem(row, 0, new QTableWidgetItem(QString::number(entry.transid))); // Transaction ID
-        tableWidget->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(entry.dateTime))); // Date and Time
-        tableWidget->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(entry.seller))); // Seller
-        tableWidget->setItem(row, 3, new QTableWidgetItem(QString::fromStdString(entry.buyer))); // Buyer
-        tableWidget->setItem(row, 4, new QTableWidgetItem(QString::fromStdString(entry.merchandise))); // Merchandise
-        tableWidget->setItem(row, 5, new QTableWidgetItem(QString::number(entry.cost, 'f', 2))); // Cost (formatted to 2 decimal places)
-        tableWidget->setItem(row, 6, new QTableWidgetItem(QString::fromStdString(entry.currency)));
-        tableWidget->setItem(row, 7, new QTableWidgetItem(QString::fromStdString(entry.category))); // Category
-    }
-    saveTransactions();
-
+    transactionModel->reload();
 }
 
 double MainWindow::currencyConvert(QString from, QString to, double amount) {
@@ -790,7 +773,7 @@ double MainWindow::currencyConvert(QString from, QString to, double amount) {
     return amount * rate;
 }
 void MainWindow::setCurrentUserId(const QString& id) {
-    qDebug() << "Setting user ID in MainWindow:" << id;
+    NOOMYPLAN_LOG_DEBUG(lcApp) << "Setting user ID in MainWindow:" << id;
     currentUserId = id;
 
     // Set user ID and load data for each component
@@ -809,7 +792,7 @@ void MainWindow::setCurrentUserId(const QString& id) {
     // Add null check and defensive programming for BudgetPage
     if (budgetPage) {
         try {
-            qDebug() << "Setting user ID in BudgetPage:" << id;
+            NOOMYPLAN_LOG_DEBUG(lcApp) << "Setting user ID in BudgetPage:" << id;
             budgetPage->setCurrentUserId(id);
             
             // Ensure directory exists before loading
@@ -817,29 +800,29 @@ void MainWindow::setCurrentUserId(const QString& id) {
             QDir dir;
             if (!dir.exists(dataPath)) {
                 bool created = dir.mkpath(dataPath);
-                qDebug() << "Created data directory:" << created;
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "Created data directory:" << created;
             }
             
             // Load budget data with more detailed logging
-            qDebug() << "Attempting to load budget data for user:" << id;
+            NOOMYPLAN_LOG_DEBUG(lcApp) << "Attempting to load budget data for user:" << id;
             bool loadResult = budgetPage->loadBudgetData(id);
             
             if (loadResult) {
-                qDebug() << "Successfully loaded budget data for user:" << id;
+                NOOMYPLAN_LOG_INFO(lcApp) << "Successfully loaded budget data for user:" << id;
             } else {
-                qDebug() << "No existing budget data found for user:" << id;
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "No existing budget data found for user:" << id;
                 
                 // Attempt to create and save default budget
-                qDebug() << "Creating default budget data";
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "Creating default budget data";
                 
                 // Save initial budget data to ensure a file exists
                 bool saveResult = budgetPage->saveBudgetData(id);
-                qDebug() << "Initial budget data save result:" << saveResult;
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "Initial budget data save result:" << saveResult;
             }
         } catch (const std::exception& e) {
-            qDebug() << "Exception in budget loading:" << e.what();
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Exception in budget loading:" << e.what();
         } catch (...) {
-            qDebug() << "Unknown exception in budget loading";
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Unknown exception in budget loading";
         }
     }
 }
@@ -873,7 +856,7 @@ void MainWindow::searchTransaction() {
         int searchID = searchEdit.text().toInt();
 
         // Search for the transaction in the CashflowTracking object using the entered ID
-        DataEntry* transaction = cashflowTracking.searchDataEntries(searchID);
+        const DataEntry* transaction = cashflowTracking.searchDataEntries(searchID);
 
         // Check if the transaction was found
         if (!transaction) {
@@ -885,11 +868,11 @@ void MainWindow::searchTransaction() {
             QString details = QString("ID: %1\nDate: %2\nSeller: %3\nBuyer: %4\nMerchandise: %5\nCost: %6\nCategory: %7")
                 .arg(transaction->transid) // Transaction ID
                 .arg(QString::fromStdString(transaction->dateTime)) // Date and Time
-                .arg(QString::fromStdString(transaction->seller)) // Seller
-                .arg(QString::fromStdString(transaction->buyer)) // Buyer
+                .arg(QString::fromStdString(cashflowTracking.text(transaction->seller))) // Seller
+                .arg(QString::fromStdString(cashflowTracking.text(transaction->buyer))) // Buyer
                 .arg(QString::fromStdString(transaction->merchandise)) // Merchandise
-                .arg(transaction->cost, 0, 'f', 2) // Cost (formatted to 2 decimal places)
-                .arg(QString::fromStdString(transaction->category)); // Category
+                .arg(QString::fromStdString(transaction->cost.toString())) // Cost (formatted to 2 decimal places)
+                .arg(QString::fromStdString(cashflowTracking.text(transaction->category))); // Category
 
             // Show the transaction details in an information message box
             QMessageBox::information(&dialog, "Transaction Found", details);
@@ -975,32 +958,21 @@ void MainWindow::generateReport() {
         QTextStream out(&file);
         out << "ID,Date/Time,Seller,Buyer,Merchandise,Cost,Category\n"; // Write the CSV header
 
-        // Retrieve all transactions from the CashflowTracking object
-        std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-
-        // Iterate through each transaction
-        for (const auto& entry : transactions) {
-            // Extract the date from the transaction's dateTime string
-            QDate entryDate = QDate::fromString(QString::fromStdString(entry.dateTime).split(",")[0], "yyyy-MM-dd");
-            // Convert the transaction's category to lowercase for comparison
-            QString entryCategory = QString::fromStdString(entry.category).toLower();
-
-            // Check if the transaction falls within the specified date range
-            bool inDateRange = entryDate.isValid() && entryDate >= start && entryDate <= end;
-            // Check if the transaction matches the category filter (if provided)
-            bool categoryMatches = categoryFilter.isEmpty() || entryCategory == categoryFilter;
-
-            // If both conditions are met, write the transaction to the CSV file
-            if (inDateRange && categoryMatches) {
+        // Visit the transactions that fall within the date range and match the category filter (if provided), oldest first
+        cashflowTracking.range(
+            CashflowTracking::makeTimestamp(start.year(), start.month(), start.day()),
+            CashflowTracking::makeTimestamp(end.year(), end.month(), end.day(), 23, 59),
+            categoryFilter.toStdString(),
+            [&](const DataEntry& entry) {
+                // Write the transaction to the CSV file
                 out << entry.transid << ","
                     << QString::fromStdString(entry.dateTime) << ","
-                    << QString::fromStdString(entry.seller) << ","
-                    << QString::fromStdString(entry.buyer) << ","
+                    << QString::fromStdString(cashflowTracking.text(entry.seller)) << ","
+                    << QString::fromStdString(cashflowTracking.text(entry.buyer)) << ","
                     << QString::fromStdString(entry.merchandise) << ","
-                    << entry.cost << ","
-                    << QString::fromStdString(entry.category) << "\n";
-            }
-        }
+                    << QString::fromStdString(entry.cost.toString()) << ","
+                    << QString::fromStdString(cashflowTracking.text(entry.category)) << "\n";
+            });
 
         // Close the file after writing
         file.close();
@@ -1030,25 +1002,7 @@ void MainWindow::resizeEvent(QResizeEvent* event) {
 
 void MainWindow::saveTransactions() {
     if (currentUserId.isEmpty()) return;
-
-    // Create JSON data
-    QJsonArray transactionsArray;
-    std::vector<DataEntry> transactions = cashflowTracking.getAllDataEntries();
-    for (const auto& entry : transactions) {
-        QJsonObject obj;
-        obj["id"] = QString::number(entry.transid);
-        obj["datetime"] = QString::fromStdString(entry.dateTime);
-        obj["seller"] = QString::fromStdString(entry.seller);
-        obj["buyer"] = QString::fromStdString(entry.buyer);
-        obj["merchandise"] = QString::fromStdString(entry.merchandise);
-        obj["cost"] = QString::number(entry.cost, 'f', 2);
-        obj["currency"] = QString::fromStdString(entry.currency);
-        obj["category"] = QString::fromStdString(entry.category);
-        transactionsArray.append(obj);
-    }
-
-    QJsonObject root;
-    root["transactions"] = transactionsArray;
+    NOOMYPLAN_TRACE_SCOPE("transactions.export");
 
     // Use a consistent location across computers - AppDataLocation is platform-specific
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/BusinessManagementSystem/data";
@@ -1058,7 +1012,7 @@ void MainWindow::saveTransactions() {
     if (!dir.exists(dataPath)) {
         bool created = dir.mkpath(dataPath);
         if (!created) {
-            qDebug() << "Failed to create data directory at:" << dataPath;
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Failed to create data directory at:" << dataPath;
             return;
         }
     }
@@ -1068,65 +1022,87 @@ void MainWindow::saveTransactions() {
     QFile file(filePath);
 
     if (file.open(QIODevice::WriteOnly)) {
-        file.write(QJsonDocument(root).toJson());
+        // {"transactions":[...]}, streamed entry by entry instead of building the document
+        JsonStreamWriter writer(&file);
+        writer.beginObject();
+        writer.key("transactions");
+        writer.beginArray();
+        cashflowTracking.forEachDataEntry([&](const DataEntry& entry) {
+            QJsonObject obj;
+            obj["id"] = QString::number(entry.transid);
+            obj["datetime"] = QString::fromStdString(entry.dateTime);
+            obj["seller"] = QString::fromStdString(cashflowTracking.text(entry.seller));
+            obj["buyer"] = QString::fromStdString(cashflowTracking.text(entry.buyer));
+            obj["merchandise"] = QString::fromStdString(entry.merchandise);
+            obj["cost"] = QString::fromStdString(entry.cost.toString());
+            obj["currency"] = QString::fromStdString(cashflowTracking.text(entry.currency));
+            obj["category"] = QString::fromStdString(cashflowTracking.text(entry.category));
+            writer.value(obj);
+            });
+        writer.endArray();
+        writer.endObject();
+        if (!writer.flush()) {
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Failed to save transactions:" << file.errorString();
+            return;
+        }
         file.close();
-        qDebug() << "Successfully saved" << transactions.size() << "transactions to:" << filePath;
+        NOOMYPLAN_LOG_INFO(lcApp) << "Successfully saved" << cashflowTracking.dataEntryCount() << "transactions to:" << filePath;
     }
     else {
-        qDebug() << "Failed to save transactions. Cannot open file:" << filePath;
-        qDebug() << "Error:" << file.errorString();
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Failed to save transactions. Cannot open file:" << filePath;
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Error:" << file.errorString();
     }
 }
 
+/**
+ * @brief Opens the user's cashflow ledger and shows its transactions.
+ * @param userId The ID of the user whose transactions should be loaded.
+ *
+ * The ledger ("<user>_cashflow.dat" plus its journal) persists every change as it
+ * is made. Users who only have the older "<user>_transactions.json" export get it
+ * imported into the ledger once.
+ */
 void MainWindow::loadTransactions(const QString& userId) {
+    NOOMYPLAN_TRACE_SCOPE("transactions.load");
     // Use the same location as in saveTransactions
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/BusinessManagementSystem/data";
+    QDir dir;
+    if (!dir.exists(dataPath)) {
+        dir.mkpath(dataPath);
+    }
+
+    QString ledgerPath = dataPath + "/" + userId + "_cashflow.dat";
+    if (cashflowTracking.open(ledgerPath.toStdString())) {
+        NOOMYPLAN_LOG_INFO(lcApp) << "Loaded" << cashflowTracking.dataEntryCount() << "transactions from:" << ledgerPath;
+        updateTransactionTable();
+        return;
+    }
 
     QString filePath = dataPath + "/" + userId + "_transactions.json";
     QFile file(filePath);
 
-    qDebug() << "Attempting to load transactions from:" << filePath;
+    NOOMYPLAN_LOG_DEBUG(lcApp) << "Attempting to import transactions from:" << filePath;
 
     if (!file.exists()) {
-        qDebug() << "Transaction file does not exist for user:" << userId;
+        NOOMYPLAN_LOG_DEBUG(lcApp) << "Transaction file does not exist for user:" << userId;
+        updateTransactionTable();
         return;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "Failed to open transaction file:" << file.errorString();
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Failed to open transaction file:" << file.errorString();
+        updateTransactionTable();
         return;
     }
 
     // Clear existing data first to prevent duplication
-    tableWidget->setRowCount(0);
     cashflowTracking.clear();
 
-    QByteArray fileData = file.readAll();
-    file.close();
-
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(fileData, &parseError);
-
-    if (parseError.error != QJsonParseError::NoError) {
-        qDebug() << "JSON parse error:" << parseError.errorString();
-        return;
-    }
-
-    QJsonArray transactionsArray = doc["transactions"].toArray();
-    qDebug() << "Loaded" << transactionsArray.size() << "transactions";
-
-    for (const QJsonValue& val : transactionsArray) {
-        QJsonObject obj = val.toObject();
-        int row = tableWidget->rowCount();
-        tableWidget->insertRow(row);
-        tableWidget->setItem(row, 0, new QTableWidgetItem(obj["id"].toString()));
-        tableWidget->setItem(row, 1, new QTableWidgetItem(obj["datetime"].toString()));
-        tableWidget->setItem(row, 2, new QTableWidgetItem(obj["seller"].toString()));
-        tableWidget->setItem(row, 3, new QTableWidgetItem(obj["buyer"].toString()));
-        tableWidget->setItem(row, 4, new QTableWidgetItem(obj["merchandise"].toString()));
-        tableWidget->setItem(row, 5, new QTableWidgetItem(obj["cost"].toString()));
-        tableWidget->setItem(row, 6, new QTableWidgetItem(obj["currency"].toString()));
-        tableWidget->setItem(row, 7, new QTableWidgetItem(obj["category"].toString()));
+    // Each transaction goes into the ledger as soon as it is parsed
+    QString parseError;
+    const bool parsed = JsonStreamReader::readObjectArray(&file, "transactions", [this](const QJsonObject& obj) {
+        Money cost;
+        Money::parse(obj["cost"].toString().toStdString(), cost); // Stays zero if unreadable
 
         // Add to the CashflowTracking object
         cashflowTracking.addData(
@@ -1134,39 +1110,53 @@ void MainWindow::loadTransactions(const QString& userId) {
             obj["seller"].toString().toStdString(),
             obj["buyer"].toString().toStdString(),
             obj["merchandise"].toString().toStdString(),
-            obj["cost"].toString().toDouble(),
+            cost,
             obj["currency"].toString().toStdString(),
             obj["category"].toString().toStdString()
         );
+        }, nullptr, &parseError);
+    file.close();
+
+    if (!parsed) {
+        // Same as before: a file that is not valid JSON imports nothing
+        NOOMYPLAN_LOG_WARNING(lcApp) << "JSON parse error:" << parseError;
+        cashflowTracking.clear();
+        updateTransactionTable();
+        return;
     }
+    NOOMYPLAN_LOG_INFO(lcApp) << "Loaded" << cashflowTracking.dataEntryCount() << "transactions";
+
+    // Fold the import into a snapshot so it is not journaled row by row again
+    cashflowTracking.saveDataToFile();
+    updateTransactionTable();
 }
 
 
 
 void MainWindow::closeEvent(QCloseEvent* event) {
     try {
-        saveTransactions();         // Save transaction data
+        saveTransactions();         // Export transaction data as JSON; the ledger journal is already up to date
         
         try {
             inventoryPage->saveInventoryData();  // Save inventory data
         } catch (...) {
-            qDebug() << "Error saving inventory data";
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Error saving inventory data";
         }
         
         try {
             if (budgetPage && !currentUserId.isEmpty()) {
-                qDebug() << "Saving budget data on application close for user:" << currentUserId;
-                budgetPage->saveBudgetData(currentUserId);
-                qDebug() << "Budget data saved successfully on close";
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "Flushing budget autosave on application close for user:" << currentUserId;
+                budgetPage->flushAutosave(); // Synchronous, so nothing is lost when the app exits
+                NOOMYPLAN_LOG_DEBUG(lcApp) << "Budget data saved successfully on close";
             }
         } catch (const std::exception& e) {
-            qDebug() << "Exception saving budget data:" << e.what();
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Exception saving budget data:" << e.what();
         } catch (...) {
-            qDebug() << "Unknown exception saving budget data";
+            NOOMYPLAN_LOG_WARNING(lcApp) << "Unknown exception saving budget data";
         }
         
     } catch (...) {
-        qDebug() << "Error during closeEvent";
+        NOOMYPLAN_LOG_WARNING(lcApp) << "Error during closeEvent";
     }
     
     QMainWindow::closeEvent(event);
@@ -1192,6 +1182,7 @@ void MainWindow::closeEvent(QCloseEvent* event) {
  */
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
+    Logging::startAsyncSink(qEnvironmentVariable("NOOMYPLAN_LOG_FILE"));
 
     AuthenticateSystem authSystem;
     authSystem.loadUsersFromFile();
@@ -1205,5 +1196,7 @@ int main(int argc, char* argv[]) {
 
     loginPage.show();
 
-    return app.exec();
+    const int exitCode = app.exec();
+    Logging::stopAsyncSink();
+    return exitCode;
 }
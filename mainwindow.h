@@ -10,6 +10,7 @@
 #include "authenticatesystem.h"
 #include "financialreport.h"
 #include "cashflowtracking.h"
+#include "cashflowtablemodel.h"
 #include "dashboard.h"
 #include "loginpage.h"
 #include "inventory.h"
@@ -19,6 +20,7 @@ class QPushButton;
 class QResizeEvent;
 class QLineEdit;
 class QTableWidget;
+class QTableView;
 class AuthenticateSystem;
 class LoginPage;
 class FinancialReportGenerator;
@@ -27,6 +29,7 @@ class Dashboard;
 class BudgetPage;
 class InventoryPage;
 class InvoiceManager;  // Added missing forward declaration
+class MetricsPanel;
 
 /**
  * @brief Main application window for the Business Management System.
@@ -46,7 +49,8 @@ class MainWindow : public QMainWindow {
 private:
     FinancialReportGenerator reportGenerator; // Handles financial report generation
     CashflowTracking cashflowTracking;        // Manages cashflow transactions
-    QTableWidget* tableWidget;                // Displays cashflow transactions
+    QTableView* transactionTable;             // Displays cashflow transactions
+    CashflowTableModel* transactionModel;     // Reads the displayed rows straight from cashflowTracking
     QLineEdit* dateTimeEdit;                  // Input field for transaction date/time
     QLineEdit* sellerEdit;                    // Input field for seller
     QLineEdit* buyerEdit;                     // Input field for buyer
@@ -63,6 +67,7 @@ private:
     QLineEdit* currencyEdit;                  // Input field for currency
     BudgetPage* budgetPage;                   // Budget management page
     InventoryPage* inventoryPage;             // Inventory management page
+    MetricsPanel* metricsPanel = nullptr;     // Hidden performance panel, created on first Ctrl+Shift+M
 
     void saveTransactions();
     void loadTransactions(const QString& userId);
@@ -79,9 +84,9 @@ private slots:
     void searchTransaction();
     void generateReport();
     void handleLogout();
-    void handleTableEdit(int row, int column);
     double currencyConvert(QString from, QString to, double amount);
     void showTutorialDialog();
+    void showMetricsPanel();
 
 protected:
     void resizeEvent(QResizeEvent* event) override;
@@ -0,0 +1,137 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class mappedfile.cpp
+ * @brief Implements the MappedFile read-only file mapping for Windows and POSIX systems.
+ */
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * @brief Maps the file at the given path into memory.
+ * @param path Path of the file to map.
+ * @return True if the file was opened.
+ */
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+    if (mappedSize == 0) {
+        return true; // Nothing to map, but the file exists
+    }
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+
+    mappedData = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mappedData == nullptr) {
+        close();
+        return false;
+    }
+#else
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+        return false;
+    }
+
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+    opened = true;
+    if (mappedSize == 0) {
+        return true; // Nothing to map, but the file exists
+    }
+
+    void* view = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (view == MAP_FAILED) {
+        close();
+        return false;
+    }
+    mappedData = static_cast<const char*>(view);
+    madvise(view, mappedSize, MADV_SEQUENTIAL); // Loaders read front to back
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Unmaps the file and closes its handles.
+ */
+void MappedFile::close() {
+#ifdef _WIN32
+    if (mappedData != nullptr) {
+        UnmapViewOfFile(mappedData);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != nullptr) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (mappedData != nullptr) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+}
+
+bool MappedFile::isOpen() const {
+    return opened;
+}
+
+const char* MappedFile::data() const {
+    return mappedData;
+}
+
+size_t MappedFile::size() const {
+    return mappedSize;
+}
@@ -0,0 +1,66 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Wraps mmap on POSIX systems and CreateFileMapping/MapViewOfFile on Windows so
+ * binary data files can be read in place, without copying them into buffers first.
+ * The mapping is released when the object is closed or destroyed.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Unmaps the file if it is still open.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Maps the file at the given path into memory.
+     * @param path Path of the file to map.
+     * @return True if the file was opened. An empty file opens successfully with size() == 0.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmaps the file and closes its handles.
+     */
+    void close();
+
+    /**
+     * @brief Returns true while a file is mapped.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Returns the first byte of the mapping, or nullptr for an empty or closed file.
+     */
+    const char* data() const;
+
+    /**
+     * @brief Returns the size of the mapped file in bytes.
+     */
+    size_t size() const;
+
+private:
+    const char* mappedData = nullptr; // Start of the mapped view
+    size_t mappedSize = 0;            // Size of the mapped view in bytes
+    bool opened = false;              // Whether open() succeeded
+#ifdef _WIN32
+    void* fileHandle = nullptr;       // HANDLE of the open file
+    void* mappingHandle = nullptr;    // HANDLE of the file mapping object
+#else
+    int fileDescriptor = -1;          // Descriptor of the open file
+#endif
+};
+
+#endif // MAPPEDFILE_H
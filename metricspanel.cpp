@@ -0,0 +1,140 @@
+#include "metricspanel.h"
+#include "tracing.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+
+/**
+ * @class metricspanel.cpp
+ * @brief Implements the MetricsPanel that shows the Tracing statistics.
+ */
+
+namespace {
+
+constexpr int kRefreshIntervalMs = 1000;
+
+/**
+ * @brief Returns a table cell showing nanoseconds as milliseconds, right-aligned.
+ */
+QTableWidgetItem* millisecondsItem(int64_t nanoseconds) {
+    auto* item = new QTableWidgetItem(QString::number(static_cast<double>(nanoseconds) / 1e6, 'f', 3));
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QTableWidgetItem* numberItem(qint64 value) {
+    auto* item = new QTableWidgetItem(QString::number(value));
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+} // namespace
+
+MetricsPanel::MetricsPanel(QWidget* parent)
+    : QDialog(parent) {
+    setWindowTitle("Performance Metrics");
+    resize(720, 520);
+
+    operationsTable = new QTableWidget(0, 6, this);
+    operationsTable->setHorizontalHeaderLabels(
+        { "Operation", "Count", "p50 (ms)", "p99 (ms)", "Max (ms)", "Total (ms)" });
+    operationsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    operationsTable->verticalHeader()->setVisible(false);
+    operationsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    countersTable = new QTableWidget(0, 2, this);
+    countersTable->setHorizontalHeaderLabels({ "Counter", "Value" });
+    countersTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    countersTable->verticalHeader()->setVisible(false);
+    countersTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    statusLabel = new QLabel(this);
+    statusLabel->setWordWrap(true);
+    statusLabel->setText(Tracing::enabled()
+        ? QString("Latencies cover the last %1 spans of each thread.").arg(Tracing::kEventsPerThread)
+        : QString("Tracing was disabled at build time (NOOMYPLAN_TRACING=0); no data is recorded."));
+
+    QPushButton* refreshButton = new QPushButton("Refresh", this);
+    QPushButton* resetButton = new QPushButton("Reset", this);
+    QPushButton* exportButton = new QPushButton("Export Chrome Trace...", this);
+    connect(refreshButton, &QPushButton::clicked, this, &MetricsPanel::refresh);
+    connect(resetButton, &QPushButton::clicked, this, &MetricsPanel::resetStatistics);
+    connect(exportButton, &QPushButton::clicked, this, &MetricsPanel::exportTrace);
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(refreshButton);
+    buttonLayout->addWidget(resetButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(exportButton);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(statusLabel);
+    layout->addWidget(operationsTable, 3);
+    layout->addWidget(countersTable, 1);
+    layout->addLayout(buttonLayout);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(refreshTimer, &QTimer::timeout, this, &MetricsPanel::refresh);
+}
+
+void MetricsPanel::refresh() {
+    const std::vector<Tracing::OperationStats> operations = Tracing::statistics();
+    operationsTable->setRowCount(static_cast<int>(operations.size()));
+    for (int row = 0; row < static_cast<int>(operations.size()); ++row) {
+        const Tracing::OperationStats& stats = operations[row];
+        operationsTable->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(stats.name)));
+        operationsTable->setItem(row, 1, numberItem(static_cast<qint64>(stats.count)));
+        operationsTable->setItem(row, 2, millisecondsItem(stats.p50Ns));
+        operationsTable->setItem(row, 3, millisecondsItem(stats.p99Ns));
+        operationsTable->setItem(row, 4, millisecondsItem(stats.maxNs));
+        operationsTable->setItem(row, 5, millisecondsItem(stats.totalNs));
+    }
+
+    const std::vector<Tracing::Counter> counters = Tracing::counters();
+    countersTable->setRowCount(static_cast<int>(counters.size()));
+    for (int row = 0; row < static_cast<int>(counters.size()); ++row) {
+        countersTable->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(counters[row].name)));
+        countersTable->setItem(row, 1, numberItem(counters[row].value));
+    }
+}
+
+void MetricsPanel::resetStatistics() {
+    Tracing::reset();
+    refresh();
+}
+
+void MetricsPanel::exportTrace() {
+    const QString defaultName = "noomyplan_trace_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".json";
+    const QString fileName = QFileDialog::getSaveFileName(this, "Export Chrome Trace", defaultName,
+        "Chrome trace (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    if (Tracing::writeChromeTrace(QFile::encodeName(fileName).toStdString())) {
+        QMessageBox::information(this, "Success", "Trace written to " + fileName +
+            "\nOpen it in chrome://tracing or ui.perfetto.dev.");
+    }
+    else {
+        QMessageBox::warning(this, "Error", "Failed to write " + fileName);
+    }
+}
+
+void MetricsPanel::showEvent(QShowEvent* event) {
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void MetricsPanel::hideEvent(QHideEvent* event) {
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
@@ -0,0 +1,58 @@
+#ifndef METRICSPANEL_H
+#define METRICSPANEL_H
+
+#include <QDialog>
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+class QTimer;
+QT_END_NAMESPACE
+
+/**
+ * @class MetricsPanel
+ * @brief Developer window listing p50/p99 latencies per traced operation and the counters.
+ *
+ * Reads the Tracing buffers once a second while visible. Not reachable from any menu;
+ * MainWindow opens it with Ctrl+Shift+M. The trace can be exported as a Chrome trace
+ * file for chrome://tracing or Perfetto.
+ */
+class MetricsPanel : public QDialog {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Creates the panel; it refreshes itself while shown.
+     * @param parent The parent widget (default is nullptr).
+     */
+    explicit MetricsPanel(QWidget* parent = nullptr);
+
+public slots:
+    /**
+     * @brief Re-reads the statistics and counters into the tables.
+     */
+    void refresh();
+
+private slots:
+    /**
+     * @brief Forgets the recorded spans and counters.
+     */
+    void resetStatistics();
+
+    /**
+     * @brief Asks for a file name and writes the recorded spans as a Chrome trace.
+     */
+    void exportTrace();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private:
+    QTableWidget* operationsTable; // One row per operation: count, p50, p99, max, total
+    QTableWidget* countersTable;   // One row per counter
+    QLabel* statusLabel;           // Notes when tracing is compiled out
+    QTimer* refreshTimer;          // Refreshes while the panel is visible
+};
+
+#endif // METRICSPANEL_H
@@ -0,0 +1,250 @@
+#include "money.h"
+#include <cmath>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+/**
+ * @class money.cpp
+ * @brief Implements the Money fixed-point amount: checked arithmetic, parsing and formatting.
+ */
+
+namespace {
+
+constexpr int64_t kMaxCents = std::numeric_limits<int64_t>::max();
+constexpr int64_t kMinCents = std::numeric_limits<int64_t>::min();
+
+[[noreturn]] void throwOverflow(const char* operation) {
+    throw std::overflow_error(std::string("Money overflow in ") + operation);
+}
+
+int64_t checkedAdd(int64_t left, int64_t right) {
+    if ((right > 0 && left > kMaxCents - right) || (right < 0 && left < kMinCents - right)) {
+        throwOverflow("addition");
+    }
+    return left + right;
+}
+
+int64_t checkedMultiply(int64_t left, int64_t right) {
+    if (left == 0 || right == 0) {
+        return 0;
+    }
+    if ((left == -1 && right == kMinCents) || (right == -1 && left == kMinCents)) {
+        throwOverflow("multiplication");
+    }
+    // Multiply in unsigned arithmetic, which wraps instead of being undefined, then check by dividing back
+    const int64_t product = static_cast<int64_t>(static_cast<uint64_t>(left) * static_cast<uint64_t>(right));
+    if (product / right != left) {
+        throwOverflow("multiplication");
+    }
+    return product;
+}
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // namespace
+
+/**
+ * @brief Rounds a floating-point amount to the nearest cent, halves away from zero.
+ * @param amount Amount in whole units, e.g. 12.34.
+ * @return The amount in cents.
+ */
+Money Money::fromDouble(double amount) {
+    Money result;
+    if (!tryFromDouble(amount, result)) {
+        throwOverflow("conversion from double");
+    }
+    return result;
+}
+
+bool Money::tryFromDouble(double amount, Money& result) {
+    const double cents = std::round(amount * static_cast<double>(kScale));
+    // 2^63 is exactly representable; anything at or beyond it does not fit
+    if (!std::isfinite(cents) || cents >= 9223372036854775808.0 || cents < -9223372036854775808.0) {
+        return false;
+    }
+    result = fromCents(static_cast<int64_t>(cents));
+    return true;
+}
+
+/**
+ * @brief Parses a decimal amount.
+ * @param text Text to parse.
+ * @param result Receives the amount on success.
+ * @return False if the text is malformed or out of range.
+ */
+bool Money::parse(std::string_view text, Money& result) {
+    size_t pos = 0;
+    size_t end = text.size();
+    while (pos < end && isBlank(text[pos])) ++pos;
+    while (end > pos && isBlank(text[end - 1])) --end;
+
+    bool negative = false;
+    if (pos < end && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos++] == '-';
+    }
+    if (pos < end && text[pos] == '$') {
+        ++pos;
+        if (!negative && pos < end && (text[pos] == '-' || text[pos] == '+')) {
+            negative = text[pos++] == '-'; // "$-12.50"
+        }
+    }
+
+    // Accumulate as a negative number so the most negative amount parses too
+    int64_t cents = 0;
+    bool sawDigit = false;
+    int groupDigits = 0;  // Digits since the last grouping comma, or since the start
+    bool grouped = false; // A grouping comma was seen
+    for (; pos < end && text[pos] != '.'; ++pos) {
+        const char c = text[pos];
+        if (c == ',') {
+            // "1,234,567": one to three digits first, then groups of exactly three
+            if (grouped ? groupDigits != 3 : groupDigits < 1 || groupDigits > 3) {
+                return false;
+            }
+            grouped = true;
+            groupDigits = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        const int digit = c - '0';
+        if (cents < (kMinCents + digit) / 10) {
+            return false;
+        }
+        cents = cents * 10 - digit;
+        sawDigit = true;
+        ++groupDigits;
+    }
+    if (grouped && groupDigits != 3) {
+        return false;
+    }
+
+    int64_t fraction = 0;
+    int fractionDigits = 0;
+    bool roundAway = false;
+    if (pos < end) {
+        ++pos; // '.'
+        for (; pos < end; ++pos) {
+            const char c = text[pos];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            sawDigit = true;
+            if (fractionDigits < kFractionDigits) {
+                fraction = fraction * 10 + (c - '0');
+                ++fractionDigits;
+            }
+            else if (fractionDigits == kFractionDigits) {
+                roundAway = c >= '5'; // Only the first dropped digit decides
+                ++fractionDigits;
+            }
+        }
+    }
+    if (!sawDigit) {
+        return false;
+    }
+    for (int i = fractionDigits; i < kFractionDigits; ++i) {
+        fraction *= 10;
+    }
+    if (roundAway) {
+        ++fraction;
+    }
+
+    if (cents < kMinCents / kScale) {
+        return false;
+    }
+    cents *= kScale;
+    if (cents < kMinCents + fraction) {
+        return false;
+    }
+    cents -= fraction;
+    if (!negative) {
+        if (cents == kMinCents) {
+            return false;
+        }
+        cents = -cents;
+    }
+    result = fromCents(cents);
+    return true;
+}
+
+double Money::toDouble() const {
+    return static_cast<double>(value) / static_cast<double>(kScale);
+}
+
+/**
+ * @brief Writes the amount as "-1234.56".
+ * @param buffer At least kMaxFormattedSize bytes.
+ * @return Number of bytes written.
+ *
+ * Digits are produced from the right with integer division, without printf or
+ * locale lookups.
+ */
+size_t Money::format(char* buffer) const {
+    // Work on the magnitude as unsigned so the most negative amount formats too
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+    char digits[kMaxFormattedSize];
+    size_t count = 0;
+    for (int i = 0; i < kFractionDigits; ++i) {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    digits[count++] = '.';
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    size_t length = 0;
+    if (value < 0) {
+        buffer[length++] = '-';
+    }
+    while (count > 0) {
+        buffer[length++] = digits[--count];
+    }
+    return length;
+}
+
+std::string Money::toString() const {
+    char buffer[kMaxFormattedSize];
+    return std::string(buffer, format(buffer));
+}
+
+Money& Money::operator+=(Money other) {
+    value = checkedAdd(value, other.value);
+    return *this;
+}
+
+Money& Money::operator-=(Money other) {
+    if (other.value == kMinCents) {
+        if (value >= 0) {
+            throwOverflow("subtraction");
+        }
+        value = (value + kMaxCents) + 1; // value - kMinCents without overflowing the intermediate
+        return *this;
+    }
+    value = checkedAdd(value, -other.value);
+    return *this;
+}
+
+Money& Money::operator*=(int64_t factor) {
+    value = checkedMultiply(value, factor);
+    return *this;
+}
+
+Money Money::operator-() const {
+    if (value == kMinCents) {
+        throwOverflow("negation");
+    }
+    return fromCents(-value);
+}
+
+std::ostream& operator<<(std::ostream& stream, Money money) {
+    char buffer[Money::kMaxFormattedSize];
+    return stream.write(buffer, static_cast<std::streamsize>(money.format(buffer)));
+}
@@ -0,0 +1,136 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+/**
+ * @class Money
+ * @brief An exact amount of money, stored as a 64-bit count of cents.
+ *
+ * Amounts held as double pick up binary rounding error (0.1 + 0.2 != 0.3), and that
+ * error grows with every addition over a large ledger or a long run of budget
+ * changes. Money keeps whole cents in an int64_t, so sums are exact and aggregate
+ * as plain integer adds. Arithmetic is checked: a result that does not fit throws
+ * std::overflow_error instead of wrapping. Parsing and formatting work directly on
+ * decimal text ("1,234.56", "$-12.5") without going through floating point.
+ */
+class Money {
+public:
+    static constexpr int kFractionDigits = 2;   // Digits after the decimal point
+    static constexpr int64_t kScale = 100;      // Smallest units per whole unit
+    static constexpr size_t kMaxFormattedSize = 24; // Longest text format() writes
+
+    /**
+     * @brief Creates zero.
+     */
+    constexpr Money() = default;
+
+    /**
+     * @brief Creates an amount from a count of cents.
+     */
+    static constexpr Money fromCents(int64_t cents) {
+        Money money;
+        money.value = cents;
+        return money;
+    }
+
+    /**
+     * @brief Rounds a floating-point amount to the nearest cent, halves away from zero.
+     * @throws std::overflow_error if the amount is not finite or does not fit.
+     *
+     * Meant for values that are already doubles, such as JSON numbers and files written
+     * before amounts were exact; text should go through parse() instead.
+     */
+    static Money fromDouble(double amount);
+
+    /**
+     * @brief Rounds a floating-point amount to the nearest cent like fromDouble(), without throwing.
+     * @param amount Amount in whole units.
+     * @param result Receives the amount; unchanged on failure.
+     * @return False if the amount is not finite or does not fit.
+     */
+    static bool tryFromDouble(double amount, Money& result);
+
+    /**
+     * @brief Parses a decimal amount.
+     * @param text Text such as "12", "-3.5", "$1,234.56" or " 7.125 ". Digits after the
+     *             second decimal are rounded half away from zero. A leading "$" and
+     *             thousands separators ("1,234,567") are accepted, but only in groups of
+     *             three; surrounding blanks are allowed.
+     * @param result Receives the amount; unchanged on failure.
+     * @return False if the text is not a plain decimal amount or does not fit.
+     */
+    static bool parse(std::string_view text, Money& result);
+
+    /**
+     * @brief Returns the amount as a count of cents.
+     */
+    constexpr int64_t cents() const { return value; }
+
+    /**
+     * @brief Returns the amount as a double, e.g. for charts and spin boxes.
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Writes the amount as "-1234.56", without grouping or currency sign.
+     * @param buffer At least kMaxFormattedSize bytes; no terminator is written.
+     * @return Number of bytes written.
+     */
+    size_t format(char* buffer) const;
+
+    /**
+     * @brief Returns the amount as "-1234.56", without grouping or currency sign.
+     */
+    std::string toString() const;
+
+    constexpr bool isZero() const { return value == 0; }
+    constexpr bool isNegative() const { return value < 0; }
+
+    /**
+     * @throws std::overflow_error if the result does not fit.
+     */
+    Money& operator+=(Money other);
+
+    /**
+     * @throws std::overflow_error if the result does not fit.
+     */
+    Money& operator-=(Money other);
+
+    /**
+     * @brief Multiplies by a whole number, e.g. a quantity.
+     * @throws std::overflow_error if the result does not fit.
+     */
+    Money& operator*=(int64_t factor);
+
+    /**
+     * @throws std::overflow_error for the most negative amount.
+     */
+    Money operator-() const;
+
+    friend Money operator+(Money left, Money right) { return left += right; }
+    friend Money operator-(Money left, Money right) { return left -= right; }
+    friend Money operator*(Money left, int64_t factor) { return left *= factor; }
+    friend Money operator*(int64_t factor, Money right) { return right *= factor; }
+
+    friend constexpr bool operator==(Money left, Money right) { return left.value == right.value; }
+    friend constexpr bool operator!=(Money left, Money right) { return left.value != right.value; }
+    friend constexpr bool operator<(Money left, Money right) { return left.value < right.value; }
+    friend constexpr bool operator<=(Money left, Money right) { return left.value <= right.value; }
+    friend constexpr bool operator>(Money left, Money right) { return left.value > right.value; }
+    friend constexpr bool operator>=(Money left, Money right) { return left.value >= right.value; }
+
+private:
+    int64_t value = 0; // Amount in cents
+};
+
+/**
+ * @brief Writes the amount as format() does.
+ */
+std::ostream& operator<<(std::ostream& stream, Money money);
+
+#endif // MONEY_H
@@ -0,0 +1,128 @@
+#include "receivablesaging.h"
+
+/**
+ * @class receivablesaging.cpp
+ * @brief Implements the ReceivablesAging buckets, their cache and the due-date priority index.
+ */
+
+bool ReceivablesAging::isOutstanding(const Invoice& invoice) {
+    const QString status = invoice.getStatus();
+    return status != "Completed" && status != "Paid";
+}
+
+int ReceivablesAging::bucketFor(qint64 daysPastDue) {
+    if (daysPastDue <= 30) return 0;
+    if (daysPastDue <= 60) return 1;
+    if (daysPastDue <= 90) return 2;
+    return 3;
+}
+
+QString ReceivablesAging::bucketLabel(int bucket) {
+    static const char* const labels[AgingSummary::kBucketCount] = { "0-30 days", "31-60 days", "61-90 days", "90+ days" };
+    return bucket >= 0 && bucket < AgingSummary::kBucketCount ? QString(labels[bucket]) : QString();
+}
+
+void ReceivablesAging::apply(const Invoice& invoice, int sign) {
+    const Money amount = invoice.getAmount() * sign;
+    const QDate dueDate = invoice.getDueDate();
+    const qint64 dueDay = dueDate.isValid() ? dueDate.toJulianDay() : 0;
+    const qint64 daysPastDue = dueDate.isValid() && cacheValid ? cached.asOf.toJulianDay() - dueDay : 0;
+    const int bucket = bucketFor(daysPastDue);
+
+    // Every sum is taken before anything changes, so an overflow leaves the totals as they were
+    const auto day = dueDate.isValid() ? outstandingByDay.find(dueDay) : outstandingByDay.end();
+    Money dayAmount = dueDate.isValid() ? Money() : undated.amount;
+    if (day != outstandingByDay.end()) {
+        dayAmount = day->second.amount;
+    }
+    dayAmount += amount;
+    Money bucketAmount;
+    Money totalOutstanding;
+    Money overdueAmount = cached.overdueAmount;
+    if (cacheValid) {
+        bucketAmount = cached.bucketAmounts[bucket] + amount;
+        totalOutstanding = cached.totalOutstanding + amount;
+        if (daysPastDue > 0) {
+            overdueAmount += amount;
+        }
+    }
+
+    if (dueDate.isValid()) {
+        DayTotal& total = day != outstandingByDay.end() ? day->second : outstandingByDay[dueDay];
+        total.amount = dayAmount;
+        total.count += sign;
+        if (total.count == 0) {
+            outstandingByDay.erase(dueDay);
+        }
+        if (sign > 0) {
+            outstandingDue.insert({ dueDay, invoice.getInvoiceID() });
+        }
+        else {
+            outstandingDue.erase({ dueDay, invoice.getInvoiceID() });
+        }
+    }
+    else {
+        undated.amount = dayAmount;
+        undated.count += sign;
+    }
+
+    if (cacheValid) {
+        cached.bucketAmounts[bucket] = bucketAmount;
+        cached.bucketCounts[bucket] += sign;
+        cached.totalOutstanding = totalOutstanding;
+        cached.outstandingCount += sign;
+        if (daysPastDue > 0) {
+            cached.overdueAmount = overdueAmount;
+            cached.overdueCount += sign;
+        }
+    }
+}
+
+void ReceivablesAging::add(const Invoice& invoice) {
+    if (isOutstanding(invoice)) {
+        apply(invoice, 1);
+    }
+}
+
+void ReceivablesAging::remove(const Invoice& invoice) {
+    if (isOutstanding(invoice)) {
+        apply(invoice, -1);
+    }
+}
+
+void ReceivablesAging::clear() {
+    outstandingByDay.clear();
+    undated = DayTotal();
+    outstandingDue.clear();
+    cacheValid = false;
+}
+
+AgingSummary ReceivablesAging::summary(const QDate& asOf) const {
+    if (cacheValid && cached.asOf == asOf) {
+        return cached;
+    }
+
+    AgingSummary result;
+    result.asOf = asOf;
+    result.bucketAmounts[0] = undated.amount;
+    result.bucketCounts[0] = undated.count;
+    const qint64 today = asOf.toJulianDay();
+    for (const auto& day : outstandingByDay) {
+        const qint64 daysPastDue = today - day.first;
+        const int bucket = bucketFor(daysPastDue);
+        result.bucketAmounts[bucket] += day.second.amount;
+        result.bucketCounts[bucket] += day.second.count;
+        if (daysPastDue > 0) {
+            result.overdueAmount += day.second.amount;
+            result.overdueCount += day.second.count;
+        }
+    }
+    for (int bucket = 0; bucket < AgingSummary::kBucketCount; ++bucket) {
+        result.totalOutstanding += result.bucketAmounts[bucket];
+        result.outstandingCount += result.bucketCounts[bucket];
+    }
+
+    cached = result;
+    cacheValid = asOf.isValid();
+    return result;
+}
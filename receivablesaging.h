@@ -0,0 +1,131 @@
+#ifndef RECEIVABLESAGING_H
+#define RECEIVABLESAGING_H
+
+#include <QDate>
+#include <QString>
+#include <climits>
+#include <map>
+#include <set>
+#include <utility>
+#include "invoice.h"
+#include "money.h"
+
+/**
+ * @struct AgingSummary
+ * @brief Outstanding invoices as of a date, split into the usual aging buckets.
+ */
+struct AgingSummary {
+    static constexpr int kBucketCount = 4; // 0-30, 31-60, 61-90 and 90+ days past due
+
+    QDate asOf;                            // Date the days past due are counted to
+    Money bucketAmounts[kBucketCount];     // Amount outstanding per bucket
+    int bucketCounts[kBucketCount] = {};   // Invoices per bucket
+    Money totalOutstanding;                // Sum of every bucket
+    int outstandingCount = 0;              // Invoices in every bucket
+    Money overdueAmount;                   // Part of the total that is past its due date
+    int overdueCount = 0;                  // Invoices past their due date
+};
+
+/**
+ * @class ReceivablesAging
+ * @brief Keeps the outstanding invoices summarized by due date, updated one invoice at a time.
+ *
+ * InvoiceStore reports every invoice it stores or drops. An invoice is outstanding
+ * until its status is "Completed" or "Paid". Outstanding amounts are kept per due
+ * day, so summary() only walks the distinct due days once per date; after that,
+ * add() and remove() adjust the cached buckets directly, which keeps a dashboard
+ * tile current at O(1) per change. Invoices without a valid due date count as
+ * current (0-30 days).
+ *
+ * A priority index of outstanding invoices by due date answers "what is overdue"
+ * and "what is due soon" in O(log n + k).
+ */
+class ReceivablesAging {
+public:
+    /**
+     * @brief Returns true if the invoice still has to be paid.
+     */
+    static bool isOutstanding(const Invoice& invoice);
+
+    /**
+     * @brief Returns the bucket for a number of days past due; not yet due counts as 0.
+     */
+    static int bucketFor(qint64 daysPastDue);
+
+    /**
+     * @brief Returns the label of a bucket, e.g. "31-60 days".
+     */
+    static QString bucketLabel(int bucket);
+
+    /**
+     * @brief Counts an invoice that was stored; ignores it if it is not outstanding.
+     * @throws std::overflow_error if a total would not fit; nothing is counted then.
+     */
+    void add(const Invoice& invoice);
+
+    /**
+     * @brief Uncounts an invoice that is being dropped or replaced; pass it as it was added.
+     */
+    void remove(const Invoice& invoice);
+
+    /**
+     * @brief Forgets every invoice.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the buckets as of a date.
+     *
+     * Recomputed from the per-day totals when the date differs from the last call;
+     * otherwise returned from the incrementally maintained cache.
+     */
+    AgingSummary summary(const QDate& asOf) const;
+
+    /**
+     * @brief Visits the IDs of outstanding invoices due before asOf, most overdue first.
+     */
+    template <typename Visitor>
+    void forEachOverdue(const QDate& asOf, Visitor&& visit) const {
+        const auto end = outstandingDue.lower_bound({ asOf.toJulianDay(), INT_MIN });
+        for (auto it = outstandingDue.begin(); it != end; ++it) {
+            visit(it->second);
+        }
+    }
+
+    /**
+     * @brief Visits the IDs of outstanding invoices due within [asOf, asOf + days], soonest first.
+     */
+    template <typename Visitor>
+    void forEachDueWithin(const QDate& asOf, int days, Visitor&& visit) const {
+        auto it = outstandingDue.lower_bound({ asOf.toJulianDay(), INT_MIN });
+        const auto end = outstandingDue.upper_bound({ asOf.toJulianDay() + days, INT_MAX });
+        for (; it != end; ++it) {
+            visit(it->second);
+        }
+    }
+
+private:
+    /**
+     * @brief Outstanding amount and invoice count of one due day.
+     */
+    struct DayTotal {
+        Money amount;
+        int count = 0;
+    };
+
+    using DuePosting = std::pair<qint64, int>; // Julian day of the due date, invoice ID
+
+    std::map<qint64, DayTotal> outstandingByDay; // Outstanding invoices with a valid due date, per due day
+    DayTotal undated;                            // Outstanding invoices without a valid due date
+    std::set<DuePosting> outstandingDue;         // Priority index of outstanding invoices by due date
+    mutable AgingSummary cached;                 // Last summary(); kept current by add() and remove()
+    mutable bool cacheValid = false;
+
+    /**
+     * @brief Adds an outstanding amount to the totals and the cached buckets; sign is 1 or -1.
+     * @throws std::overflow_error if a total would not fit; nothing is changed then.
+     */
+    void apply(const Invoice& invoice, int sign);
+};
+
+#endif // RECEIVABLESAGING_H
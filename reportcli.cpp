@@ -0,0 +1,356 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <iterator>
+#include "financialreport.h"
+#include "tracing.h"
+
+/**
+ * @class reportcli.cpp
+ * @brief Implements NoomyPlanReports, a command-line front end that runs FinancialReportGenerator over many CSV files.
+ *
+ * Usage: NoomyPlanReports [options] <file-or-directory>...
+ *
+ * Every CSV file given, or found in a given directory, is loaded and the selected
+ * reports are written as "<file name>_<report>.csv", next to the input or into
+ * --output-dir. Inputs that would share a name in --output-dir get their parent
+ * directory's name in front, e.g. "a_q1_<report>.csv" and "b_q1_<report>.csv".
+ * Files are processed several at a time on their own thread pool, and each file's
+ * parse is itself split across the global pool. Needs only QtCore, so it runs on
+ * servers without a display. Exits with 0 if every report was written, 1 if any
+ * file or report failed and 2 on a usage error.
+ */
+
+namespace {
+
+/**
+ * @brief One report the tool can write.
+ */
+struct ReportType {
+    const char* name;       // Name on the command line
+    const char* fileSuffix; // Appended to the input's base name
+    bool (FinancialReportGenerator::* generate)(const QString&);
+};
+
+const ReportType kReportTypes[] = {
+    { "profit-loss", "profit_loss_statement.csv", &FinancialReportGenerator::generateProfitLossStatement },
+    { "expenses", "expense_breakdown_report.csv", &FinancialReportGenerator::generateExpenseBreakdownReport },
+    { "balance-sheet", "balance_sheet_report.csv", &FinancialReportGenerator::generateBalanceSheetReport },
+};
+constexpr int kReportTypeCount = int(sizeof(kReportTypes) / sizeof(kReportTypes[0]));
+
+/**
+ * @brief Settings shared by every file of a batch.
+ */
+struct BatchOptions {
+    QList<int> reports;                  // Indexes into kReportTypes
+    QString outputDir;                   // Empty to write next to each input
+    QHash<QString, QString> reportNames; // Base name of each input's reports in outputDir
+    bool useCache = false;               // Read and write sidecar caches
+    TransactionClassifier classifier;    // Income/expense rules
+};
+
+/**
+ * @brief Outcome of one input file.
+ */
+struct FileResult {
+    QString input;
+    bool loaded = false;
+    qsizetype transactions = 0;
+    int reportsWritten = 0;
+    int reportsFailed = 0;
+    qint64 elapsedMs = 0;
+    QString error;
+};
+
+bool verboseOutput = false;
+
+/**
+ * @brief Drops the generator's debug chatter unless --verbose is given; warnings always go to stderr.
+ */
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message) {
+    if (type == QtDebugMsg && !verboseOutput) {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+/**
+ * @brief Returns the report indexes named in a comma-separated list.
+ * @param list e.g. "profit-loss,expenses" or "all".
+ * @param reports Receives the indexes, each once, in table order.
+ * @return False if a name is unknown.
+ */
+bool parseReportList(const QString& list, QList<int>& reports) {
+    bool selected[kReportTypeCount] = {};
+    for (const QString& part : list.split(',', Qt::SkipEmptyParts)) {
+        const QString name = part.trimmed().toLower();
+        if (name == QLatin1String("all")) {
+            std::fill(std::begin(selected), std::end(selected), true);
+            continue;
+        }
+        int index = 0;
+        while (index < kReportTypeCount && name != QLatin1String(kReportTypes[index].name)) {
+            ++index;
+        }
+        if (index == kReportTypeCount) {
+            return false;
+        }
+        selected[index] = true;
+    }
+
+    reports.clear();
+    for (int index = 0; index < kReportTypeCount; ++index) {
+        if (selected[index]) {
+            reports.append(index);
+        }
+    }
+    return !reports.isEmpty();
+}
+
+/**
+ * @brief Expands the command-line paths into the list of CSV files to process.
+ * @param paths Files and directories from the command line.
+ * @param recursive Also search subdirectories.
+ * @param missing Receives the paths that do not exist.
+ * @return Absolute paths of the files, sorted and without duplicates.
+ */
+QStringList collectInputs(const QStringList& paths, bool recursive, QStringList& missing) {
+    QStringList files;
+    for (const QString& path : paths) {
+        const QFileInfo info(path);
+        if (info.isFile()) {
+            files.append(info.absoluteFilePath());
+        }
+        else if (info.isDir()) {
+            QDirIterator it(info.absoluteFilePath(), QStringList() << "*.csv", QDir::Files,
+                recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+            while (it.hasNext()) {
+                const QString file = it.next();
+                // Skip reports written by an earlier run into the same directory
+                const bool isReport = std::any_of(std::begin(kReportTypes), std::end(kReportTypes),
+                    [&file](const ReportType& report) { return file.endsWith(QLatin1String(report.fileSuffix)); });
+                if (!isReport) {
+                    files.append(file);
+                }
+            }
+        }
+        else {
+            missing.append(path);
+        }
+    }
+    files.sort();
+    files.removeDuplicates();
+    return files;
+}
+
+/**
+ * @brief Picks a distinct base name for each input's reports when they all go into one directory.
+ *
+ * Inputs with a base name of their own keep it. Those that share one, such as "a/q1.csv"
+ * and "b/q1.csv", get their parent directory's name in front ("a_q1", "b_q1"), and a
+ * number after it if that still collides. Names are compared case-insensitively, as
+ * some file systems do.
+ */
+QHash<QString, QString> uniqueReportNames(const QStringList& inputs) {
+    QHash<QString, int> baseNameCounts;
+    for (const QString& input : inputs) {
+        ++baseNameCounts[QFileInfo(input).completeBaseName().toLower()];
+    }
+
+    QHash<QString, QString> names;
+    QSet<QString> taken;
+    for (const QString& input : inputs) {
+        const QString baseName = QFileInfo(input).completeBaseName();
+        if (baseNameCounts.value(baseName.toLower()) == 1) {
+            names.insert(input, baseName);
+            taken.insert(baseName.toLower());
+        }
+    }
+    for (const QString& input : inputs) {
+        if (names.contains(input)) {
+            continue;
+        }
+        const QFileInfo info(input);
+        const QString prefixed = info.dir().dirName() + "_" + info.completeBaseName();
+        QString name = prefixed;
+        for (int suffix = 2; taken.contains(name.toLower()); ++suffix) {
+            name = prefixed + "_" + QString::number(suffix);
+        }
+        names.insert(input, name);
+        taken.insert(name.toLower());
+    }
+    return names;
+}
+
+/**
+ * @brief Returns where a report for an input file goes.
+ */
+QString reportPath(const QString& input, const BatchOptions& options, const ReportType& report) {
+    const QFileInfo info(input);
+    if (options.outputDir.isEmpty()) {
+        return QDir(info.absolutePath()).filePath(info.completeBaseName() + "_" + report.fileSuffix);
+    }
+    return QDir(options.outputDir).filePath(options.reportNames.value(input, info.completeBaseName()) + "_" + report.fileSuffix);
+}
+
+/**
+ * @brief Loads one file and writes its reports; runs on a batch pool thread.
+ *
+ * Each call uses its own FinancialReportGenerator, so files share no state.
+ */
+FileResult processFile(const QString& input, const BatchOptions& options) {
+    FileResult result;
+    result.input = input;
+    QElapsedTimer timer;
+    timer.start();
+
+    try {
+        FinancialReportGenerator generator;
+        generator.setClassifier(options.classifier);
+        generator.setSidecarCacheEnabled(options.useCache);
+        result.loaded = generator.ensureLoaded(input);
+        if (!result.loaded) {
+            result.error = "no valid transactions";
+        }
+        else {
+            result.transactions = generator.transactionCount();
+            for (int index : options.reports) {
+                const ReportType& report = kReportTypes[index];
+                if ((generator.*report.generate)(reportPath(input, options, report))) {
+                    ++result.reportsWritten;
+                }
+                else {
+                    ++result.reportsFailed;
+                }
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        // e.g. a Money overflow from absurd totals; the other files still run
+        result.error = QString::fromLocal8Bit(e.what());
+        ++result.reportsFailed;
+    }
+
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Entry point of the batch report tool.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("NoomyPlanReports");
+    QCoreApplication::setApplicationVersion("0.1");
+    qInstallMessageHandler(messageHandler);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes NoomyPlan financial reports for CSV transaction files.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("inputs", "CSV files, or directories to search for *.csv files.", "<path>...");
+    const QCommandLineOption reportsOption({ "r", "reports" },
+        "Comma-separated reports to write: profit-loss, expenses, balance-sheet or all.", "list", "all");
+    const QCommandLineOption outputOption({ "o", "output-dir" },
+        "Directory for the reports; by default each goes next to its input.", "dir");
+    const QCommandLineOption jobsOption({ "j", "jobs" },
+        "Number of files processed at the same time.", "n", QString::number(QThread::idealThreadCount()));
+    const QCommandLineOption recursiveOption("recursive", "Also search subdirectories of input directories.");
+    const QCommandLineOption cacheOption("cache", "Reuse and write \"<file>.cache\" sidecar files.");
+    const QCommandLineOption mappingOption("mapping",
+        "JSON file mapping transaction types and categories to income, expense or other.", "file");
+    const QCommandLineOption verboseOption({ "v", "verbose" }, "Print the report generator's debug output.");
+    const QCommandLineOption traceOption("trace", "Write load, parse and report timings as a Chrome trace.", "file");
+    parser.addOptions({ reportsOption, outputOption, jobsOption, recursiveOption, cacheOption, mappingOption,
+        verboseOption, traceOption });
+    parser.process(app);
+
+    verboseOutput = parser.isSet(verboseOption);
+    QTextStream err(stderr);
+    QTextStream out(stdout);
+
+    BatchOptions options;
+    if (!parseReportList(parser.value(reportsOption), options.reports)) {
+        err << "Unknown report in \"" << parser.value(reportsOption) << "\"\n";
+        return 2;
+    }
+    bool jobsValid = false;
+    const int jobs = parser.value(jobsOption).toInt(&jobsValid);
+    if (!jobsValid || jobs < 1) {
+        err << "--jobs needs a positive number\n";
+        return 2;
+    }
+    if (parser.isSet(mappingOption) && !options.classifier.loadMapping(parser.value(mappingOption))) {
+        err << "Could not read the mapping file " << parser.value(mappingOption) << "\n";
+        return 2;
+    }
+    options.useCache = parser.isSet(cacheOption);
+    if (parser.isSet(outputOption)) {
+        options.outputDir = QDir(parser.value(outputOption)).absolutePath();
+        if (!QDir().mkpath(options.outputDir)) {
+            err << "Could not create the output directory " << options.outputDir << "\n";
+            return 2;
+        }
+    }
+
+    if (parser.positionalArguments().isEmpty()) {
+        parser.showHelp(2);
+    }
+    QStringList missing;
+    const QStringList inputs = collectInputs(parser.positionalArguments(), parser.isSet(recursiveOption), missing);
+    for (const QString& path : missing) {
+        err << "Not found: " << path << "\n";
+    }
+    if (inputs.isEmpty()) {
+        err << "No CSV files to process\n";
+        return missing.isEmpty() ? 0 : 1;
+    }
+    if (!options.outputDir.isEmpty()) {
+        options.reportNames = uniqueReportNames(inputs);
+    }
+    err.flush();
+
+    // Files run on a pool of their own; each load still spreads its chunks over the global pool
+    QThreadPool filePool;
+    filePool.setMaxThreadCount(jobs);
+    QElapsedTimer timer;
+    timer.start();
+    const QList<FileResult> results = QtConcurrent::blockingMapped<QList<FileResult>>(&filePool, inputs,
+        [&options](const QString& input) { return processFile(input, options); });
+
+    int failedFiles = 0;
+    qsizetype totalTransactions = 0;
+    for (const FileResult& result : results) {
+        const bool ok = result.loaded && result.reportsFailed == 0;
+        failedFiles += ok ? 0 : 1;
+        totalTransactions += result.transactions;
+        out << (ok ? "ok    " : "FAILED") << "  " << result.input << "  " << result.transactions
+            << " transactions, " << result.reportsWritten << " reports, " << result.elapsedMs << " ms";
+        if (!result.error.isEmpty()) {
+            out << "  (" << result.error << ")";
+        }
+        out << "\n";
+    }
+    out << results.size() << " files, " << totalTransactions << " transactions, " << failedFiles << " failed, "
+        << timer.elapsed() << " ms\n";
+    if (parser.isSet(traceOption) && !Tracing::writeChromeTrace(QFile::encodeName(parser.value(traceOption)).toStdString())) {
+        err << "Could not write the trace file " << parser.value(traceOption) << "\n";
+    }
+    return failedFiles == 0 && missing.isEmpty() ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#include "stringdictionary.h"
+
+/**
+ * @class stringdictionary.cpp
+ * @brief Implements the StringDictionary used to intern low-cardinality text columns.
+ */
+
+StringDictionary::StringDictionary() {
+    clear();
+}
+
+/**
+ * @brief Returns the symbol of a text, adding it if it is new.
+ * @param text Text to intern.
+ * @return The symbol that now stands for the text.
+ */
+StringDictionary::Symbol StringDictionary::intern(std::string_view text) {
+    auto existing = symbols.find(text);
+    if (existing != symbols.end()) {
+        return existing->second;
+    }
+
+    const Symbol symbol = static_cast<Symbol>(strings.size());
+    strings.emplace_back(text);
+    symbols.emplace(strings.back(), symbol); // Key views the copy owned by strings
+    return symbol;
+}
+
+/**
+ * @brief Looks a text up without adding it.
+ * @param text Text to look up.
+ * @return The text's symbol, or kNoSymbol if it was never interned.
+ */
+StringDictionary::Symbol StringDictionary::find(std::string_view text) const {
+    auto existing = symbols.find(text);
+    return existing != symbols.end() ? existing->second : kNoSymbol;
+}
+
+/**
+ * @brief Returns the text a symbol stands for.
+ * @param symbol Symbol returned by intern().
+ * @return The text, or the empty string for an unknown symbol.
+ */
+const std::string& StringDictionary::text(Symbol symbol) const {
+    return symbol < strings.size() ? strings[symbol] : strings[kEmptySymbol];
+}
+
+size_t StringDictionary::size() const {
+    return strings.size();
+}
+
+/**
+ * @brief Forgets every symbol except the empty string.
+ */
+void StringDictionary::clear() {
+    symbols.clear();
+    strings.clear();
+    strings.emplace_back();
+    symbols.emplace(strings.front(), kEmptySymbol);
+}
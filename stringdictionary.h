@@ -0,0 +1,70 @@
+#ifndef STRINGDICTIONARY_H
+#define STRINGDICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @class StringDictionary
+ * @brief Interns strings as dense 32-bit symbol IDs.
+ *
+ * Low-cardinality text columns such as sellers, buyers, currencies and categories
+ * store one Symbol per row instead of their own std::string; each distinct text is
+ * kept once here. Symbol 0 is always the empty string, so zero-initialized rows
+ * read back as empty. References returned by text() stay valid until clear().
+ */
+class StringDictionary {
+public:
+    using Symbol = uint32_t;
+
+    static constexpr Symbol kEmptySymbol = 0;           // Symbol of the empty string
+    static constexpr Symbol kNoSymbol = UINT32_MAX;     // Returned by find() for text that was never interned
+
+    /**
+     * @brief Creates a dictionary holding only the empty string.
+     */
+    StringDictionary();
+
+    /**
+     * @brief Returns the symbol of a text, adding it if it is new.
+     * @param text Text to intern.
+     * @return The symbol that now stands for the text.
+     */
+    Symbol intern(std::string_view text);
+
+    /**
+     * @brief Looks a text up without adding it.
+     * @param text Text to look up.
+     * @return The text's symbol, or kNoSymbol if it was never interned.
+     */
+    Symbol find(std::string_view text) const;
+
+    /**
+     * @brief Returns the text a symbol stands for.
+     * @param symbol Symbol returned by intern().
+     * @return The text, or the empty string for an unknown symbol.
+     */
+    const std::string& text(Symbol symbol) const;
+
+    /**
+     * @brief Returns the number of symbols, including the empty string.
+     *
+     * Symbols are dense, so every value below size() is valid.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Forgets every symbol except the empty string.
+     */
+    void clear();
+
+private:
+    std::deque<std::string> strings;                        // Text of each symbol, indexed by Symbol; a deque keeps references stable
+    std::unordered_map<std::string_view, Symbol> symbols;   // Maps text (viewing into strings) to its symbol
+};
+
+#endif // STRINGDICTIONARY_H
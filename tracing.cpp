@@ -0,0 +1,352 @@
+#include "tracing.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+/**
+ * @class tracing.cpp
+ * @brief Implements the Tracing per-thread span rings, counters, statistics and Chrome trace export.
+ */
+
+namespace {
+
+/**
+ * @brief One span in a thread's ring, guarded by a sequence number like a seqlock.
+ *
+ * The owning thread makes the sequence odd, writes the fields and then stores the
+ * span's even sequence. A reader that sees the same even sequence before and after
+ * copying the fields has an untorn copy. All fields are atomics so the race with
+ * the reader is well defined; relaxed accesses compile to plain moves.
+ */
+struct EventSlot {
+    std::atomic<uint64_t> sequence{ 0 };
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<int64_t> startNs{ 0 };
+    std::atomic<int64_t> durationNs{ 0 };
+    std::atomic<uint32_t> threadID{ 0 };
+};
+
+/**
+ * @brief One counter of a thread; the name is set once by the owner.
+ */
+struct CounterSlot {
+    std::atomic<const char*> name{ nullptr };
+    std::atomic<int64_t> value{ 0 };
+};
+
+/**
+ * @brief Everything one thread records. Only that thread writes spans and names.
+ */
+struct ThreadBuffer {
+    std::atomic<uint64_t> written{ 0 };   // Spans written so far; slot index is written % kEventsPerThread
+    std::atomic<uint64_t> resetMark{ 0 }; // Spans before this one were dropped by reset()
+    std::atomic<bool> inUse{ true };      // False once the thread has exited and the buffer can be reused
+    uint32_t threadID = 0;                // Owner's number, only touched by the owner
+    EventSlot events[Tracing::kEventsPerThread];
+    CounterSlot counters[Tracing::kCountersPerThread];
+};
+
+/**
+ * @brief All buffers ever handed out. Buffers are never freed, only reused after their thread exits.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    uint32_t nextThreadID = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief Hands the calling thread its buffer and returns it to the registry when the thread exits.
+ */
+class ThreadHandle {
+public:
+    ~ThreadHandle() {
+        if (buffer) {
+            buffer->inUse.store(false, std::memory_order_release);
+        }
+    }
+
+    ThreadBuffer* get() {
+        if (!buffer) {
+            buffer = acquire();
+        }
+        return buffer;
+    }
+
+private:
+    static ThreadBuffer* acquire() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        ThreadBuffer* result = nullptr;
+        for (const auto& candidate : shared.buffers) {
+            if (!candidate->inUse.load(std::memory_order_acquire)) {
+                result = candidate.get();
+                result->inUse.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (!result) {
+            shared.buffers.push_back(std::make_unique<ThreadBuffer>());
+            result = shared.buffers.back().get();
+        }
+        // Spans of the previous owner keep their own thread number
+        result->threadID = shared.nextThreadID++;
+        return result;
+    }
+
+    ThreadBuffer* buffer = nullptr;
+};
+
+[[maybe_unused]] ThreadBuffer* threadBuffer() {
+    thread_local ThreadHandle handle;
+    return handle.get();
+}
+
+/**
+ * @brief Calls visit for every span still in a buffer, skipping any being overwritten.
+ */
+template <typename Visit>
+void forEachEvent(const ThreadBuffer& buffer, Visit visit) {
+    const uint64_t written = buffer.written.load(std::memory_order_acquire);
+    const uint64_t oldestKept = written > Tracing::kEventsPerThread ? written - Tracing::kEventsPerThread : 0;
+    for (uint64_t index = std::max(oldestKept, buffer.resetMark.load(std::memory_order_relaxed)); index < written; ++index) {
+        const EventSlot& slot = buffer.events[index % Tracing::kEventsPerThread];
+        const uint64_t expected = 2 * index + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            continue; // Already overwritten by a newer span
+        }
+        Tracing::Event event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.startNs = slot.startNs.load(std::memory_order_relaxed);
+        event.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        event.threadID = slot.threadID.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+            visit(event);
+        }
+    }
+}
+
+/**
+ * @brief Returns the value at a percentile of sorted durations, by the nearest-rank method.
+ */
+int64_t percentile(const std::vector<int64_t>& sorted, int percent) {
+    const size_t rank = (sorted.size() * static_cast<size_t>(percent) + 99) / 100;
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+/**
+ * @brief Writes text as the contents of a JSON string.
+ */
+void writeJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out << escaped;
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * @brief Writes nanoseconds as the microseconds Chrome traces use.
+ */
+void writeMicroseconds(std::ostream& out, int64_t nanoseconds) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+    out << text;
+}
+
+} // namespace
+
+namespace Tracing {
+
+int64_t now() {
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void record(const char* name, int64_t startNs, int64_t durationNs) {
+#if NOOMYPLAN_TRACING
+    ThreadBuffer* buffer = threadBuffer();
+    const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    EventSlot& slot = buffer->events[index % kEventsPerThread];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    slot.threadID.store(buffer->threadID, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+#else
+    static_cast<void>(name);
+    static_cast<void>(startNs);
+    static_cast<void>(durationNs);
+#endif
+}
+
+void count(const char* name, int64_t delta) {
+#if NOOMYPLAN_TRACING
+    ThreadBuffer* buffer = threadBuffer();
+    for (CounterSlot& slot : buffer->counters) {
+        const char* slotName = slot.name.load(std::memory_order_relaxed);
+        if (!slotName) {
+            slot.name.store(name, std::memory_order_release); // Only the owner claims slots
+            slotName = name;
+        }
+        if (slotName == name) {
+            // Atomic add, because reset() zeroes counters from another thread
+            slot.value.fetch_add(delta, std::memory_order_relaxed);
+            return;
+        }
+    }
+#else
+    static_cast<void>(name);
+    static_cast<void>(delta);
+#endif
+}
+
+std::vector<Event> events() {
+    std::vector<Event> result;
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (const auto& buffer : shared.buffers) {
+        forEachEvent(*buffer, [&result](const Event& event) { result.push_back(event); });
+    }
+    return result;
+}
+
+std::vector<Counter> counters() {
+    // The same literal may have different addresses in different translation units, so merge by text
+    std::map<std::string, int64_t> totals;
+    Registry& shared = registry();
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (const auto& buffer : shared.buffers) {
+            for (const CounterSlot& slot : buffer->counters) {
+                const char* name = slot.name.load(std::memory_order_acquire);
+                if (name) {
+                    totals[name] += slot.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    std::vector<Counter> result;
+    result.reserve(totals.size());
+    for (const auto& total : totals) {
+        result.push_back({ total.first, total.second });
+    }
+    return result;
+}
+
+std::vector<OperationStats> statistics() {
+    std::map<std::string, std::vector<int64_t>> durations;
+    for (const Event& event : events()) {
+        durations[event.name].push_back(event.durationNs);
+    }
+
+    std::vector<OperationStats> result;
+    result.reserve(durations.size());
+    for (auto& operation : durations) {
+        std::vector<int64_t>& sorted = operation.second;
+        std::sort(sorted.begin(), sorted.end());
+        OperationStats stats;
+        stats.name = operation.first;
+        stats.count = sorted.size();
+        stats.p50Ns = percentile(sorted, 50);
+        stats.p99Ns = percentile(sorted, 99);
+        stats.maxNs = sorted.back();
+        for (int64_t duration : sorted) {
+            stats.totalNs += duration;
+        }
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void reset() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (const auto& buffer : shared.buffers) {
+        buffer->resetMark.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+        for (CounterSlot& slot : buffer->counters) {
+            slot.value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Writes the spans as complete ("X") events, one track per thread, and the counters' current totals.
+ */
+bool writeChromeTrace(const std::string& path) {
+    const std::vector<Event> spans = events();
+    const std::vector<Counter> totals = counters();
+    const int64_t endNs = now();
+
+    const std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open trace file for writing: " << tempPath << std::endl;
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const Event& span : spans) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(out, span.name);
+        out << ",\"cat\":\"noomyplan\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.threadID << ",\"ts\":";
+        writeMicroseconds(out, span.startNs);
+        out << ",\"dur\":";
+        writeMicroseconds(out, span.durationNs);
+        out << "}";
+        first = false;
+    }
+    for (const Counter& counter : totals) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(out, counter.name);
+        out << ",\"cat\":\"noomyplan\",\"ph\":\"C\",\"pid\":1,\"ts\":";
+        writeMicroseconds(out, endNs);
+        out << ",\"args\":{\"value\":" << counter.value << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+    out.close();
+    if (!out) {
+        std::cerr << "Error: Could not write trace file: " << tempPath << std::endl;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Error: Could not replace " << path << ": " << error.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace Tracing
@@ -0,0 +1,145 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef NOOMYPLAN_TRACING
+#define NOOMYPLAN_TRACING 1
+#endif
+
+/**
+ * @namespace Tracing
+ * @brief Scoped timers and counters for the load, save, parse, aggregate and refresh paths.
+ *
+ * NOOMYPLAN_TRACE_SCOPE("ledger.save") times the rest of the enclosing block and
+ * NOOMYPLAN_TRACE_COUNT("ledger.journalRecords", 1) adds to a counter. Every thread
+ * records into a buffer of its own without locks: timings go to a ring that keeps the
+ * latest kEventsPerThread spans, counters to a small fixed table. Readers copy the
+ * buffers while threads keep recording, so a snapshot may miss a span that is being
+ * written at that moment but never sees a torn one.
+ *
+ * Building with NOOMYPLAN_TRACING=0 turns both macros into nothing, so the traced
+ * code compiles exactly as if it had no instrumentation. The functions below still
+ * exist and report no data.
+ *
+ * Names must be string literals (or otherwise outlive the program's use of the data),
+ * since only the pointer is stored. Use "area.operation", e.g. "report.parseChunk".
+ */
+namespace Tracing {
+
+constexpr size_t kEventsPerThread = 8192; // Spans kept per thread; older ones are overwritten
+constexpr size_t kCountersPerThread = 64; // Distinct counter names per thread; further names are dropped
+
+/**
+ * @brief One timed span.
+ */
+struct Event {
+    const char* name = nullptr;
+    int64_t startNs = 0;    // Since the process started tracing
+    int64_t durationNs = 0;
+    uint32_t threadID = 0;  // Small number assigned per thread, in order of first use
+};
+
+/**
+ * @brief A counter's total over all threads.
+ */
+struct Counter {
+    std::string name;
+    int64_t value = 0;
+};
+
+/**
+ * @brief Latency percentiles of one operation, over the spans still in the buffers.
+ */
+struct OperationStats {
+    std::string name;
+    size_t count = 0;
+    int64_t p50Ns = 0;
+    int64_t p99Ns = 0;
+    int64_t maxNs = 0;
+    int64_t totalNs = 0;
+};
+
+/**
+ * @brief Returns whether tracing was compiled in.
+ */
+constexpr bool enabled() { return NOOMYPLAN_TRACING != 0; }
+
+/**
+ * @brief Returns nanoseconds since tracing started, on the clock spans are measured with.
+ */
+int64_t now();
+
+/**
+ * @brief Records a finished span on the calling thread.
+ */
+void record(const char* name, int64_t startNs, int64_t durationNs);
+
+/**
+ * @brief Adds to a counter of the calling thread.
+ */
+void count(const char* name, int64_t delta);
+
+/**
+ * @brief Copies the spans of every thread, oldest first per thread.
+ */
+std::vector<Event> events();
+
+/**
+ * @brief Returns every counter summed over threads, sorted by name.
+ */
+std::vector<Counter> counters();
+
+/**
+ * @brief Returns p50/p99/max per operation name, sorted by name.
+ */
+std::vector<OperationStats> statistics();
+
+/**
+ * @brief Forgets all spans and counters recorded so far.
+ *
+ * Spans finished by other threads while this runs may survive the reset.
+ */
+void reset();
+
+/**
+ * @brief Writes the spans and counters as a Chrome trace (chrome://tracing, Perfetto).
+ * @param path File to write.
+ * @return False if the file could not be written.
+ */
+bool writeChromeTrace(const std::string& path);
+
+/**
+ * @brief Times its own lifetime and records it as one span.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) : name(name), startNs(now()) {}
+    ~ScopedTimer() { record(name, startNs, now() - startNs); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* name;
+    int64_t startNs;
+};
+
+} // namespace Tracing
+
+#define NOOMYPLAN_TRACE_CONCAT_INNER(a, b) a##b
+#define NOOMYPLAN_TRACE_CONCAT(a, b) NOOMYPLAN_TRACE_CONCAT_INNER(a, b)
+
+#if NOOMYPLAN_TRACING
+#define NOOMYPLAN_TRACE_SCOPE(name) \
+    const Tracing::ScopedTimer NOOMYPLAN_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define NOOMYPLAN_TRACE_COUNT(name, delta) Tracing::count(name, delta)
+#else
+#define NOOMYPLAN_TRACE_SCOPE(name) static_cast<void>(0)
+#define NOOMYPLAN_TRACE_COUNT(name, delta) static_cast<void>(0)
+#endif
+
+#endif // TRACING_H
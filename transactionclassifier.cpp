@@ -0,0 +1,208 @@
+#include "transactionclassifier.h"
+#include "logging.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <algorithm>
+
+/**
+ * @class transactionclassifier.cpp
+ * @brief Implements the TransactionClassifier that sorts report transactions into income and expenses.
+ */
+
+namespace {
+
+// Part of signature(); bump it whenever guessKind() changes, so sidecars classified by older rules are not reused
+constexpr char kGuessRulesVersion[] = "guess-rules-2";
+
+/**
+ * @brief Normalizes a type or category for table lookups.
+ */
+QString lookupKey(const QString& text) {
+    return text.trimmed().toCaseFolded();
+}
+
+/**
+ * @brief Returns the kind mapped to a text in one of the tables, if any.
+ */
+std::optional<TransactionKind> lookup(const QHash<QString, TransactionKind>& table, const QString& text) {
+    auto it = table.constFind(lookupKey(text));
+    if (it == table.constEnd()) {
+        return std::nullopt;
+    }
+    return *it;
+}
+
+/**
+ * @brief Returns true if a keyword starts a word of folded text, so "sale" matches "Sales" but not "Wholesale".
+ */
+bool startsWord(const QString& folded, QLatin1String keyword) {
+    for (qsizetype at = folded.indexOf(keyword); at >= 0; at = folded.indexOf(keyword, at + 1)) {
+        if (at == 0 || !folded.at(at - 1).isLetterOrNumber()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds a table's entries to a hash in key order, so equal tables hash alike.
+ */
+void addToHash(QCryptographicHash& hash, const QHash<QString, TransactionKind>& table) {
+    QList<QString> keys = table.keys();
+    std::sort(keys.begin(), keys.end());
+    for (const QString& key : keys) {
+        hash.addData(key.toUtf8());
+        const char kind = static_cast<char>(table.value(key));
+        hash.addData(QByteArrayView(&kind, 1));
+    }
+    hash.addData(QByteArrayView("\0", 1)); // Separates the type table from the category table
+}
+
+} // namespace
+
+/**
+ * @brief Creates a classifier with the default table for common bank export types.
+ */
+TransactionClassifier::TransactionClassifier() {
+    for (const char* type : { "Income", "Sale", "Sales", "Misc. Income", "Interest Income", "Revenue" }) {
+        setTypeKind(QString::fromLatin1(type), TransactionKind::Income);
+    }
+    for (const char* type : { "Expense", "Bank Fee", "Inventory Purchase", "Loan Payment", "Tax Payment",
+                              "Refund", "Payroll", "Rent", "Utilities" }) {
+        setTypeKind(QString::fromLatin1(type), TransactionKind::Expense);
+    }
+    setTypeKind(QStringLiteral("Transfer"), TransactionKind::Other);
+}
+
+void TransactionClassifier::setTypeKind(const QString& type, TransactionKind kind) {
+    typeKinds.insert(lookupKey(type), kind);
+}
+
+void TransactionClassifier::setCategoryKind(const QString& category, TransactionKind kind) {
+    categoryKinds.insert(lookupKey(category), kind);
+}
+
+void TransactionClassifier::clear() {
+    typeKinds.clear();
+    categoryKinds.clear();
+}
+
+/**
+ * @brief Adds the mappings from a JSON file.
+ * @param filePath Path of the JSON file.
+ * @return True if the file was read; entries with an unknown kind are skipped.
+ */
+bool TransactionClassifier::loadMapping(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject()) {
+        NOOMYPLAN_LOG_WARNING(lcReport) << "Error: Transaction type mapping is not a JSON object:" << filePath;
+        return false;
+    }
+
+    const QJsonObject root = document.object();
+    auto addEntries = [](const QJsonObject& entries, QHash<QString, TransactionKind>& table) {
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            const std::optional<TransactionKind> kind = kindFromName(it.value().toString());
+            if (!kind) {
+                NOOMYPLAN_LOG_WARNING(lcReport) << "Skipping unknown transaction kind" << it.value().toString() << "for" << it.key();
+                continue;
+            }
+            table.insert(lookupKey(it.key()), *kind);
+        }
+    };
+    addEntries(root.value("types").toObject(), typeKinds);
+    addEntries(root.value("categories").toObject(), categoryKinds);
+    return true;
+}
+
+std::optional<TransactionKind> TransactionClassifier::mappedTypeKind(const QString& type) const {
+    return lookup(typeKinds, type);
+}
+
+std::optional<TransactionKind> TransactionClassifier::mappedCategoryKind(const QString& category) const {
+    return lookup(categoryKinds, category);
+}
+
+/**
+ * @brief Guesses a kind from keywords in a type or category.
+ *
+ * Keywords match at the start of a word. Words that make anything an outflow, such as
+ * "Sales Tax" or "Income Tax Payment", are checked before the income words; weaker
+ * expense words only count if no income word matched, so "Rental Income" stays income.
+ *
+ * @param text Type or category to look at.
+ * @return Income or Expense if a keyword matched, otherwise Other.
+ */
+TransactionKind TransactionClassifier::guessKind(const QString& text) {
+    static const char* const strongExpenseWords[] = { "expense", "payment", "repayment", "purchase", "tax",
+                                                      "cost", "payroll" };
+    static const char* const incomeWords[] = { "income", "revenue", "sale", "earning", "interest received" };
+    static const char* const weakExpenseWords[] = { "fee", "refund", "rent" };
+
+    const QString folded = text.toCaseFolded();
+    for (const char* word : strongExpenseWords) {
+        if (startsWord(folded, QLatin1String(word))) {
+            return TransactionKind::Expense;
+        }
+    }
+    for (const char* word : incomeWords) {
+        if (startsWord(folded, QLatin1String(word))) {
+            return TransactionKind::Income;
+        }
+    }
+    for (const char* word : weakExpenseWords) {
+        if (startsWord(folded, QLatin1String(word))) {
+            return TransactionKind::Expense;
+        }
+    }
+    return TransactionKind::Other;
+}
+
+/**
+ * @brief Classifies a transaction by its type and category.
+ * @param type The transaction's type, e.g. "Loan Payment".
+ * @param category The transaction's category, e.g. "Debt Repayment".
+ * @return The kind from the first of: type table, category table, type guess, category guess.
+ */
+TransactionKind TransactionClassifier::classify(const QString& type, const QString& category) const {
+    if (const auto kind = mappedTypeKind(type)) {
+        return *kind;
+    }
+    if (const auto kind = mappedCategoryKind(category)) {
+        return *kind;
+    }
+    const TransactionKind guess = guessKind(type);
+    return guess != TransactionKind::Other ? guess : guessKind(category);
+}
+
+QByteArray TransactionClassifier::signature() const {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(QByteArrayView(kGuessRulesVersion));
+    addToHash(hash, typeKinds);
+    addToHash(hash, categoryKinds);
+    return hash.result();
+}
+
+QString TransactionClassifier::kindName(TransactionKind kind) {
+    switch (kind) {
+    case TransactionKind::Income: return QStringLiteral("income");
+    case TransactionKind::Expense: return QStringLiteral("expense");
+    default: return QStringLiteral("other");
+    }
+}
+
+std::optional<TransactionKind> TransactionClassifier::kindFromName(const QString& name) {
+    const QString folded = name.trimmed().toCaseFolded();
+    if (folded == QLatin1String("income")) return TransactionKind::Income;
+    if (folded == QLatin1String("expense")) return TransactionKind::Expense;
+    if (folded == QLatin1String("other")) return TransactionKind::Other;
+    return std::nullopt;
+}
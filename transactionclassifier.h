@@ -0,0 +1,108 @@
+#ifndef TRANSACTIONCLASSIFIER_H
+#define TRANSACTIONCLASSIFIER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <optional>
+
+/**
+ * @brief What a transaction does to the books, as far as the reports are concerned.
+ */
+enum class TransactionKind : quint8 {
+    Other = 0,   // Neither income nor expense, e.g. a transfer between own accounts
+    Income = 1,  // Money earned, e.g. "Sale" or "Misc. Income"
+    Expense = 2  // Money spent, e.g. "Loan Payment" or "Bank Fee"
+};
+
+/**
+ * @class TransactionClassifier
+ * @brief Maps the free-text type and category of a transaction to a TransactionKind.
+ *
+ * Bank exports use many spellings for income and expenses ("Sale", "Misc. Income",
+ * "Inventory Purchase", "Tax Payment", ...). The classifier decides once per distinct
+ * spelling, when transactions are loaded, so reports only compare small integers.
+ * A transaction's type is looked up first, then its category, both in a configurable
+ * mapping table; spellings in neither table are guessed from keywords such as
+ * "income", "sale", "fee" or "payment". Table lookups ignore case.
+ */
+class TransactionClassifier {
+public:
+    /**
+     * @brief Creates a classifier with the default table for common bank export types.
+     */
+    TransactionClassifier();
+
+    /**
+     * @brief Maps a transaction type to a kind, replacing any earlier mapping.
+     */
+    void setTypeKind(const QString& type, TransactionKind kind);
+
+    /**
+     * @brief Maps a transaction category to a kind, replacing any earlier mapping.
+     */
+    void setCategoryKind(const QString& category, TransactionKind kind);
+
+    /**
+     * @brief Removes every mapping, leaving only the keyword guesses.
+     */
+    void clear();
+
+    /**
+     * @brief Adds the mappings from a JSON file.
+     *
+     * The file holds an object with optional "types" and "categories" objects that map
+     * spellings to "income", "expense" or "other", e.g.
+     * {"types": {"Consulting Fee Received": "income"}}.
+     *
+     * @param filePath Path of the JSON file.
+     * @return True if the file was read; false if it is missing or malformed.
+     */
+    bool loadMapping(const QString& filePath);
+
+    /**
+     * @brief Returns the kind a type is mapped to, if it is in the table.
+     */
+    std::optional<TransactionKind> mappedTypeKind(const QString& type) const;
+
+    /**
+     * @brief Returns the kind a category is mapped to, if it is in the table.
+     */
+    std::optional<TransactionKind> mappedCategoryKind(const QString& category) const;
+
+    /**
+     * @brief Guesses a kind from keywords in a type or category.
+     * @return Income or Expense if a keyword matched, otherwise Other.
+     */
+    static TransactionKind guessKind(const QString& text);
+
+    /**
+     * @brief Classifies a transaction by its type and category.
+     *
+     * Tries the type table, the category table, a guess from the type and a guess from
+     * the category, in that order.
+     */
+    TransactionKind classify(const QString& type, const QString& category) const;
+
+    /**
+     * @brief Returns a hash of the mapping table and the keyword rules; equal signatures classify alike.
+     */
+    QByteArray signature() const;
+
+    /**
+     * @brief Returns "income", "expense" or "other".
+     */
+    static QString kindName(TransactionKind kind);
+
+    /**
+     * @brief Parses "income", "expense" or "other", ignoring case.
+     * @return The kind, or nothing for any other text.
+     */
+    static std::optional<TransactionKind> kindFromName(const QString& name);
+
+private:
+    QHash<QString, TransactionKind> typeKinds;      // Case-folded type -> kind
+    QHash<QString, TransactionKind> categoryKinds;  // Case-folded category -> kind
+};
+
+#endif // TRANSACTIONCLASSIFIER_H